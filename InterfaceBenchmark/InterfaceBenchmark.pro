@@ -0,0 +1,47 @@
+#----------------- HELP --------------
+# InterfaceBenchmark times the math types of robodk_interface (Matrix4x4, Vector3, Joints and Matrix2D)
+# and counts their heap allocations: see README.md
+#
+# Build in release mode, for example:
+# qmake CONFIG+=release InterfaceBenchmark.pro && make
+#------------------------------------
+
+
+#----------------- TEMPLATE --------- (Qt console application)
+TEMPLATE        = app
+CONFIG         += console c++17
+CONFIG         -= app_bundle
+#------------------------------------
+
+# robodk_interface requires Qt GUI (Matrix4x4 is based on QMatrix4x4)
+QT += gui
+
+TARGET          = InterfaceBenchmark
+
+*-clang* {
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-deprecated-declarations
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-deprecated-copy-with-user-provided-copy
+}
+
+*-g++* {
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-comment
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-deprecated-copy
+}
+
+HEADERS += \
+    allocationcounter.h \
+    ../PluginExample/pluginbenchmark.h
+
+SOURCES += \
+    main.cpp \
+    allocationcounter.cpp \
+    ../PluginExample/pluginbenchmark.cpp
+
+DISTFILES += \
+    README.md
+
+
+#--------------------------
+# Header and source files required by any RoboDK plugin
+# Do not change this section, make sure to have the robodk_interface folder up one folder
+include($$PWD/../robodk_interface/robodk_interface.pri)
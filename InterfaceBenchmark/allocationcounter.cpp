@@ -0,0 +1,206 @@
+#include "allocationcounter.h"
+
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <new>
+
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+
+static std::atomic<std::uint64_t> allocations(0);
+
+static inline void count_allocation() {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+#if defined(__GLIBC__)
+
+// glibc exports its allocator under these names: the executable's malloc replaces the one used by all libraries
+extern "C" void *__libc_malloc(size_t size);
+extern "C" void *__libc_calloc(size_t count, size_t size);
+extern "C" void *__libc_realloc(void *ptr, size_t size);
+extern "C" void __libc_free(void *ptr);
+extern "C" void *__libc_memalign(size_t alignment, size_t size);
+extern "C" void *__libc_valloc(size_t size);
+
+extern "C" void *malloc(size_t size) {
+    count_allocation();
+    return __libc_malloc(size);
+}
+
+extern "C" void *calloc(size_t count, size_t size) {
+    count_allocation();
+    return __libc_calloc(count, size);
+}
+
+extern "C" void *realloc(void *ptr, size_t size) {
+    count_allocation();
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" void free(void *ptr) {
+    __libc_free(ptr);
+}
+
+// Aligned allocations (aligned operator new of libstdc++ uses aligned_alloc)
+extern "C" void *memalign(size_t alignment, size_t size) {
+    count_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" void *aligned_alloc(size_t alignment, size_t size) {
+    count_allocation();
+    return __libc_memalign(alignment, size);
+}
+
+extern "C" int posix_memalign(void **ptr, size_t alignment, size_t size) {
+    if (alignment < sizeof(void*) || (alignment & (alignment - 1)) != 0) {
+        return EINVAL;
+    }
+    count_allocation();
+    void *mem = __libc_memalign(alignment, size);
+    if (mem == nullptr) {
+        return ENOMEM;
+    }
+    *ptr = mem;
+    return 0;
+}
+
+extern "C" void *valloc(size_t size) {
+    count_allocation();
+    return __libc_valloc(size);
+}
+
+bool AllocationCounter::CountsMalloc() {
+    return true;
+}
+
+#else
+
+// Aligned memory must be released with the matching function on Windows
+static void *aligned_malloc(std::size_t size, std::size_t alignment) {
+#if defined(_WIN32)
+    return _aligned_malloc(size, alignment);
+#else
+    void *ptr = nullptr;
+    if (alignment < sizeof(void*)) {
+        alignment = sizeof(void*);
+    }
+    return posix_memalign(&ptr, alignment, size) == 0 ? ptr : nullptr;
+#endif
+}
+
+static void aligned_free(void *ptr) {
+#if defined(_WIN32)
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+// operator new is replaceable on every platform (the default implementations call malloc)
+void *operator new(std::size_t size) {
+    count_allocation();
+    void *ptr = std::malloc(size > 0 ? size : 1);
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    count_allocation();
+    return std::malloc(size > 0 ? size : 1);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept {
+    return operator new(size, tag);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+    count_allocation();
+    void *ptr = aligned_malloc(size > 0 ? size : 1, static_cast<std::size_t>(alignment));
+    if (ptr == nullptr) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+    return operator new(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t &) noexcept {
+    count_allocation();
+    return aligned_malloc(size > 0 ? size : 1, static_cast<std::size_t>(alignment));
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t &tag) noexcept {
+    return operator new(size, alignment, tag);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+    aligned_free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+    aligned_free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+    aligned_free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+    aligned_free(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+    aligned_free(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t, const std::nothrow_t &) noexcept {
+    aligned_free(ptr);
+}
+
+bool AllocationCounter::CountsMalloc() {
+    return false;
+}
+
+#endif
+
+std::uint64_t AllocationCounter::Count() {
+    return allocations.load(std::memory_order_relaxed);
+}
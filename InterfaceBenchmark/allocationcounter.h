@@ -0,0 +1,23 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <cstdint>
+
+
+///
+/// \brief The AllocationCounter class counts the heap allocations of the process.
+/// With glibc (Linux) malloc, calloc, realloc and the aligned allocation functions (memalign, posix_memalign,
+/// aligned_alloc and valloc) are replaced so that the allocations of Qt containers are counted too.
+/// On other platforms only operator new is replaced (all the standard forms, including nothrow and aligned): allocations
+/// made directly with malloc or the aligned allocation functions (for example, QString or QVector data) are not counted.
+///
+class AllocationCounter {
+public:
+    /// Number of allocations since the process started (all threads)
+    static std::uint64_t Count();
+
+    /// Returns true if malloc is replaced (allocations of Qt containers are counted)
+    static bool CountsMalloc();
+};
+
+#endif // ALLOCATIONCOUNTER_H
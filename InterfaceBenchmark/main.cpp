@@ -0,0 +1,280 @@
+// InterfaceBenchmark times the math types of robodk_interface (Matrix4x4, Vector3, Joints and the legacy Matrix2D)
+// and counts their heap allocations.
+// Usage: InterfaceBenchmark [--filter text] [--samples N] [--json report.json] [--baseline report.json] [--threshold 0.1]
+
+#include "allocationcounter.h"
+#include "robodktypes.h"
+#include "../PluginExample/pluginbenchmark.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QDateTime>
+#include <QSysInfo>
+#include <QTextStream>
+
+#include <functional>
+
+
+// Results are accumulated here so that the compiler can not remove the benchmarked code
+static volatile double sink = 0.0;
+
+static QTextStream &out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+
+///
+/// \brief The InterfaceBenchmark class runs each operation in batches and records the time and the allocations per call.
+///
+class InterfaceBenchmark {
+public:
+    InterfaceBenchmark(const QString &filter, int samples) : filter(filter), samples(samples) {
+    }
+
+    ///
+    /// \brief Benchmark an operation (skipped if its name does not contain the filter)
+    /// \param name name of the operation
+    /// \param batch number of calls per sample (fast operations need large batches to hide the timer overhead)
+    /// \param operation operation to benchmark
+    ///
+    void Run(const QString &name, int batch, const std::function<void()> &operation);
+
+    const BenchmarkSuite &Suite() const { return suite; }
+
+private:
+    QString filter;
+    int samples;
+    BenchmarkSuite suite;
+};
+
+void InterfaceBenchmark::Run(const QString &name, int batch, const std::function<void()> &operation) {
+    if (!filter.isEmpty() && !name.contains(filter, Qt::CaseInsensitive)) {
+        return;
+    }
+
+    // Warm up caches and lazy initializations (for example, the locale used by QString::number)
+    for (int i = 0; i < qMax(1, samples / 10) * batch; i++) {
+        operation();
+    }
+
+    // Allocate the samples before counting the allocations
+    QVector<qint64> samples_ns(samples);
+    QElapsedTimer timer;
+    const std::uint64_t allocations_start = AllocationCounter::Count();
+    for (int i = 0; i < samples; i++) {
+        timer.start();
+        for (int j = 0; j < batch; j++) {
+            operation();
+        }
+        samples_ns[i] = timer.nsecsElapsed();
+    }
+    const std::uint64_t allocations = AllocationCounter::Count() - allocations_start;
+
+    const BenchmarkResult &result = suite.Add(name, samples_ns, batch, double(allocations) / (double(samples) * batch));
+    out() << QString("%1 | %2 | %3 | %4 | %5 | %6\n").arg(result.name, -36)
+             .arg(result.p50_us * 1000.0, 10, 'f', 1).arg(result.mean_us * 1000.0, 10, 'f', 1)
+             .arg(result.p95_us * 1000.0, 10, 'f', 1).arg(100.0 * result.cv, 6, 'f', 1).arg(result.allocations, 9, 'f', 2);
+    out().flush();
+}
+
+
+static void run_matrix4x4(InterfaceBenchmark &benchmark) {
+    const Mat pose1 = Mat::XYZRPW_2_Mat(100.0, 200.0, 300.0, 10.0, 20.0, 30.0);
+    const Mat pose2 = Mat::XYZRPW_2_Mat(-50.0, 25.0, 400.0, -45.0, 5.0, 90.0);
+    const QString pose_string = "100, 200, 300, 10, 20, 30";
+
+    benchmark.Run("Mat compose (a * b)", 1000, [&]() {
+        Mat pose = pose1 * pose2;
+        sink = sink + pose.Get(0, 3);
+    });
+    benchmark.Run("Mat inverse", 1000, [&]() {
+        Mat pose = pose1.Inverted();
+        sink = sink + pose.Get(0, 3);
+    });
+    benchmark.Run("Mat copy", 1000, [&]() {
+        Mat pose(pose1);
+        sink = sink + pose.Get(0, 3);
+    });
+    benchmark.Run("Mat ValuesD", 1000, [&]() {
+        sink = sink + pose1.ValuesD()[12];
+    });
+    benchmark.Run("Mat ToXYZRPW", 1000, [&]() {
+        double xyzrpw[6];
+        pose1.ToXYZRPW(xyzrpw);
+        sink = sink + xyzrpw[3];
+    });
+    benchmark.Run("Mat XYZRPW_2_Mat", 1000, [&]() {
+        Mat pose = Mat::XYZRPW_2_Mat(100.0, 200.0, 300.0, 10.0, 20.0, 30.0);
+        sink = sink + pose.Get(0, 0);
+    });
+    benchmark.Run("Mat ToString", 100, [&]() {
+        QString text = pose1.ToString();
+        sink = sink + text.size();
+    });
+    benchmark.Run("Mat ToString (XYZRPW)", 100, [&]() {
+        QString text = pose1.ToString(", ", 3, true);
+        sink = sink + text.size();
+    });
+    benchmark.Run("Mat FromString", 100, [&]() {
+        Mat pose;
+        pose.FromString(pose_string);
+        sink = sink + pose.Get(0, 3);
+    });
+}
+
+static void run_vector3(InterfaceBenchmark &benchmark) {
+    const robodk::Vector3 v1(1.0, 2.0, 3.0);
+    const robodk::Vector3 v2(-3.0, 0.5, 2.0);
+
+    benchmark.Run("Vector3 cross product", 1000, [&]() {
+        robodk::Vector3 v = robodk::Vector3::CrossProduct(v1, v2);
+        sink = sink + v[0];
+    });
+    benchmark.Run("Vector3 dot product", 1000, [&]() {
+        sink = sink + robodk::Vector3::DotProduct(v1, v2);
+    });
+    benchmark.Run("Vector3 normalize", 1000, [&]() {
+        robodk::Vector3 v(v1);
+        v.Normalize();
+        sink = sink + v[0];
+    });
+}
+
+static void run_joints(InterfaceBenchmark &benchmark) {
+    const double values[6] = {10.0, -20.0, 30.0, -40.0, 50.0, -60.0};
+    const tJoints joints(values, 6);
+    const QString joints_string = "10, -20, 30, -40, 50, -60";
+
+    benchmark.Run("Joints from array", 1000, [&]() {
+        tJoints jnts(values, 6);
+        sink = sink + jnts.ValuesD()[0];
+    });
+    benchmark.Run("Joints copy", 1000, [&]() {
+        tJoints jnts(joints);
+        sink = sink + jnts.ValuesD()[0];
+    });
+    benchmark.Run("Joints assign", 1000, [&]() {
+        tJoints jnts;
+        jnts = joints;
+        sink = sink + jnts.ValuesD()[0];
+    });
+    benchmark.Run("Joints ToString", 100, [&]() {
+        QString text = joints.ToString();
+        sink = sink + text.size();
+    });
+    benchmark.Run("Joints FromString", 100, [&]() {
+        tJoints jnts;
+        jnts.FromString(joints_string);
+        sink = sink + jnts.ValuesD()[0];
+    });
+}
+
+static void run_matrix2d(InterfaceBenchmark &benchmark) {
+    // A program path of 1000 steps (joints and step data): grow one column at a time, as done when a path is built step by step
+    const int rows = 10;
+    const int columns = 1000;
+    benchmark.Run("Matrix2D grow 10x1000 by column", 1, [&]() {
+        tMatrix2D *matrix = Matrix2D_Create();
+        for (int col = 0; col < columns; col++) {
+            Matrix2D_Set_Size(matrix, rows, col + 1);
+            double *column = Matrix2D_Get_col(matrix, col);
+            for (int row = 0; row < rows; row++) {
+                column[row] = row + col;
+            }
+        }
+        sink = sink + Matrix2D_Get_ij(matrix, rows - 1, columns - 1);
+        Matrix2D_Delete(&matrix);
+    });
+    benchmark.Run("Matrix2D set size 10x1000", 10, [&]() {
+        tMatrix2D *matrix = Matrix2D_Create();
+        Matrix2D_Set_Size(matrix, rows, columns);
+        sink = sink + Matrix2D_Get_ncols(matrix);
+        Matrix2D_Delete(&matrix);
+    });
+    tMatrix2D *source = Matrix2D_Create();
+    Matrix2D_Set_Size(source, rows, columns);
+    benchmark.Run("Joints from Matrix2D column", 1000, [&]() {
+        tJoints jnts(source, columns / 2, 6);
+        sink = sink + jnts.ValuesD()[0];
+    });
+    Matrix2D_Delete(&source);
+}
+
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    args.removeFirst();
+    QString filter;
+    QString json_path;
+    QString baseline_path;
+    double threshold = 0.10;
+    int samples = 200;
+    for (int i = 0; i < args.size(); i++) {
+        if (args[i] == "--filter" && i + 1 < args.size()) {
+            filter = args[++i];
+        } else if (args[i] == "--samples" && i + 1 < args.size()) {
+            samples = qMax(1, args[++i].toInt());
+        } else if (args[i] == "--json" && i + 1 < args.size()) {
+            json_path = args[++i];
+        } else if (args[i] == "--baseline" && i + 1 < args.size()) {
+            baseline_path = args[++i];
+        } else if (args[i] == "--threshold" && i + 1 < args.size()) {
+            threshold = args[++i].toDouble();
+        } else {
+            out() << "Usage: InterfaceBenchmark [--filter text] [--samples N] [--json report.json] [--baseline report.json] [--threshold 0.1]\n";
+            return 2;
+        }
+    }
+
+    if (!AllocationCounter::CountsMalloc()) {
+        out() << "Note: only operator new is counted on this platform (malloc, aligned_alloc and allocations of Qt containers are not included)\n";
+    }
+    out() << QString("%1 | %2 | %3 | %4 | %5 | %6\n").arg("Operation", -36).arg("p50 ns/op", 10).arg("Mean ns/op", 10)
+             .arg("p95 ns/op", 10).arg("CV %", 6).arg("Allocs/op", 9);
+
+    InterfaceBenchmark benchmark(filter, samples);
+    run_matrix4x4(benchmark);
+    run_vector3(benchmark);
+    run_joints(benchmark);
+    run_matrix2d(benchmark);
+
+    QJsonObject environment;
+    environment["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    environment["benchmark"] = "InterfaceBenchmark";
+    environment["system"] = QSysInfo::prettyProductName();
+    environment["cpu"] = QSysInfo::currentCpuArchitecture();
+    environment["qt"] = QString(qVersion());
+    environment["allocations"] = AllocationCounter::CountsMalloc() ? "malloc" : "operator new";
+    const QJsonObject report = benchmark.Suite().ToJson(environment);
+
+    if (!json_path.isEmpty()) {
+        QFile file(json_path);
+        if (!file.open(QFile::WriteOnly)) {
+            out() << "Unable to write report: " << json_path << "\n";
+            return 2;
+        }
+        file.write(QJsonDocument(report).toJson());
+    }
+
+    if (!baseline_path.isEmpty()) {
+        QFile file(baseline_path);
+        if (!file.open(QFile::ReadOnly)) {
+            out() << "Unable to open baseline: " << baseline_path << "\n";
+            return 2;
+        }
+        BenchmarkComparison comparison = BenchmarkSuite::Compare(report, QJsonDocument::fromJson(file.readAll()).object(), threshold);
+        for (const QString &line : comparison.lines) {
+            out() << line << "\n";
+        }
+        if (!comparison.regressions.isEmpty()) {
+            out() << "Regressions: " << comparison.regressions.join(", ") << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,76 @@
+#----------------- HELP --------------
+# OPCUABenchmark loads the OPC-UA plugin with a mock RoboDK API (no RoboDK required), starts its server on localhost
+# and measures the server with concurrent OPC-UA client sessions: see README.md
+#
+# Example:
+# OPCUABenchmark ~/RoboDK/bin/plugins/libOPC-UA.so --clients 8 --robots 12 --json opcua-load.json
+#------------------------------------
+
+
+#----------------- TEMPLATE --------- (Qt console application)
+TEMPLATE        = app
+CONFIG         += console c++17
+CONFIG         -= app_bundle
+#------------------------------------
+
+QT += widgets
+
+TARGET          = OPCUABenchmark
+
+# Remove the console output of the sample kinematics (used by the mock robots)
+DEFINES += SAMPLEKINEMATICS_QUIET
+
+*-clang* {
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-deprecated-declarations
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-deprecated-copy-with-user-provided-copy
+}
+
+*-g++* {
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-comment
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-deprecated-copy
+}
+
+INCLUDEPATH += $$PWD/../PluginBenchmarkHost
+INCLUDEPATH += $$PWD/../robotextensions/samplekinematics
+
+HEADERS += \
+    ../PluginBenchmarkHost/mockitem.h \
+    ../PluginBenchmarkHost/mockrobodk.h \
+    ../PluginExample/pluginbenchmark.h \
+    ../robotextensions/samplekinematics/samplekinematics.h
+
+SOURCES += \
+    main.cpp \
+    ../PluginBenchmarkHost/mockitem.cpp \
+    ../PluginBenchmarkHost/mockrobodk.cpp \
+    ../PluginExample/pluginbenchmark.cpp \
+    ../robotextensions/samplekinematics/samplekinematics.cpp
+
+DISTFILES += \
+    README.md
+
+
+#--------------------------
+# Header and source files required by any RoboDK plugin
+# Do not change this section, make sure to have the robodk_interface folder up one folder
+include($$PWD/../robodk_interface/robodk_interface.pri)
+#--------------------------
+
+
+# ------------------------
+# Open62541 client, built from the same source as the plugin (see Plugin-OPC-UA/PluginOPCUA.pro)
+win32-msvc {
+    DEFINES += _CRT_SECURE_NO_WARNINGS
+    QMAKE_CXXFLAGS_WARN_ON += -wd4100
+    QMAKE_CFLAGS_WARN_ON += -wd4100
+    QMAKE_CFLAGS += -std:clatest
+} else {
+    QMAKE_CFLAGS += -std=c99
+}
+HEADERS += ../Plugin-OPC-UA/opcua/open62541.h
+SOURCES += ../Plugin-OPC-UA/opcua/open62541.c
+win32 {
+    LIBS += -lws2_32
+}
+INCLUDEPATH += $$PWD/../Plugin-OPC-UA/opcua
+#--------------------------
@@ -0,0 +1,490 @@
+// OPCUABenchmark loads the OPC-UA plugin in a mock RoboDK (see PluginBenchmarkHost), starts its server on localhost
+// and measures the throughput and the latency of the server with concurrent OPC-UA client sessions.
+// Usage: OPCUABenchmark <plugin library> [--clients N] [--robots N] [--duration s] [--warmup s] [--mix getJoints=30,setJoints=30,...]
+//                       [--port 4840] [--latency us] [--render-rate Hz] [--json report.json] [--baseline report.json] [--threshold 0.1] [--verbose]
+// See README.md.
+
+#include "mockrobodk.h"
+#include "iapprobodk.h"
+#include "../PluginExample/pluginbenchmark.h"
+
+#include "open62541.h"
+
+#include <QApplication>
+#include <QMainWindow>
+#include <QMenuBar>
+#include <QStatusBar>
+#include <QTimer>
+#include <QFile>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QDateTime>
+#include <QSysInfo>
+#include <QPluginLoader>
+#include <QScopedPointer>
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <thread>
+#include <cstdio>
+
+
+static bool verbose = false;
+
+// Hide the debug output of the plugin unless --verbose is used
+static void message_handler(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
+    Q_UNUSED(context)
+    if (!verbose && (type == QtDebugMsg || type == QtInfoMsg)) {
+        return;
+    }
+    fprintf(stderr, "%s\n", qPrintable(msg));
+}
+
+static QTextStream &out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+
+/// Operations sent by the client sessions
+enum {
+    OP_GETJOINTS = 0,
+    OP_SETJOINTS,
+    OP_GETJOINTSMULTI,
+    OP_SETJOINTSMULTI,
+    OP_GETITEM,
+    OP_READ,
+    OP_COUNT
+};
+
+static const char *operation_names[OP_COUNT] = {"getJoints", "setJoints", "getJointsMulti", "setJointsMulti", "getItem", "read"};
+
+
+/// Node IDs published by the OPC-UA server of the plugin (see opcua_server.cpp)
+static const UA_UInt32 METHOD_GETITEM = 1000;
+static const UA_UInt32 METHOD_GETJOINTS = 1001;
+static const UA_UInt32 METHOD_GETJOINTSMULTI = 1003;
+static const UA_UInt32 METHOD_SETJOINTS = 2001;
+static const UA_UInt32 METHOD_SETJOINTSMULTI = 2003;
+
+
+///
+/// \brief The LoadClient class is one OPC-UA client session. It runs on its own thread and sends a random mix of
+/// operations until it is stopped, timing each operation.
+///
+class LoadClient {
+public:
+    LoadClient(int id, const QString &url, const QStringList &robots, const QVector<int> &mix) : id(id), url(url.toUtf8()), mix(mix) {
+        for (const QString &robot : robots) {
+            robot_names.append(robot.toUtf8());
+            joints_nodes.append("Robots." + robot.toUtf8() + ".Joints");
+        }
+    }
+
+    /// Connect, retrieve the item IDs and send operations until \a stop is set. Samples are only recorded when \a record is set.
+    void Run(const std::atomic<bool> &stop, const std::atomic<bool> &record);
+
+    /// Time of each operation (nanoseconds)
+    QVector<qint64> samples_ns[OP_COUNT];
+
+    /// Number of operations that returned an error (after the warm-up)
+    quint64 errors[OP_COUNT] = {};
+
+    /// Error of the session (connection failure)
+    QString error;
+
+private:
+    /// Call a method of the server. The output arguments are discarded.
+    UA_StatusCode call(UA_UInt32 method, size_t input_size, UA_Variant *input);
+
+    UA_StatusCode run_operation(int operation, std::mt19937 &random);
+
+private:
+    int id;
+    QByteArray url;
+    QVector<int> mix;
+    QList<QByteArray> robot_names;
+    QList<QByteArray> joints_nodes;
+    QVector<UA_UInt64> item_ids;
+    UA_Client *client = nullptr;
+
+    /// Number of setJoints calls, used to generate different joint values
+    quint64 step = 0;
+};
+
+UA_StatusCode LoadClient::call(UA_UInt32 method, size_t input_size, UA_Variant *input) {
+    size_t output_size = 0;
+    UA_Variant *output = nullptr;
+    UA_StatusCode status = UA_Client_call(client, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER), UA_NODEID_NUMERIC(1, method),
+                                          input_size, input, &output_size, &output);
+    if (output_size > 0) {
+        UA_Array_delete(output, output_size, &UA_TYPES[UA_TYPES_VARIANT]);
+    }
+    for (size_t i = 0; i < input_size; i++) {
+        UA_Variant_deleteMembers(&input[i]);
+    }
+    return status;
+}
+
+UA_StatusCode LoadClient::run_operation(int operation, std::mt19937 &random) {
+    const int robot_id = int(random() % robot_names.size());
+    UA_Variant input[2];
+    UA_Variant_init(&input[0]);
+    UA_Variant_init(&input[1]);
+
+    // Joint values that change with every call (the server coalesces the pending writes of the same robot)
+    step++;
+    double joints[6] = {0, 0, 0, 0, 90, 0};
+    joints[0] = 30.0 * std::sin(0.01 * step + id);
+
+    switch (operation) {
+    case OP_GETJOINTS:
+        UA_Variant_setScalarCopy(&input[0], &item_ids[robot_id], &UA_TYPES[UA_TYPES_UINT64]);
+        return call(METHOD_GETJOINTS, 1, input);
+
+    case OP_SETJOINTS:
+        UA_Variant_setScalarCopy(&input[0], &item_ids[robot_id], &UA_TYPES[UA_TYPES_UINT64]);
+        UA_Variant_setArrayCopy(&input[1], joints, 6, &UA_TYPES[UA_TYPES_DOUBLE]);
+        return call(METHOD_SETJOINTS, 2, input);
+
+    case OP_GETJOINTSMULTI:
+        UA_Variant_setArrayCopy(&input[0], item_ids.constData(), item_ids.size(), &UA_TYPES[UA_TYPES_UINT64]);
+        return call(METHOD_GETJOINTSMULTI, 1, input);
+
+    case OP_SETJOINTSMULTI: {
+        QVector<double> all_joints;
+        for (int i = 0; i < item_ids.size(); i++) {
+            for (int j = 0; j < 6; j++) {
+                all_joints.append(joints[j]);
+            }
+        }
+        UA_Variant_setArrayCopy(&input[0], item_ids.constData(), item_ids.size(), &UA_TYPES[UA_TYPES_UINT64]);
+        UA_Variant_setArrayCopy(&input[1], all_joints.constData(), all_joints.size(), &UA_TYPES[UA_TYPES_DOUBLE]);
+        return call(METHOD_SETJOINTSMULTI, 2, input);
+    }
+
+    case OP_GETITEM: {
+        UA_String name = UA_STRING(robot_names[robot_id].data());
+        UA_Variant_setScalarCopy(&input[0], &name, &UA_TYPES[UA_TYPES_STRING]);
+        return call(METHOD_GETITEM, 1, input);
+    }
+
+    case OP_READ: {
+        UA_Variant value;
+        UA_Variant_init(&value);
+        UA_StatusCode status = UA_Client_readValueAttribute(client, UA_NODEID_STRING(1, joints_nodes[robot_id].constData()), &value);
+        UA_Variant_deleteMembers(&value);
+        return status;
+    }
+    }
+    return UA_STATUSCODE_BADUNEXPECTEDERROR;
+}
+
+void LoadClient::Run(const std::atomic<bool> &stop, const std::atomic<bool> &record) {
+    client = UA_Client_new(UA_ClientConfig_standard);
+
+    // The server starts on another thread: retry for a few seconds
+    UA_StatusCode status = UA_STATUSCODE_BADUNEXPECTEDERROR;
+    for (int i = 0; i < 50 && !stop; i++) {
+        status = UA_Client_connect(client, url.constData());
+        if (status == UA_STATUSCODE_GOOD) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+    if (status != UA_STATUSCODE_GOOD) {
+        error = QString("Client %1: unable to connect to %2 (%3)").arg(id).arg(QString(url)).arg(UA_StatusCode_name(status));
+        UA_Client_delete(client);
+        client = nullptr;
+        return;
+    }
+
+    // Retrieve the item IDs of the robots once (like a real client would)
+    for (int i = 0; i < robot_names.size(); i++) {
+        UA_Variant input;
+        UA_String name = UA_STRING(robot_names[i].data());
+        UA_Variant_setScalarCopy(&input, &name, &UA_TYPES[UA_TYPES_STRING]);
+        size_t output_size = 0;
+        UA_Variant *output = nullptr;
+        UA_UInt64 item_id = 0;
+        if (UA_Client_call(client, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER), UA_NODEID_NUMERIC(1, METHOD_GETITEM),
+                           1, &input, &output_size, &output) == UA_STATUSCODE_GOOD && output_size > 0) {
+            item_id = *(UA_UInt64*)output[0].data;
+        }
+        if (output_size > 0) {
+            UA_Array_delete(output, output_size, &UA_TYPES[UA_TYPES_VARIANT]);
+        }
+        UA_Variant_deleteMembers(&input);
+        item_ids.append(item_id);
+    }
+
+    // Pick the operations according to their weight in the mix
+    std::mt19937 random(id + 1);
+    std::discrete_distribution<int> pick(mix.constBegin(), mix.constEnd());
+    while (!stop) {
+        const int operation = pick(random);
+        const auto start = std::chrono::steady_clock::now();
+        status = run_operation(operation, random);
+        const qint64 elapsed_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+        if (!record) {
+            continue;
+        }
+        samples_ns[operation].append(elapsed_ns);
+        if (status != UA_STATUSCODE_GOOD) {
+            errors[operation]++;
+        }
+    }
+
+    UA_Client_disconnect(client);
+    UA_Client_delete(client);
+    client = nullptr;
+}
+
+
+/// Parse the mix of operations, for example "getJoints=30,setJoints=30,getItem=10,read=30"
+static bool parse_mix(const QString &text, QVector<int> *mix) {
+    mix->fill(0, OP_COUNT);
+    for (const QString &entry : text.split(',')) {
+        if (entry.trimmed().isEmpty()) {
+            continue;
+        }
+        const QStringList name_weight = entry.split('=');
+        int operation = -1;
+        for (int i = 0; i < OP_COUNT; i++) {
+            if (name_weight[0].trimmed().compare(operation_names[i], Qt::CaseInsensitive) == 0) {
+                operation = i;
+            }
+        }
+        bool ok = false;
+        const int weight = name_weight.value(1).toInt(&ok);
+        if (operation < 0 || !ok || weight < 0) {
+            return false;
+        }
+        (*mix)[operation] = weight;
+    }
+    for (int weight : *mix) {
+        if (weight > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+
+int main(int argc, char *argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    args.removeFirst();
+    int nclients = 4;
+    int nrobots = 12;
+    double duration_s = 10.0;
+    double warmup_s = 1.0;
+    int port = 4840;
+    double latency_us = 0.0;
+    double render_rate = 30.0;
+    QString mix_text = "getJoints=30,setJoints=30,getItem=10,read=30";
+    QString json_path;
+    QString baseline_path;
+    double threshold = 0.10;
+    QStringList positional;
+    for (int i = 0; i < args.size(); i++) {
+        if (args[i] == "--verbose") {
+            verbose = true;
+        } else if (args[i] == "--clients" && i + 1 < args.size()) {
+            nclients = qMax(1, args[++i].toInt());
+        } else if (args[i] == "--robots" && i + 1 < args.size()) {
+            nrobots = qMax(1, args[++i].toInt());
+        } else if (args[i] == "--duration" && i + 1 < args.size()) {
+            duration_s = qMax(0.1, args[++i].toDouble());
+        } else if (args[i] == "--warmup" && i + 1 < args.size()) {
+            warmup_s = qMax(0.0, args[++i].toDouble());
+        } else if (args[i] == "--mix" && i + 1 < args.size()) {
+            mix_text = args[++i];
+        } else if (args[i] == "--port" && i + 1 < args.size()) {
+            port = args[++i].toInt();
+        } else if (args[i] == "--latency" && i + 1 < args.size()) {
+            latency_us = args[++i].toDouble();
+        } else if (args[i] == "--render-rate" && i + 1 < args.size()) {
+            render_rate = args[++i].toDouble();
+        } else if (args[i] == "--json" && i + 1 < args.size()) {
+            json_path = args[++i];
+        } else if (args[i] == "--baseline" && i + 1 < args.size()) {
+            baseline_path = args[++i];
+        } else if (args[i] == "--threshold" && i + 1 < args.size()) {
+            threshold = args[++i].toDouble();
+        } else {
+            positional.append(args[i]);
+        }
+    }
+    QVector<int> mix;
+    if (positional.size() != 1 || !parse_mix(mix_text, &mix)) {
+        fprintf(stderr, "Usage: OPCUABenchmark <plugin library> [--clients N] [--robots N] [--duration s] [--warmup s] [--mix getJoints=30,setJoints=30,...]\n"
+                        "                      [--port 4840] [--latency us] [--render-rate Hz] [--json report.json] [--baseline report.json] [--threshold 0.1] [--verbose]\n");
+        return 2;
+    }
+    qInstallMessageHandler(message_handler);
+
+    QPluginLoader loader(positional[0]);
+    IAppRoboDK *plugin = qobject_cast<IAppRoboDK*>(loader.instance());
+    if (plugin == nullptr) {
+        fprintf(stderr, "Unable to load plugin: %s\n", qPrintable(loader.errorString()));
+        return 2;
+    }
+
+    // Station with N robots (same robot as scripts/opcua.txt of PluginBenchmarkHost)
+    QScopedPointer<QMainWindow> mw(new QMainWindow());
+    QScopedPointer<MockRoboDK> rdk(new MockRoboDK());
+    QStringList station = {"station \"OPC-UA load test\""};
+    QStringList robots;
+    for (int i = 0; i < nrobots; i++) {
+        robots.append(QString("Robot%1").arg(i + 1));
+        station.append(QString("robot %1 dh=0,0,0,400;-90,25,-90,0;0,560,0,0;-90,25,0,515;90,0,0,0;-90,0,180,90 joints=0,0,0,0,90,0 pose=%2,0,0,0,0,0")
+                       .arg(robots.last()).arg(i * 2000));
+    }
+    QString error;
+    if (!rdk->LoadStation(station, &error)) {
+        fprintf(stderr, "%s\n", qPrintable(error));
+        return 2;
+    }
+    rdk->SetLatency("*", latency_us);
+
+    plugin->PluginLoad(mw.data(), mw->menuBar(), mw->statusBar(), rdk.data(), "");
+    plugin->PluginLoadToolbar(mw.data(), 24);
+    plugin->PluginEvent(IAppRoboDK::EventChangedStation);
+    plugin->PluginCommand("ServerPort", QString::number(port));
+    plugin->PluginCommand("ServerStart", "1");
+
+    // Emulate the display of RoboDK: the station is rendered at a fixed rate, which refreshes the values published by the server
+    QTimer render_timer;
+    QObject::connect(&render_timer, &QTimer::timeout, [&]() {
+        plugin->PluginEvent(IAppRoboDK::EventMoved);
+        plugin->PluginEvent(IAppRoboDK::EventRender);
+    });
+    if (render_rate > 0) {
+        render_timer.start(qMax(1, int(1000.0 / render_rate)));
+    }
+
+    // The client sessions run on their own threads while this thread processes the RoboDK commands of the server
+    const QString url = QString("opc.tcp://localhost:%1").arg(port);
+    std::atomic<bool> stop(false);
+    std::atomic<bool> record(false);
+    std::atomic<int> finished(0);
+    QList<LoadClient*> clients;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < nclients; i++) {
+        LoadClient *client = new LoadClient(i, url, robots, mix);
+        clients.append(client);
+        threads.emplace_back([client, &stop, &record, &finished]() {
+            client->Run(stop, record);
+            finished++;
+        });
+    }
+    QTimer::singleShot(int(warmup_s * 1000.0), [&]() {
+        record = true;
+    });
+    QTimer::singleShot(int((warmup_s + duration_s) * 1000.0), [&]() {
+        stop = true;
+        app.quit();
+    });
+    app.exec();
+
+    // Keep processing the RoboDK commands of the server until all the sessions are closed (a session may be waiting for a result)
+    while (finished < nclients) {
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    render_timer.stop();
+
+    // Merge the samples of all the sessions
+    BenchmarkSuite suite;
+    QVector<qint64> samples_ns[OP_COUNT];
+    quint64 errors[OP_COUNT] = {};
+    int exit_code = 0;
+    for (LoadClient *client : clients) {
+        if (!client->error.isEmpty()) {
+            fprintf(stderr, "%s\n", qPrintable(client->error));
+            exit_code = 2;
+        }
+        for (int op = 0; op < OP_COUNT; op++) {
+            samples_ns[op] += client->samples_ns[op];
+            errors[op] += client->errors[op];
+        }
+    }
+    qDeleteAll(clients);
+
+    out() << QString("%1 clients, %2 robots, %3 s, API latency %4 us, render rate %5 Hz\n").arg(nclients).arg(nrobots)
+             .arg(duration_s).arg(latency_us).arg(render_rate);
+    out() << QString("%1 | %2 | %3 | %4 | %5 | %6 | %7 | %8\n").arg("Operation", -16).arg("Calls", 8).arg("Calls/s", 9)
+             .arg("p50 us", 10).arg("p95 us", 10).arg("p99 us", 10).arg("Max us", 10).arg("Errors", 7);
+    QJsonObject throughput;
+    quint64 total_calls = 0;
+    for (int op = 0; op < OP_COUNT; op++) {
+        if (samples_ns[op].isEmpty()) {
+            continue;
+        }
+        const int ncalls = samples_ns[op].size();
+        const double calls_per_s = ncalls / duration_s;
+        const BenchmarkResult &result = suite.Add(operation_names[op], samples_ns[op]);
+        out() << QString("%1 | %2 | %3 | %4 | %5 | %6 | %7 | %8\n").arg(result.name, -16).arg(ncalls, 8)
+                 .arg(calls_per_s, 9, 'f', 1).arg(result.p50_us, 10, 'f', 1).arg(result.p95_us, 10, 'f', 1)
+                 .arg(result.p99_us, 10, 'f', 1).arg(result.max_us, 10, 'f', 1).arg(errors[op], 7);
+        throughput[result.name] = calls_per_s;
+        total_calls += ncalls;
+    }
+    out() << QString("Total: %1 calls/s\n").arg(total_calls / duration_s, 0, 'f', 1);
+    out().flush();
+
+    QJsonObject environment;
+    environment["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    environment["host"] = "OPCUABenchmark";
+    environment["plugin"] = plugin->PluginName();
+    environment["clients"] = nclients;
+    environment["robots"] = nrobots;
+    environment["duration"] = duration_s;
+    environment["mix"] = mix_text;
+    environment["latency_us"] = latency_us;
+    environment["render_rate"] = render_rate;
+    environment["throughput"] = throughput;
+    environment["system"] = QSysInfo::prettyProductName();
+    environment["cpu"] = QSysInfo::currentCpuArchitecture();
+    environment["qt"] = QString(qVersion());
+    const QJsonObject report = suite.ToJson(environment);
+
+    if (!json_path.isEmpty()) {
+        QFile file(json_path);
+        if (!file.open(QFile::WriteOnly)) {
+            fprintf(stderr, "Unable to write report: %s\n", qPrintable(json_path));
+            return 2;
+        }
+        file.write(QJsonDocument(report).toJson());
+    }
+
+    if (!baseline_path.isEmpty()) {
+        QFile file(baseline_path);
+        if (!file.open(QFile::ReadOnly)) {
+            fprintf(stderr, "Unable to open baseline: %s\n", qPrintable(baseline_path));
+            return 2;
+        }
+        BenchmarkComparison comparison = BenchmarkSuite::Compare(report, QJsonDocument::fromJson(file.readAll()).object(), threshold);
+        for (const QString &line : comparison.lines) {
+            out() << line << "\n";
+        }
+        if (!comparison.regressions.isEmpty()) {
+            out() << "Regressions: " << comparison.regressions.join(", ") << "\n";
+            exit_code = qMax(exit_code, 1);
+        }
+        out().flush();
+    }
+
+    plugin->PluginCommand("ServerStart", "0");
+    plugin->PluginUnload();
+    return exit_code;
+}
@@ -11,8 +11,9 @@ SUBDIRS += PluginBallbarTracker/PluginBallbarTracker.pro
 SUBDIRS += PluginExample/PluginExample.pro
 SUBDIRS += PluginLockTCP/PluginLockTCP.pro
 SUBDIRS += PluginLVDT/PluginLVDT.pro
-win32 {
 SUBDIRS += Plugin-OPC-UA/PluginOPCUA.pro
+SUBDIRS += OPCUABenchmark/OPCUABenchmark.pro
+win32 {
 SUBDIRS += PluginOpenGL/PluginOpengl.pro
 SUBDIRS += PluginOpenGL-Shaders/PluginChip8Opengl.pro
 SUBDIRS += PluginRoboUI/PluginRoboUI.pro
@@ -21,3 +22,5 @@ SUBDIRS += PluginRealTime/PluginRealTime.pro
 SUBDIRS += PluginRobotPilot/PluginRobotPilot.pro
 SUBDIRS += PluginCollisionSensor/PluginCollisionSensor.pro
 SUBDIRS += PluginEmbedding/PluginEmbedding.pro
+SUBDIRS += PluginBenchmarkHost/PluginBenchmarkHost.pro
+SUBDIRS += InterfaceBenchmark/InterfaceBenchmark.pro
@@ -96,7 +96,9 @@ HEADERS += \
     opcua_server.h \
     opcua_client.h \
     formopcsettings.h \
-    opcua_tools.h
+    opcua_tools.h \
+    opcua_commandqueue.h \
+    opcua_snapshot.h
 
 SOURCES += \
     dialogusernamepassword.cpp \
@@ -104,7 +106,9 @@ SOURCES += \
     opcua_server.cpp \
     opcua_client.cpp \
     formopcsettings.cpp \
-    opcua_tools.cpp
+    opcua_tools.cpp \
+    opcua_commandqueue.cpp \
+    opcua_snapshot.cpp
 
 RESOURCES += \
     resources1.qrc
@@ -4,6 +4,7 @@
 
 #include <QMessageBox>
 #include <QPushButton>
+#include <QAction>
 #include "dialogusernamepassword.h"
 
 FormOpcSettings::FormOpcSettings(RoboDK *rdk, QWidget *parent, PluginOPCUA *pluginopc) :
@@ -48,6 +49,12 @@ void FormOpcSettings::FormUpdate(){
     ui->spnServerPort->blockSignals(true);
     ui->spnServerPort->setValue(pPlugin->Server->Port);
     ui->spnServerPort->blockSignals(false);
+    ui->spnServerSampling->blockSignals(true);
+    ui->spnServerSampling->setValue(qRound(pPlugin->Server->SamplingInterval));
+    ui->spnServerSampling->blockSignals(false);
+    ui->spnServerHistory->blockSignals(true);
+    ui->spnServerHistory->setValue(pPlugin->Server->HistorySize);
+    ui->spnServerHistory->blockSignals(false);
     ui->chkServerAutoStart->blockSignals(true);
     ui->chkServerAutoStart->setChecked(pPlugin->Server->AutoStart);
     ui->chkServerAutoStart->blockSignals(false);
@@ -56,6 +63,9 @@ void FormOpcSettings::FormUpdate(){
     ui->chkClientRealTime->blockSignals(true);
     ui->chkClientRealTime->setChecked(pPlugin->Client->KeepConnected);
     ui->chkClientRealTime->blockSignals(false);
+    ui->chkClientSubscribe->blockSignals(true);
+    ui->chkClientSubscribe->setChecked(pPlugin->Client->UseSubscription);
+    ui->chkClientSubscribe->blockSignals(false);
 
     ui->txtClientEndpointURL->blockSignals(true);
     ui->txtClientEndpointURL->setText(pPlugin->Client->EndpointUrl);
@@ -65,6 +75,12 @@ void FormOpcSettings::FormUpdate(){
 void FormOpcSettings::on_spnServerPort_valueChanged(int arg1){
     pPlugin->Server->Port = arg1;
 }
+void FormOpcSettings::on_spnServerSampling_valueChanged(int arg1){
+    pPlugin->Server->SamplingInterval = arg1;
+}
+void FormOpcSettings::on_spnServerHistory_valueChanged(int arg1){
+    pPlugin->Server->HistorySize = arg1;
+}
 void FormOpcSettings::on_chkServerAutoStart_stateChanged(int arg1){
     pPlugin->Server->AutoStart = arg1;
 }
@@ -111,6 +127,15 @@ void FormOpcSettings::on_chkClientRealTime_clicked(bool checked){
     }
 }
 
+void FormOpcSettings::on_chkClientSubscribe_clicked(bool checked){
+    // Reconnect using the new mode
+    pPlugin->Client->UseSubscription = checked;
+    if (pPlugin->Client->KeepConnected && pPlugin->action_StartClient->isChecked()){
+        pPlugin->Client->Stop();
+        pPlugin->Client->Start();
+    }
+}
+
 void FormOpcSettings::on_btnClientStop_clicked(){
     pPlugin->Client->Stop();
 }
@@ -31,6 +31,10 @@ private slots:
     /// Callback for the OPC-UA server port
     void on_spnServerPort_valueChanged(int arg1);
 
+    /// Callback for the sampling interval of the robot variables
+    void on_spnServerSampling_valueChanged(int arg1);
+    void on_spnServerHistory_valueChanged(int arg1);
+
     /// Callback for the checkbox to start the OPC-UA server on plugin load
     void on_chkServerAutoStart_stateChanged(int arg1);
 
@@ -53,6 +57,8 @@ private slots:
 
     void on_chkClientRealTime_clicked(bool checked);
 
+    void on_chkClientSubscribe_clicked(bool checked);
+
     void on_btnClientStop_clicked();
 
 private:
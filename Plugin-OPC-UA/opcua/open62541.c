@@ -26457,6 +26457,9 @@ UA_Client_Subscriptions_manuallySendPublishRequest(UA_Client *client) {
     if (client->state == UA_CLIENTSTATE_ERRORED)
         return UA_STATUSCODE_BADSERVERNOTCONNECTED;
 
+    /* Modified for RoboDK: return the result of the publish service so that the
+     * caller can detect service faults (the client state is not changed by them) */
+    UA_StatusCode retval = UA_STATUSCODE_GOOD;
     UA_Boolean moreNotifications = true;
     while(moreNotifications) {
         UA_PublishRequest request;
@@ -26483,11 +26486,14 @@ UA_Client_Subscriptions_manuallySendPublishRequest(UA_Client *client) {
         UA_PublishResponse response = UA_Client_Service_publish(client, request);
         UA_Client_processPublishResponse(client, &request, &response);
         moreNotifications = response.moreNotifications;
+        retval = response.responseHeader.serviceResult;
+        if(retval != UA_STATUSCODE_GOOD)
+            moreNotifications = false;
 
         UA_PublishResponse_deleteMembers(&response);
         UA_PublishRequest_deleteMembers(&request);
     }
-    return UA_STATUSCODE_GOOD;
+    return retval;
 }
 
 #endif /* UA_ENABLE_SUBSCRIPTIONS */
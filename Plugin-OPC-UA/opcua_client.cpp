@@ -12,10 +12,56 @@
 #include <QObject>
 #include <QTimer>
 #include <QAction>
+#include <QVector>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QHash>
+
+#include <atomic>
+#include <chrono>
 
 // Hold the pointer to the last client connection
 UA_Client *client = nullptr;
 
+// Maximum number of nodes per Read request (servers may limit the number of nodes per request)
+#define READ_NODES_MAX 1000
+
+// Consecutive publish errors before the subscription thread reconnects
+#define PUBLISH_ERRORS_MAX 5
+
+// Attempts to subscribe again before the client is stopped (the subscription never started)
+#define SUBSCRIBE_RETRIES_MAX 5
+
+/// Variable node of the server, retrieved by the first browse
+struct tClientNode {
+    /// Node ID (owned copy)
+    UA_NodeId id;
+
+    /// Node identifier as a string
+    QString identifier;
+
+    /// Display name (used as the station parameter name)
+    QString displayname;
+
+    /// True once the display name is retrieved
+    bool named;
+};
+
+/// Nodes of the server (cleared when the connection is closed)
+static QList<tClientNode> ClientNodes;
+
+/// True once the nodes are browsed and read for the first time
+static bool ClientNodesReady = false;
+
+/// Free the cached nodes
+static void clearClientNodes(){
+    for (tClientNode &node : ClientNodes){
+        UA_NodeId_deleteMembers(&node.id);
+    }
+    ClientNodes.clear();
+    ClientNodesReady = false;
+}
+
 
 opcua_client::opcua_client(PluginOPCUA *plugin) : QObject(NULL){
     pPlugin = plugin;
@@ -24,14 +70,22 @@ opcua_client::opcua_client(PluginOPCUA *plugin) : QObject(NULL){
     EndpointUrl = "opc.tcp://localhost:4840";
     AutoStart = false;    
     KeepConnected = true;
+    UseSubscription = false;
+    PublishingInterval = 100;
     username = "";
     password = "";
+    Subscription = nullptr;
+    SubscribeRetries = 0;
 
 
     // set interval to retrieve nodes (in milliseconds)
     BrowseServer.setInterval(100);
     connect(&BrowseServer, SIGNAL(timeout()), this, SLOT(Browse()));
 
+    // check the subscription thread every second (restart it if it stopped)
+    SubscriptionWatchdog.setInterval(1000);
+    connect(&SubscriptionWatchdog, SIGNAL(timeout()), this, SLOT(CheckSubscription()));
+
 }
 opcua_client::~opcua_client(){
     pPlugin = nullptr; // prevent using the plugin interface when we are closing the plugin
@@ -39,7 +93,14 @@ opcua_client::~opcua_client(){
 }
 
 void opcua_client::Start(){
-    if (KeepConnected){
+    if (KeepConnected && UseSubscription){
+        // the subscription thread receives the changes (no polling)
+        BrowseServer.stop();
+        SubscribeRetries = 0;
+        StartSubscription();
+        SubscriptionWatchdog.start();
+        pPlugin->action_StartClient->setChecked(true);
+    } else if (KeepConnected){
         // start timer if we want to remain connected
         BrowseServer.start();
 
@@ -63,8 +124,11 @@ void opcua_client::Stop(){
     }
 
     BrowseServer.stop();
+    SubscriptionWatchdog.stop();
+    StopSubscription();
 
     // clear data
+    clearClientNodes();
     if (client != nullptr) {
         UA_Client_disconnect(client);
         UA_Client_delete(client);
@@ -104,8 +168,9 @@ QStringList opcua_client::ListEndpoints(){
     return endpoints;
 }
 
+// Collect the child nodes in the list provided as the handle (the attributes are read later with batched Read requests)
 static UA_StatusCode callbackNodeIter(UA_NodeId childId, UA_Boolean isInverse, UA_NodeId referenceTypeId, void *h) {
-    PluginOPCUA *plugin = (PluginOPCUA*)h;
+    QList<tClientNode> *nodes = (QList<tClientNode>*)h;
     if(isInverse){
         return UA_STATUSCODE_GOOD;
     }
@@ -120,61 +185,132 @@ static UA_StatusCode callbackNodeIter(UA_NodeId childId, UA_Boolean isInverse, U
         str_identifier = "Uknown";
     }
 
-    // Read the attribute and the display name
-    UA_LocalizedText nodeDisplayName = UA_LOCALIZEDTEXT("en_US","name to read");
-    UA_Variant *nodeValue = UA_Variant_new();
-    UA_StatusCode retval = UA_Client_readValueAttribute(client, childId, nodeValue);
-    UA_StatusCode retval2 = UA_Client_readDisplayNameAttribute(client, childId, &nodeDisplayName);
-    if(retval == UA_STATUSCODE_GOOD && retval2 == UA_STATUSCODE_GOOD){
-        QString strvalue;
-        if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_BOOLEAN].typeId.identifier.numeric) {
-            UA_Boolean value = *((UA_Boolean*)nodeValue->data);
-            strvalue = value ? "1" : "0";
-        } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_DOUBLE].typeId.identifier.numeric) {
-            UA_Double value = *((UA_Double*)nodeValue->data);
-            strvalue = QString::number(value);
-        } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_INT64].typeId.identifier.numeric) {
-            UA_Int64 value = *((UA_Int64*)nodeValue->data);
-            strvalue = QString::number(value);
-        } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_INT32].typeId.identifier.numeric) {
-            UA_Int32 value = *((UA_Int32*)nodeValue->data);
-            strvalue = QString::number(value);
-        } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_INT16].typeId.identifier.numeric) {
-            UA_Int16 value = *((UA_Int16*)nodeValue->data);
-            strvalue = QString::number(value);
-        } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_STRING].typeId.identifier.numeric) {
-            UA_String *value = (UA_String*) nodeValue->data;
-            strvalue = QString::fromUtf8((const char*)value->data, (int)value->length);
-        } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_DATETIME].typeId.identifier.numeric) {
-            UA_DateTime *value = (UA_DateTime*) nodeValue->data;
-            UA_String strval = UA_DateTime_toString(*value);
-            //QString str(name->data, name->length);
-            strvalue = QString::fromUtf8((const char*)strval.data, (int)strval.length);
-        } else {
-            strvalue = QObject::tr("Unknown value type %1").arg(nodeValue->type->typeId.identifier.numeric);
-        }
-        QString displayname = QString::fromUtf8((const char*)nodeDisplayName.text.data, (int)nodeDisplayName.text.length);
+    tClientNode node;
+    UA_NodeId_copy(&childId, &node.id);
+    node.identifier = str_identifier;
+    node.named = false;
+    nodes->append(node);
 
-        // important: skip reserved variables used by the server to update other parameters
-        if (displayname != "StationParameter" && displayname != "StationValue"){
-            plugin->LogAdd(QString("  %1 (%2): %3").arg(displayname).arg(str_identifier).arg(strvalue));
+    //UA_NodeId *parent = (UA_NodeId *)handle;
+    //printf("%d, %d --- %d ---> NodeId %d, %d\n", parent->namespaceIndex, parent->identifier.numeric,
+    // referenceTypeId.identifier.numeric, childId.namespaceIndex, childId.identifier.numeric);
+    return UA_STATUSCODE_GOOD;
+}
 
-            QString stationparam(displayname);
-            if (stationparam.isEmpty()){
-                stationparam = str_identifier;
+// Convert the value of a node to a string
+static QString value_2_string(const UA_Variant *nodeValue){
+    QString strvalue;
+    if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_BOOLEAN].typeId.identifier.numeric) {
+        UA_Boolean value = *((UA_Boolean*)nodeValue->data);
+        strvalue = value ? "1" : "0";
+    } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_DOUBLE].typeId.identifier.numeric) {
+        UA_Double value = *((UA_Double*)nodeValue->data);
+        strvalue = QString::number(value);
+    } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_INT64].typeId.identifier.numeric) {
+        UA_Int64 value = *((UA_Int64*)nodeValue->data);
+        strvalue = QString::number(value);
+    } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_INT32].typeId.identifier.numeric) {
+        UA_Int32 value = *((UA_Int32*)nodeValue->data);
+        strvalue = QString::number(value);
+    } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_INT16].typeId.identifier.numeric) {
+        UA_Int16 value = *((UA_Int16*)nodeValue->data);
+        strvalue = QString::number(value);
+    } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_STRING].typeId.identifier.numeric) {
+        UA_String *value = (UA_String*) nodeValue->data;
+        strvalue = QString::fromUtf8((const char*)value->data, (int)value->length);
+    } else if (nodeValue->type->typeId.identifier.numeric == UA_TYPES[UA_TYPES_DATETIME].typeId.identifier.numeric) {
+        UA_DateTime *value = (UA_DateTime*) nodeValue->data;
+        UA_String strval = UA_DateTime_toString(*value);
+        //QString str(name->data, name->length);
+        strvalue = QString::fromUtf8((const char*)strval.data, (int)strval.length);
+        UA_String_deleteMembers(&strval);
+    } else {
+        strvalue = QObject::tr("Unknown value type %1").arg(nodeValue->type->typeId.identifier.numeric);
+    }
+    return strvalue;
+}
+
+// Read the values of the cached nodes with batched Read requests and update the station parameters.
+// The display names are read in the same requests until they are retrieved and the nodes that are not variables are removed.
+// Nodes that return a bad status (for example, a value that is not available yet) are kept and read again the next time.
+static UA_StatusCode readClientNodes(PluginOPCUA *plugin){
+    QList<int> not_variables;
+    for (int first=0; first<ClientNodes.size(); first+=READ_NODES_MAX){
+        const int count = qMin(READ_NODES_MAX, ClientNodes.size() - first);
+
+        // Value of each node, followed by its display name if it is not known yet
+        QVector<UA_ReadValueId> items;
+        QVector<int> id_value(count);
+        items.reserve(count * 2);
+        for (int i=0; i<count; i++){
+            const tClientNode &node = ClientNodes[first + i];
+            id_value[i] = items.size();
+            for (int j=0; j<(node.named ? 1 : 2); j++){
+                UA_ReadValueId item;
+                UA_ReadValueId_init(&item);
+                item.nodeId = node.id; // not copied: the request does not own the node IDs
+                item.attributeId = j == 0 ? UA_ATTRIBUTEID_VALUE : UA_ATTRIBUTEID_DISPLAYNAME;
+                items.append(item);
+            }
+        }
+        UA_ReadRequest request;
+        UA_ReadRequest_init(&request);
+        request.nodesToRead = items.data();
+        request.nodesToReadSize = items.size();
+        UA_ReadResponse response = UA_Client_Service_read(client, request);
+        UA_StatusCode statusCode = response.responseHeader.serviceResult;
+        if (statusCode == UA_STATUSCODE_GOOD && response.resultsSize != (size_t)items.size()){
+            statusCode = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        if (statusCode != UA_STATUSCODE_GOOD){
+            UA_ReadResponse_deleteMembers(&response);
+            return statusCode;
+        }
+        for (int i=0; i<count; i++){
+            tClientNode &node = ClientNodes[first + i];
+            const UA_DataValue &value = response.results[id_value[i]];
+            const bool read_name = !node.named;
+            if (read_name){
+                const UA_DataValue &name = response.results[id_value[i] + 1];
+                if (name.hasValue && name.value.type == &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]){
+                    UA_LocalizedText *nodeDisplayName = (UA_LocalizedText*) name.value.data;
+                    node.displayname = QString::fromUtf8((const char*)nodeDisplayName->text.data, (int)nodeDisplayName->text.length);
+                    node.named = true;
+                }
             }
-            if (!str_identifier.isEmpty()){
-                plugin->RDK->setParam(displayname, strvalue);
+            if (value.hasStatus && value.status == UA_STATUSCODE_BADATTRIBUTEIDINVALID){
+                // Objects and other nodes without a value attribute
+                plugin->LogAdd(QObject::tr("  node %1 is not a variable").arg(node.identifier));
+                not_variables.append(first + i);
+                continue;
+            }
+            if (!node.named || !value.hasValue || value.value.type == nullptr || (value.hasStatus && value.status != UA_STATUSCODE_GOOD)){
+                // Try again with the next read
+                continue;
+            }
+
+            // important: skip reserved variables used by the server to update other parameters
+            if (node.displayname == "StationParameter" || node.displayname == "StationValue"){
+                continue;
+            }
+            QString strvalue = value_2_string(&value.value);
+            if (read_name){
+                // Log the values of the first browse only (the log is too slow to receive every update)
+                plugin->LogAdd(QString("  %1 (%2): %3").arg(node.displayname).arg(node.identifier).arg(strvalue));
+            }
+            if (!node.identifier.isEmpty()){
+                plugin->RDK->setParam(node.displayname, strvalue);
             }
         }
-    } else {
-        plugin->LogAdd(QObject::tr("  node %1 is not a variable").arg(str_identifier));
+        UA_ReadResponse_deleteMembers(&response);
     }
-    UA_Variant_delete(nodeValue);
 
-    //UA_NodeId *parent = (UA_NodeId *)handle;
-    //printf("%d, %d --- %d ---> NodeId %d, %d\n", parent->namespaceIndex, parent->identifier.numeric,
-    // referenceTypeId.identifier.numeric, childId.namespaceIndex, childId.identifier.numeric);
+    // Don't read the nodes that are not variables again
+    for (int i=not_variables.size()-1; i>=0; i--){
+        UA_NodeId_deleteMembers(&ClientNodes[not_variables[i]].id);
+        ClientNodes.removeAt(not_variables[i]);
+    }
+    ClientNodesReady = true;
     return UA_STATUSCODE_GOOD;
 }
 
@@ -206,11 +342,21 @@ int opcua_client::Browse(bool close_connection){
         just_connected = true;
     }
 
-    // Browse objects using the node iterator
+    // Browse objects using the node iterator (only once per connection: the nodes are cached)
     //UA_NodeId *parent = UA_NodeId_new();
     //*parent = UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER);
-    statusCode = UA_Client_forEachChildNodeCall(client, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER), callbackNodeIter, (void *) pPlugin);
+    statusCode = UA_STATUSCODE_GOOD;
+    if (!ClientNodesReady){
+        clearClientNodes();
+        statusCode = UA_Client_forEachChildNodeCall(client, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER), callbackNodeIter, (void *) &ClientNodes);
+    }
+
+    // Read all the values (and the display names after the browse) with batched requests
+    if(statusCode == UA_STATUSCODE_GOOD) {
+        statusCode = readClientNodes(pPlugin);
+    }
     if(statusCode != UA_STATUSCODE_GOOD) {
+        clearClientNodes();
         UA_Client_disconnect(client);
         UA_Client_delete(client);
         client = nullptr;
@@ -226,6 +372,7 @@ int opcua_client::Browse(bool close_connection){
     if (close_connection){
         pPlugin->RDK->ShowMessage(tr("OPC-UA nodes updated as station variables. Connection closed."), false);
         // Disconnect from server and free memory
+        clearClientNodes();
         UA_Client_disconnect(client);
         UA_Client_delete(client);
         client = nullptr;
@@ -235,3 +382,307 @@ int opcua_client::Browse(bool close_connection){
 
 
 
+
+
+//----------------------------------------------------------------------------------
+// Subscription: the server sends the values that changed, the client does not poll
+
+/// Monitored item of the subscription
+struct tMonitoredNode {
+    /// Subscription state
+    tSubscription *subscription;
+
+    /// Index of the node in the node list
+    int index;
+};
+
+/// State shared by the subscription thread and the RoboDK thread
+struct tSubscription {
+    /// Client that applies the changes
+    opcua_client *owner;
+
+    /// Connection settings (copied when the subscription starts)
+    QString endpoint;
+    QString username;
+    QString password;
+    double publishing_interval;
+
+    /// Cleared to stop the subscription thread (the thread clears it too if the connection is lost)
+    std::atomic<bool> running;
+
+    /// Set once the monitored items are added
+    std::atomic<bool> subscribed;
+
+    /// Variable nodes of the server (set by the subscription thread before monitoring them)
+    QList<tClientNode> nodes;
+
+    /// Contexts of the monitored items
+    QVector<tMonitoredNode> monitored;
+
+    /// Protects the variables below
+    QMutex mutex;
+
+    /// Changes waiting to be applied by the RoboDK thread (latest value per node)
+    QHash<int, QString> changes;
+
+    /// True when ApplyChanges() is scheduled on the RoboDK thread
+    bool apply_scheduled;
+
+    /// Number of changes received per node
+    QVector<quint64> node_changes;
+
+    /// Changes received and applied to the station
+    quint64 notifications;
+    quint64 applied;
+
+    /// Publish latency: time between the server timestamp of a value and its reception (ms)
+    quint64 latency_count;
+    double latency_sum;
+    double latency_max;
+};
+
+// Called by open62541 for each value received (subscription thread)
+static void callbackMonitoredItem(UA_UInt32 monId, UA_DataValue *value, void *context){
+    Q_UNUSED(monId)
+    tMonitoredNode *node = (tMonitoredNode*)context;
+    tSubscription *sub = node->subscription;
+    if (!value->hasValue || value->value.type == nullptr){
+        return;
+    }
+    const UA_DateTime received = UA_DateTime_now();
+    QString strvalue = value_2_string(&value->value);
+
+    QMutexLocker lock(&sub->mutex);
+    sub->node_changes[node->index]++;
+    sub->notifications++;
+    if (value->hasServerTimestamp || value->hasSourceTimestamp){
+        const UA_DateTime sent = value->hasServerTimestamp ? value->serverTimestamp : value->sourceTimestamp;
+        const double latency_ms = (double)(received - sent) / UA_MSEC_TO_DATETIME;
+        sub->latency_count++;
+        sub->latency_sum += latency_ms;
+        sub->latency_max = qMax(sub->latency_max, latency_ms);
+    }
+    sub->changes.insert(node->index, strvalue);
+    if (!sub->apply_scheduled){
+        sub->apply_scheduled = true;
+        QMetaObject::invokeMethod(sub->owner, "ApplyChanges", Qt::QueuedConnection);
+    }
+}
+
+// Read the display names of the nodes with batched Read requests
+static UA_StatusCode readDisplayNames(UA_Client *uaclient, QList<tClientNode> &nodes){
+    for (int first=0; first<nodes.size(); first+=READ_NODES_MAX){
+        const int count = qMin(READ_NODES_MAX, nodes.size() - first);
+        QVector<UA_ReadValueId> items(count);
+        for (int i=0; i<count; i++){
+            UA_ReadValueId_init(&items[i]);
+            items[i].nodeId = nodes[first + i].id;
+            items[i].attributeId = UA_ATTRIBUTEID_DISPLAYNAME;
+        }
+        UA_ReadRequest request;
+        UA_ReadRequest_init(&request);
+        request.nodesToRead = items.data();
+        request.nodesToReadSize = items.size();
+        UA_ReadResponse response = UA_Client_Service_read(uaclient, request);
+        UA_StatusCode statusCode = response.responseHeader.serviceResult;
+        if (statusCode == UA_STATUSCODE_GOOD && response.resultsSize != (size_t)count){
+            statusCode = UA_STATUSCODE_BADUNEXPECTEDERROR;
+        }
+        for (int i=0; statusCode == UA_STATUSCODE_GOOD && i<count; i++){
+            const UA_DataValue &name = response.results[i];
+            if (name.hasValue && name.value.type == &UA_TYPES[UA_TYPES_LOCALIZEDTEXT]){
+                UA_LocalizedText *nodeDisplayName = (UA_LocalizedText*) name.value.data;
+                nodes[first + i].displayname = QString::fromUtf8((const char*)nodeDisplayName->text.data, (int)nodeDisplayName->text.length);
+                nodes[first + i].named = true;
+            }
+        }
+        UA_ReadResponse_deleteMembers(&response);
+        if (statusCode != UA_STATUSCODE_GOOD){
+            return statusCode;
+        }
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+// Subscription thread: connect, monitor all the variables of the Objects folder and receive the changes until the subscription is stopped
+static void opc_subscription_thread(tSubscription *sub){
+    PluginOPCUA *plugin = sub->owner->pPlugin;
+    UA_Client *uaclient = UA_Client_new(UA_ClientConfig_standard);
+    UA_StatusCode statusCode;
+    if (sub->username.isEmpty()) {
+        statusCode = UA_Client_connect(uaclient, sub->endpoint.toUtf8().constData());
+    } else {
+        statusCode = UA_Client_connect_username(uaclient, sub->endpoint.toUtf8().constData(), sub->username.toUtf8(), sub->password.toUtf8());
+    }
+    if (statusCode != UA_STATUSCODE_GOOD){
+        emit plugin->EmitShowMessage(QObject::tr("Connecting to OPC-UA server failed. Reason: %1").arg(UA_StatusCode_description(statusCode)->explanation));
+        UA_Client_delete(uaclient);
+        sub->running = false;
+        return;
+    }
+
+    // Browse the nodes and read their names (the monitored items send the initial values)
+    statusCode = UA_Client_forEachChildNodeCall(uaclient, UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER), callbackNodeIter, (void *) &sub->nodes);
+    if (statusCode == UA_STATUSCODE_GOOD){
+        statusCode = readDisplayNames(uaclient, sub->nodes);
+    }
+    UA_UInt32 subscription_id = 0;
+    if (statusCode == UA_STATUSCODE_GOOD){
+        UA_SubscriptionSettings settings = UA_SubscriptionSettings_standard;
+        settings.requestedPublishingInterval = sub->publishing_interval;
+        settings.maxNotificationsPerPublish = 0; // no limit
+        statusCode = UA_Client_Subscriptions_new(uaclient, settings, &subscription_id);
+    }
+    if (statusCode == UA_STATUSCODE_GOOD){
+        // The contexts must not move once the monitored items are added
+        {
+            QMutexLocker lock(&sub->mutex);
+            sub->node_changes.fill(0, sub->nodes.size());
+        }
+        sub->monitored.resize(sub->nodes.size());
+        int count = 0;
+        for (int i=0; i<sub->nodes.size() && sub->running; i++){
+            // important: skip reserved variables used by the server to update other parameters
+            const QString &displayname = sub->nodes[i].displayname;
+            if (displayname == "StationParameter" || displayname == "StationValue"){
+                continue;
+            }
+            sub->monitored[i].subscription = sub;
+            sub->monitored[i].index = i;
+            UA_UInt32 monitored_id = 0;
+            if (UA_Client_Subscriptions_addMonitoredItem(uaclient, subscription_id, sub->nodes[i].id, UA_ATTRIBUTEID_VALUE,
+                                                         callbackMonitoredItem, &sub->monitored[i], &monitored_id) == UA_STATUSCODE_GOOD){
+                count++;
+            }
+        }
+        sub->subscribed = true;
+        emit plugin->EmitShowMessage(QObject::tr("OPC-UA subscription to %1 variables of %2").arg(count).arg(sub->endpoint));
+    } else {
+        emit plugin->EmitShowMessage(QObject::tr("Unable to subscribe to the server nodes. Reason: %1").arg(UA_StatusCode_description(statusCode)->explanation));
+    }
+
+    // Each publish request returns when there are changes or after the keep alive time (publishing interval)
+    int errors = 0;
+    while (statusCode == UA_STATUSCODE_GOOD && sub->running){
+        UA_StatusCode publishCode = UA_Client_Subscriptions_manuallySendPublishRequest(uaclient);
+        if (publishCode == UA_STATUSCODE_GOOD && UA_Client_getState(uaclient) == UA_CLIENTSTATE_CONNECTED){
+            errors = 0;
+            continue;
+        }
+        if (publishCode == UA_STATUSCODE_GOOD){
+            publishCode = UA_STATUSCODE_BADCONNECTIONCLOSED;
+        }
+
+        // Service fault or connection error: wait before the next request (100 ms, 200 ms, 400 ms...).
+        // The client reconnects with a new session if the errors persist (see CheckSubscription).
+        if (UA_Client_getState(uaclient) != UA_CLIENTSTATE_CONNECTED || ++errors >= PUBLISH_ERRORS_MAX){
+            emit plugin->EmitShowMessage(QObject::tr("OPC-UA subscription stopped. Reason: %1").arg(UA_StatusCode_description(publishCode)->explanation));
+            break;
+        }
+        const std::chrono::steady_clock::time_point retry = std::chrono::steady_clock::now() + std::chrono::milliseconds(100 << (errors - 1));
+        while (sub->running && std::chrono::steady_clock::now() < retry){
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    if (subscription_id != 0){
+        UA_Client_Subscriptions_remove(uaclient, subscription_id);
+    }
+    UA_Client_disconnect(uaclient);
+    UA_Client_delete(uaclient);
+    sub->running = false;
+}
+
+void opcua_client::StartSubscription(){
+    if (Subscription != nullptr){
+        if (Subscription->running){
+            return;
+        }
+        // the previous subscription ended (connection lost): start again
+        StopSubscription();
+    }
+    Subscription = new tSubscription;
+    Subscription->owner = this;
+    Subscription->endpoint = EndpointUrl;
+    Subscription->username = username;
+    Subscription->password = password;
+    Subscription->publishing_interval = PublishingInterval;
+    Subscription->running = true;
+    Subscription->subscribed = false;
+    Subscription->apply_scheduled = false;
+    Subscription->notifications = 0;
+    Subscription->applied = 0;
+    Subscription->latency_count = 0;
+    Subscription->latency_sum = 0;
+    Subscription->latency_max = 0;
+    pPlugin->ShowMessage(tr("Subscribing to OPC-UA server %1").arg(EndpointUrl));
+    SubscriptionThread = std::thread(opc_subscription_thread, Subscription);
+}
+
+void opcua_client::StopSubscription(){
+    if (Subscription == nullptr){
+        return;
+    }
+    // The thread finishes after the current publish request (at most the publishing interval, or the client timeout if the connection is lost)
+    Subscription->running = false;
+    if (SubscriptionThread.joinable()){
+        SubscriptionThread.join();
+    }
+    for (tClientNode &node : Subscription->nodes){
+        UA_NodeId_deleteMembers(&node.id);
+    }
+    delete Subscription;
+    Subscription = nullptr;
+}
+
+void opcua_client::CheckSubscription(){
+    if (Subscription == nullptr || Subscription->running){
+        return;
+    }
+    // The subscription thread stopped on its own (connection lost or publish errors)
+    if (Subscription->subscribed){
+        // it worked before: subscribe again right away
+        SubscribeRetries = 0;
+    } else if (++SubscribeRetries > SUBSCRIBE_RETRIES_MAX){
+        pPlugin->ShowMessage(tr("OPC-UA client stopped: unable to subscribe to %1").arg(EndpointUrl));
+        Stop();
+        return;
+    }
+    StartSubscription();
+}
+
+void opcua_client::ApplyChanges(){
+    if (Subscription == nullptr){
+        return;
+    }
+    QHash<int, QString> changes;
+    {
+        QMutexLocker lock(&Subscription->mutex);
+        changes.swap(Subscription->changes);
+        Subscription->apply_scheduled = false;
+        Subscription->applied += changes.size();
+    }
+    // The node list does not change while the subscription is running
+    for (QHash<int, QString>::const_iterator it = changes.constBegin(); it != changes.constEnd(); ++it){
+        const tClientNode &node = Subscription->nodes.at(it.key());
+        pPlugin->RDK->setParam(node.displayname.isEmpty() ? node.identifier : node.displayname, it.value());
+    }
+}
+
+QString opcua_client::SubscriptionStats(){
+    if (Subscription == nullptr){
+        return tr("No subscription");
+    }
+    // The node names are set before the counters are allocated
+    QMutexLocker lock(&Subscription->mutex);
+    QString stats = tr("Changes received: %1, applied: %2").arg(Subscription->notifications).arg(Subscription->applied);
+    if (Subscription->latency_count > 0){
+        stats += tr(", publish latency: %1 ms (mean), %2 ms (max)").arg(Subscription->latency_sum / Subscription->latency_count, 0, 'f', 1).arg(Subscription->latency_max, 0, 'f', 1);
+    }
+    for (int i=0; i<Subscription->node_changes.size(); i++){
+        if (Subscription->node_changes[i] > 0){
+            stats += QString("\n  %1 (%2): %3").arg(Subscription->nodes[i].displayname).arg(Subscription->nodes[i].identifier).arg(Subscription->node_changes[i]);
+        }
+    }
+    return stats;
+}
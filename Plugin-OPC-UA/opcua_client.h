@@ -4,7 +4,10 @@
 #include <QObject>
 #include <QTimer>
 
+#include <thread>
+
 class PluginOPCUA;
+struct tSubscription;
 
 class opcua_client : public QObject
 {
@@ -27,10 +30,19 @@ public:
     /// Show the list of OPC-UA end points
     QStringList ListEndpoints();
 
+    /// Statistics of the subscription: number of changes per node and publish latency
+    QString SubscriptionStats();
+
 public slots:
     /// Use the OPC-UA client to connect to the server and retrieve the server variables as RoboDK station variables
     int Browse(bool close_connection = false);
 
+    /// Apply the changes received by the subscription as RoboDK station variables (RoboDK thread)
+    void ApplyChanges();
+
+    /// Start the subscription again if its thread stopped (connection lost). The client is stopped if the server can't be subscribed to.
+    void CheckSubscription();
+
 public:
     /// End Point URL: It contains the IP and port (for example: "opc.tcp://localhost:4840")
     QString EndpointUrl;
@@ -41,14 +53,39 @@ public:
     bool AutoStart;
     bool KeepConnected;
 
+    /// Keep connected using a subscription: the server sends the changes instead of polling all the nodes
+    bool UseSubscription;
+
+    /// Publishing interval requested for the subscription (in ms)
+    double PublishingInterval;
+
     /// Timer to update variables from the server
     QTimer BrowseServer;
 
+    /// Timer to check that the subscription is running
+    QTimer SubscriptionWatchdog;
+
 public:
 
     /// Pointer to the RoboDK plugin interface
     PluginOPCUA *pPlugin;
 
+private:
+    /// Start the subscription thread
+    void StartSubscription();
+
+    /// Stop the subscription thread and wait for it to finish
+    void StopSubscription();
+
+    /// State shared with the subscription thread (null if the subscription is not running)
+    tSubscription *Subscription;
+
+    /// Thread that receives the notifications of the subscription
+    std::thread SubscriptionThread;
+
+    /// Attempts to subscribe since the last successful subscription
+    int SubscribeRetries;
+
 };
 
 #endif // OPCUA_CLIENT_H
@@ -0,0 +1,144 @@
+#include "opcua_commandqueue.h"
+
+#include "pluginopcua.h"
+#include "irobodk.h"
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QDebug>
+
+
+opcua_commandqueue::opcua_commandqueue(PluginOPCUA *plugin) : QObject(NULL){
+    pPlugin = plugin;
+    process_scheduled = false;
+    open = false;
+}
+opcua_commandqueue::~opcua_commandqueue(){
+    Close();
+}
+
+void opcua_commandqueue::Open(){
+    QMutexLocker lock(&mutex);
+    open = true;
+}
+
+void opcua_commandqueue::Close(){
+    QMutexLocker lock(&mutex);
+    open = false;
+    for (const tCommand &cmd : pending){
+        if (cmd.state){
+            *cmd.state = STATE_CANCELLED;
+        }
+    }
+    pending.clear();
+    pending_keys.clear();
+    batch_done.wakeAll();
+}
+
+bool opcua_commandqueue::PostMove(const QString &key, const std::function<void()> &command){
+    QMutexLocker lock(&mutex);
+    return enqueue({key, true, command, nullptr});
+}
+
+bool opcua_commandqueue::Post(const QString &key, const std::function<void()> &command){
+    QMutexLocker lock(&mutex);
+    return enqueue({key, false, command, nullptr});
+}
+
+bool opcua_commandqueue::Call(const std::function<void()> &command, int timeout_ms){
+    std::shared_ptr<int> state = std::make_shared<int>(STATE_QUEUED);
+    QMutexLocker lock(&mutex);
+    if (!enqueue({QString(), false, command, state})){
+        return false;
+    }
+    QElapsedTimer timer;
+    timer.start();
+    while (true){
+        if (*state == STATE_DONE){
+            return true;
+        } else if (*state == STATE_CANCELLED){
+            return false;
+        }
+        if (*state == STATE_QUEUED && timer.elapsed() >= timeout_ms){
+            // The RoboDK thread is busy: remove the command so that it never runs (it may use variables of the caller)
+            for (int i=0; i<pending.size(); i++){
+                if (pending[i].state == state){
+                    pending.removeAt(i);
+                    break;
+                }
+            }
+            pending_keys.clear();
+            for (int i=0; i<pending.size(); i++){
+                if (!pending[i].key.isEmpty()){
+                    pending_keys.insert(pending[i].key, i);
+                }
+            }
+            qDebug() << "OPC-UA command timed out after" << timeout_ms << "ms";
+            return false;
+        }
+        // A running command can't be cancelled: keep waiting until the batch is done
+        batch_done.wait(&mutex, 50);
+    }
+}
+
+bool opcua_commandqueue::enqueue(tCommand &&cmd){
+    if (!open){
+        return false;
+    }
+    if (!cmd.key.isEmpty() && pending_keys.contains(cmd.key)){
+        // Coalesce: replace the pending command with the same key (it keeps its position in the queue)
+        tCommand &previous = pending[pending_keys.value(cmd.key)];
+        previous.command = std::move(cmd.command);
+        previous.render = previous.render || cmd.render;
+        return true;
+    }
+    if (!cmd.key.isEmpty()){
+        pending_keys.insert(cmd.key, pending.size());
+    }
+    pending.append(std::move(cmd));
+    if (!process_scheduled){
+        // Process() runs on the thread of this object (RoboDK thread) as soon as it is idle.
+        // Commands received while the RoboDK thread is busy are executed in the same batch.
+        process_scheduled = true;
+        QMetaObject::invokeMethod(this, "Process", Qt::QueuedConnection);
+    }
+    return true;
+}
+
+void opcua_commandqueue::Process(){
+    QList<tCommand> batch;
+    {
+        QMutexLocker lock(&mutex);
+        batch.swap(pending);
+        pending_keys.clear();
+        process_scheduled = false;
+        for (const tCommand &cmd : batch){
+            if (cmd.state){
+                *cmd.state = STATE_RUNNING;
+            }
+        }
+    }
+    if (batch.isEmpty()){
+        return;
+    }
+
+    // Run the commands without holding the lock, so that the server thread can queue new commands
+    bool render = false;
+    for (const tCommand &cmd : batch){
+        cmd.command();
+        render = render || cmd.render;
+    }
+
+    // Render once per batch
+    if (render && pPlugin != nullptr){
+        pPlugin->RDK->Render();
+    }
+
+    QMutexLocker lock(&mutex);
+    for (const tCommand &cmd : batch){
+        if (cmd.state){
+            *cmd.state = STATE_DONE;
+        }
+    }
+    batch_done.wakeAll();
+}
@@ -0,0 +1,101 @@
+#ifndef OPCUA_COMMANDQUEUE_H
+#define OPCUA_COMMANDQUEUE_H
+
+#include <QObject>
+#include <QList>
+#include <QHash>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <functional>
+#include <memory>
+
+class PluginOPCUA;
+
+
+/// This class runs the RoboDK API calls of the OPC-UA server callbacks on the RoboDK (main) thread.
+/// The server thread queues the commands and the RoboDK thread executes all the pending commands in one batch.
+/// Writes with the same key (for example, setJoints on the same robot) are coalesced: the latest value wins.
+class opcua_commandqueue : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit opcua_commandqueue(PluginOPCUA *plugin);
+    ~opcua_commandqueue();
+
+    /// Accept new commands (call it before starting the server)
+    void Open();
+
+    /// Reject new commands and cancel the pending ones. Threads waiting for a result are released.
+    void Close();
+
+    /// Queue a command that moves items (server thread). The station is rendered once after the batch.
+    /// If a command with the same key is pending, it is replaced by the new one (the latest value wins).
+    /// Returns false if the queue is closed.
+    bool PostMove(const QString &key, const std::function<void()> &command);
+
+    /// Queue a command without waiting for it to run (server thread). Same coalescing as PostMove, without the render.
+    /// Returns false if the queue is closed.
+    bool Post(const QString &key, const std::function<void()> &command);
+
+    /// Run a command on the RoboDK thread and wait for it to finish (server thread).
+    /// Returns false if the queue was closed or the timeout expired before the command ran.
+    bool Call(const std::function<void()> &command, int timeout_ms = 5000);
+
+public slots:
+    /// Execute all the pending commands (RoboDK thread)
+    void Process();
+
+private:
+    /// Command waiting to run
+    struct tCommand {
+        /// Coalescing key (empty if the command can not be replaced)
+        QString key;
+
+        /// Render the station after this command
+        bool render;
+
+        /// Function to run on the RoboDK thread
+        std::function<void()> command;
+
+        /// State of the command, shared with the thread waiting for it (null if nobody waits for the command)
+        std::shared_ptr<int> state;
+    };
+
+    /// States of the commands that are waited for
+    enum {
+        STATE_QUEUED = 0,
+        STATE_RUNNING = 1,
+        STATE_DONE = 2,
+        STATE_CANCELLED = 3
+    };
+
+    /// Add a command to the queue and schedule a batch if required (the mutex must be locked)
+    bool enqueue(tCommand &&cmd);
+
+private:
+    /// Pointer to the RoboDK plugin interface
+    PluginOPCUA *pPlugin;
+
+    /// Protects the variables below (shared by the server thread and the RoboDK thread)
+    QMutex mutex;
+
+    /// Signaled when a batch finished or the queue is closed
+    QWaitCondition batch_done;
+
+    /// Pending commands, in the order they were received
+    QList<tCommand> pending;
+
+    /// Position of the pending commands by coalescing key
+    QHash<QString, int> pending_keys;
+
+    /// True when Process() is scheduled on the RoboDK thread
+    bool process_scheduled;
+
+    /// False when the queue does not accept commands
+    bool open;
+
+};
+
+#endif // OPCUA_COMMANDQUEUE_H
@@ -7,8 +7,13 @@
 
 #include "robodktools.h"
 #include "opcua_tools.h"
+#include "opcua_commandqueue.h"
+#include "opcua_snapshot.h"
 
 #include <thread>
+#include <algorithm>
+#include <limits>
+#include <climits>
 #include <signal.h>
 #include <errno.h> // errno, EINTR
 #include <stdio.h>
@@ -18,6 +23,8 @@
 
 #include <QFile>
 #include <QTimer>
+#include <QVector>
+#include <QStringList>
 
 
 //----------------------------
@@ -46,7 +53,7 @@ int SERVER_RUNNING_PORT;
 
 QTimer TimerStatus;
 
-int opc_server_thread(PluginOPCUA *pPlugin, unsigned short port);
+int opc_server_thread(PluginOPCUA *pPlugin, unsigned short port, QString version, double sampling_interval);
 
 
 // Important: We need to trigger messages as a Queued signal because we are running different threads!
@@ -65,6 +72,14 @@ opcua_server::opcua_server(PluginOPCUA *plugin) : QObject(NULL){
     AutoStart = false;
     pPlugin = plugin;
 
+    // The server callbacks run on the server thread: RoboDK API calls are queued and executed on the RoboDK thread
+    Commands = new opcua_commandqueue(plugin);
+
+    // Robot values published by the server (refreshed by the RoboDK thread once per frame)
+    Snapshot = new opcua_snapshot();
+    SamplingInterval = 50;
+    HistorySize = 3000;
+
     // Keep an eye on the status flag to make sure we are running the server
     connect(&TimerStatus, SIGNAL(timeout()), this, SLOT(CheckStatus()));
     TimerStatus.setInterval(200); // in msec
@@ -73,6 +88,8 @@ opcua_server::opcua_server(PluginOPCUA *plugin) : QObject(NULL){
 opcua_server::~opcua_server(){
     pPlugin = nullptr; // prevent using the plugin interface when we are closing the plugin
     Stop();
+    delete Commands;
+    delete Snapshot;
 }
 
 void opcua_server::Start(){
@@ -88,7 +105,15 @@ void opcua_server::Start(){
 
     pPlugin->action_StartServer->setChecked(true);
 
-    std::thread opc_thread(opc_server_thread, pPlugin, port);
+    // Accept commands from the server thread
+    Commands->Open();
+
+    // Retrieve the robots before the server adds their nodes
+    Snapshot->SetHistorySize(HistorySize);
+    Snapshot->InvalidateRobots();
+    Snapshot->Refresh(pPlugin->RDK);
+
+    std::thread opc_thread(opc_server_thread, pPlugin, port, pPlugin->RDK->Version(), SamplingInterval);
     opc_thread.detach();
     //Thread->start();
 }
@@ -102,6 +127,9 @@ void opcua_server::Stop(){
         }        
     }
     SERVER_RUNNING = UA_FALSE;
+
+    // Release the server callbacks waiting for the RoboDK thread (the plugin may be waiting for the server to stop)
+    Commands->Close();
 }
 
 bool opcua_server::IsStopped(){
@@ -156,6 +184,18 @@ static void stopHandler(int sign) {
 
 }
 
+// Run a RoboDK API call on the RoboDK thread and wait for the result. Returns false if the server is stopping or RoboDK is busy.
+static bool rdk_call(PluginOPCUA *plugin, const std::function<void()> &command){
+    return plugin->Server->Commands->Call(command);
+}
+
+// Status of a variable that could not be read because the RoboDK thread did not respond
+static UA_StatusCode read_Unavailable(UA_DataValue *value){
+    value->hasStatus = true;
+    value->status = SERVER_RUNNING ? UA_STATUSCODE_BADTIMEOUT : UA_STATUSCODE_BADSHUTDOWN;
+    return UA_STATUSCODE_GOOD;
+}
+
 // Get time according to RoboDK's computer
 static UA_StatusCode read_Time(void *h, const UA_NodeId nodeId, UA_Boolean sourceTimeStamp, const UA_NumericRange *range, UA_DataValue *value) {
     Q_UNUSED(h)
@@ -181,7 +221,10 @@ static UA_StatusCode read_SimRatio(void *h, const UA_NodeId nodeId, UA_Boolean s
         value->status = UA_STATUSCODE_BADINDEXRANGEINVALID;
         return UA_STATUSCODE_GOOD;
     }
-    double ratio = plugin->RDK->SimulationSpeed();
+    double ratio = 0;
+    if (!rdk_call(plugin, [&](){ ratio = plugin->RDK->SimulationSpeed(); })){
+        return read_Unavailable(value);
+    }
     UA_Variant_setScalarCopy(&value->value, &ratio, &UA_TYPES[UA_TYPES_DOUBLE]);
     value->hasValue = true;
     if(sourceTimeStamp) {
@@ -195,7 +238,12 @@ UA_StatusCode write_SimRatio(void *h, const UA_NodeId nodeid, const UA_Variant *
     PluginOPCUA *plugin = (PluginOPCUA*)h;
     UA_Double simulation_ratio;
     simulation_ratio = ((UA_Double*) (data->data))[0];
-    plugin->RDK->setSimulationSpeed(simulation_ratio);
+    bool queued = plugin->Server->Commands->Post("SimulationSpeed", [plugin, simulation_ratio](){
+        plugin->RDK->setSimulationSpeed(simulation_ratio);
+    });
+    if (!queued){
+        return UA_STATUSCODE_BADSHUTDOWN;
+    }
     ShowMessage(plugin, QObject::tr("New RoboDK simulation speed set to %1").arg(simulation_ratio));
     return UA_STATUSCODE_GOOD;
 }
@@ -207,7 +255,10 @@ static UA_StatusCode read_OpenStationName(void *h, const UA_NodeId nodeid, UA_Bo
         value->status = UA_STATUSCODE_BADINDEXRANGEINVALID;
         return UA_STATUSCODE_GOOD;
     }
-    QString str_stationname = plugin->RDK->getActiveStation()->Name();
+    QString str_stationname;
+    if (!rdk_call(plugin, [&](){ str_stationname = plugin->RDK->getActiveStation()->Name(); })){
+        return read_Unavailable(value);
+    }
     Str_2_Var(str_stationname, &value->value);
     value->hasValue = true;
     if(sourceTimeStamp) {
@@ -223,24 +274,27 @@ UA_StatusCode write_OpenStationName(void *h, const UA_NodeId nodeid, const UA_Va
     Var_2_Str(data+0, stationname);
     ShowMessage(plugin, QObject::tr("New station set to %1").arg(stationname));
 
-    bool problems = false;
-    if (!stationname.endsWith(".rdk", Qt::CaseInsensitive)){
-        ShowMessage(plugin, QObject::tr("File should end with '.rdk': %1").arg(stationname));
-        problems = true;
-    } else if (!QFile(stationname).exists()){
-        ShowMessage(plugin, QObject::tr("File not found: %1").arg(stationname));
-        problems = true;
-    } else {
-        Item station = plugin->RDK->AddFile(stationname);
-        if (station == nullptr){
+    // Loading a station takes time: do not block the server
+    bool queued = plugin->Server->Commands->Post(QString(), [plugin, stationname](){
+        bool problems = false;
+        if (!stationname.endsWith(".rdk", Qt::CaseInsensitive)){
+            ShowMessage(plugin, QObject::tr("File should end with '.rdk': %1").arg(stationname));
             problems = true;
+        } else if (!QFile(stationname).exists()){
+            ShowMessage(plugin, QObject::tr("File not found: %1").arg(stationname));
+            problems = true;
+        } else {
+            Item station = plugin->RDK->AddFile(stationname);
+            if (station == nullptr){
+                problems = true;
+            }
         }
-    }
-    if (problems){
-        ShowMessage(plugin, QObject::tr("File not valid or not found: %1").arg(stationname));
-        ShowMessage(plugin, QObject::tr("Current station: %1").arg(plugin->RDK->getActiveStation()->Name()));
-    }
-    return UA_STATUSCODE_GOOD;
+        if (problems){
+            ShowMessage(plugin, QObject::tr("File not valid or not found: %1").arg(stationname));
+            ShowMessage(plugin, QObject::tr("Current station: %1").arg(plugin->RDK->getActiveStation()->Name()));
+        }
+    });
+    return queued ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADSHUTDOWN;
 }
 static UA_StatusCode read_StationParameter(void *h, const UA_NodeId nodeid, UA_Boolean sourceTimeStamp, const UA_NumericRange *range, UA_DataValue *value) {
     Q_UNUSED(h)
@@ -271,7 +325,11 @@ static UA_StatusCode read_StationValue(void *h, const UA_NodeId nodeid, UA_Boole
         value->status = UA_STATUSCODE_BADINDEXRANGEINVALID;
         return UA_STATUSCODE_GOOD;
     }
-    QString station_value = plugin->RDK->getParam(ActiveStationParameter);
+    QString station_value;
+    const QString station_param(ActiveStationParameter);
+    if (!rdk_call(plugin, [&](){ station_value = plugin->RDK->getParam(station_param); })){
+        return read_Unavailable(value);
+    }
     Str_2_Var(station_value, &value->value);
     value->hasValue = true;
     if(sourceTimeStamp) {
@@ -286,47 +344,67 @@ UA_StatusCode write_StationValue(void *h, const UA_NodeId nodeid, const UA_Varia
     QString stationvalue;
     Var_2_Str(data+0, stationvalue);
     ShowMessage(plugin, QObject::tr("Active Station value set to %1").arg(stationvalue));
-    plugin->RDK->setParam(ActiveStationParameter, stationvalue);
-    return UA_STATUSCODE_GOOD;
+
+    // Consecutive writes to the same parameter are coalesced (the latest value wins)
+    const QString station_param(ActiveStationParameter);
+    bool queued = plugin->Server->Commands->Post("param:" + station_param, [plugin, station_param, stationvalue](){
+        plugin->RDK->setParam(station_param, stationvalue);
+    });
+    return queued ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADSHUTDOWN;
 }
 
 #ifdef UA_ENABLE_METHODCALLS
 
 
+// Queue new joints for an item. The joints are set on the RoboDK thread and the station is rendered once per batch.
+// Joints queued for the same item are coalesced (the latest value wins). Joints not provided keep their current value.
+static UA_StatusCode queue_Joints(PluginOPCUA *plugin, Item item, const double *values, int nvalues, const QString &caller, const QString &name = QString()){
+    QVector<double> joint_values(values, values + qMin(nvalues, nDOFs_MAX));
+    bool queued = plugin->Server->Commands->PostMove("joints:" + QString::number((quintptr)item), [plugin, item, joint_values, caller, name]() mutable {
+        // The station may have changed since the name was looked up: resolve it again (a hash lookup unless the names were cleared)
+        if (!name.isEmpty()){
+            item = plugin->Server->Snapshot->ItemByName(plugin->RDK, name);
+        } else if (!plugin->RDK->Valid(item)){
+            item = nullptr;
+        }
+        if (item == nullptr){
+            ShowMessage(plugin, QObject::tr("%1: RoboDK Item provided is not valid").arg(caller));
+            return;
+        }
+        // Retrieve current robot joints and number of axes
+        double all_values[nDOFs_MAX];
+        tJoints current_joints = item->Joints();
+        current_joints.GetValues(all_values);
+        int joints_ndofs = current_joints.Length();
+        for (int i=0; i<joint_values.size(); i++){
+            all_values[i] = joint_values[i];
+        }
+        tJoints new_joints(all_values, joints_ndofs);
+        item->setJoints(new_joints);
+    });
+    return queued ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADSHUTDOWN;
+}
+
 static UA_StatusCode setJoints(void *h, const UA_NodeId objectId, size_t inputSize, const UA_Variant *input, size_t outputSize, UA_Variant *output) {
     PluginOPCUA *plugin = (PluginOPCUA*)h;
-    qDebug()<<"Setting joints";
     if (inputSize < 2){
         qDebug()<<"Input size: " << inputSize << "  Output size: " << outputSize;
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     }
+    // The item is validated on the RoboDK thread
     Item item;
-    if (!Var_2_Item(input + 0, &item, plugin->RDK)){
+    if (!Var_2_Item(input + 0, &item, nullptr)){
         qDebug()<<"Invalid item";
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     }
-    //if (!plugin->RDK->Valid(item)){
-    //        ShowMessage(plugin, QObject::tr("setJoints: RoboDK Item provided is not valid"));
-    //        return UA_STATUSCODE_BADARGUMENTSMISSING;
-    //}
 
     double joint_values[nDOFs_MAX];
-
-    // Retrieve current robot joints and number of axes
-    tJoints current_joints = item->Joints();
-    current_joints.GetValues(joint_values);
-    int joints_ndofs = current_joints.Length();
-
-
-    //Var_2_DoubleArray(input+1, joints, nDOFs_MAX);
-    if (!Var_2_DoubleArray(input+1, joint_values, nDOFs_MAX)){
+    UA_UInt32 nvalues = 0;
+    if (!Var_2_DoubleArray(input+1, joint_values, nDOFs_MAX, &nvalues)){
         qDebug()<<"Invalid double array";
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     }
-    tJoints new_joints(joint_values, joints_ndofs);
-    item->setJoints(new_joints);
-    plugin->RDK->Render();
-    return UA_STATUSCODE_GOOD;
+    return queue_Joints(plugin, item, joint_values, (int)nvalues, "setJoints");
 }
 static UA_StatusCode setJointsStr(void *h, const UA_NodeId objectId, size_t inputSize, const UA_Variant *input, size_t outputSize, UA_Variant *output) {
     PluginOPCUA *plugin = (PluginOPCUA*)h;
@@ -342,25 +420,28 @@ static UA_StatusCode setJointsStr(void *h, const UA_NodeId objectId, size_t inpu
     if (!Var_2_Str(input+1, str_joints)){
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     }
-    Item item = plugin->RDK->getItem(str_item);
-    if (!plugin->RDK->Valid(item)){ //if (!ItemValid(robot)){
-        ShowMessage(plugin, QObject::tr("setJointsStr: RoboDK Item provided is not valid"));
-        return UA_STATUSCODE_BADARGUMENTSMISSING;
-    }
     double joint_values[nDOFs_MAX];
-    tJoints current_joints = item->Joints();
-    current_joints.GetValues(joint_values);
-    int joints_ndofs = current_joints.Length();
     int numel = nDOFs_MAX;
     string_2_doubles(str_joints, joint_values, &numel);
     if (numel <= 0){
         ShowMessage(plugin, QObject::tr("setJointsStr: Invalid joints string"));
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     }
-    tJoints new_joints(joint_values, joints_ndofs);
-    item->setJoints(new_joints);
-    plugin->RDK->Render();
-    return UA_STATUSCODE_GOOD;
+    // Names already resolved don't wait for the RoboDK thread (the name is resolved again when the joints are set)
+    Item item = nullptr;
+    if (plugin->Server->Snapshot->CachedItem(str_item, &item)){
+        return queue_Joints(plugin, item, joint_values, numel, "setJointsStr", str_item);
+    }
+    if (!rdk_call(plugin, [&](){
+        item = plugin->Server->Snapshot->ItemByName(plugin->RDK, str_item);
+    })){
+        return SERVER_RUNNING ? UA_STATUSCODE_BADTIMEOUT : UA_STATUSCODE_BADSHUTDOWN;
+    }
+    if (item == nullptr){ //if (!ItemValid(robot)){
+        ShowMessage(plugin, QObject::tr("setJointsStr: RoboDK Item provided is not valid"));
+        return UA_STATUSCODE_BADARGUMENTSMISSING;
+    }
+    return queue_Joints(plugin, item, joint_values, numel, "setJointsStr");
 }
 
 static UA_StatusCode getJoints(void *h, const UA_NodeId objectId, size_t inputSize, const UA_Variant *input, size_t outputSize, UA_Variant *output) {
@@ -370,18 +451,25 @@ static UA_StatusCode getJoints(void *h, const UA_NodeId objectId, size_t inputSi
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     }
     Item item;
-    if (!Var_2_Item(input + 0, &item, plugin->RDK)){
+    if (!Var_2_Item(input + 0, &item, nullptr)){
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     }
-    if (!plugin->RDK->Valid(item)){
+    // Pending joints are set before this call, so the client reads the values it wrote
+    tJoints joints;
+    bool valid = false;
+    if (!rdk_call(plugin, [&](){
+        valid = plugin->RDK->Valid(item);
+        if (valid){
+            joints = item->Joints();
+        }
+    })){
+        return SERVER_RUNNING ? UA_STATUSCODE_BADTIMEOUT : UA_STATUSCODE_BADSHUTDOWN;
+    }
+    if (!valid){
         ShowMessage(plugin, QObject::tr("getJoints: RoboDK Item provided is not valid"));
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     }
-    double joints[nDOFs_MAX];
-    for (int i=0; i<nDOFs_MAX; i++){
-        joints[i] = 0;
-    }
-    DoubleArray_2_Var(item->Joints().Values(), nDOFs_MAX, output + 0);
+    DoubleArray_2_Var(joints.Values(), nDOFs_MAX, output + 0);
     return UA_STATUSCODE_GOOD;
 }
 
@@ -396,12 +484,22 @@ static UA_StatusCode getJointsStr(void *h, const UA_NodeId objectId, size_t inpu
     if (!Var_2_Str(input+0, str_item)){
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     }
-    Item item = plugin->RDK->getItem(str_item);
-    if (!plugin->RDK->Valid(item)){ //if (!ItemValid(item)){
+    tJoints joints;
+    bool valid = false;
+    if (!rdk_call(plugin, [&](){
+        // The item is valid if it was found (cached items are checked with the index of items)
+        Item item = plugin->Server->Snapshot->ItemByName(plugin->RDK, str_item);
+        valid = item != nullptr;
+        if (valid){
+            joints = item->Joints();
+        }
+    })){
+        return SERVER_RUNNING ? UA_STATUSCODE_BADTIMEOUT : UA_STATUSCODE_BADSHUTDOWN;
+    }
+    if (!valid){ //if (!ItemValid(item)){
         ShowMessage(plugin, QObject::tr("getJointsStr: RoboDK Item name provided is not valid"));
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     }
-    tJoints joints = item->Joints();
     QString str_joints = doubles_2_string(joints.ValuesD(), joints.Length(), 6, ", ");
     Str_2_Var(str_joints, output+0);
     return UA_STATUSCODE_GOOD;
@@ -415,22 +513,351 @@ static UA_StatusCode getItem(void *h, const UA_NodeId objectId, size_t inputSize
     if (!Var_2_Str(input + 0, name)){
         return UA_STATUSCODE_BADARGUMENTSMISSING;
     }
-    // Retrieve the RoboDK item as a pointer
-    Item item = plugin->RDK->getItem(name);
-    if (!plugin->RDK->Valid(item)){ //if (item == nullptr){
+    // Retrieve the RoboDK item as a pointer (the name cache avoids searching the station tree)
+    Item item = nullptr;
+    if (!rdk_call(plugin, [&](){
+        item = plugin->Server->Snapshot->ItemByName(plugin->RDK, name);
+    })){
+        return SERVER_RUNNING ? UA_STATUSCODE_BADTIMEOUT : UA_STATUSCODE_BADSHUTDOWN;
+    }
+    if (item == nullptr){
         ShowMessage(plugin, QObject::tr("getItem: RoboDK Item name provided does not exist"));
     }
     UA_UInt64 item_id = (UA_UInt64)item;
     Item_2_Var(item_id, output+0);
     return UA_STATUSCODE_GOOD;
 }
+
+// Set the joints of many robots or targets in one call. The joints are provided as a flattened matrix, one row per item.
+// The whole batch is applied on the RoboDK thread with a single render. Consecutive calls for the same items are coalesced.
+static UA_StatusCode setJointsMulti(void *h, const UA_NodeId objectId, size_t inputSize, const UA_Variant *input, size_t outputSize, UA_Variant *output) {
+    PluginOPCUA *plugin = (PluginOPCUA*)h;
+    if (inputSize < 2){
+        return UA_STATUSCODE_BADARGUMENTSMISSING;
+    }
+    QVector<Item> items;
+    QVector<double> joint_values;
+    if (!Var_2_ItemVector(input + 0, items) || !Var_2_DoubleVector(input + 1, joint_values)){
+        return UA_STATUSCODE_BADARGUMENTSMISSING;
+    }
+    if (items.isEmpty()){
+        return UA_STATUSCODE_GOOD;
+    }
+    // Number of joints per item (items with less axes ignore the extra values)
+    const int ndofs = joint_values.size() / items.size();
+    if (ndofs < 1 || ndofs > nDOFs_MAX || ndofs * items.size() != joint_values.size()){
+        ShowMessage(plugin, QObject::tr("setJointsMulti: Expected %1 x N joint values, %2 provided").arg(items.size()).arg(joint_values.size()));
+        return UA_STATUSCODE_BADARGUMENTSMISSING;
+    }
+    QStringList key;
+    for (Item item : items){
+        key.append(QString::number((quintptr)item));
+    }
+    bool queued = plugin->Server->Commands->PostMove("jointsmulti:" + key.join(","), [plugin, items, joint_values, ndofs](){
+        // Validate the items with the index of the station items (updated only if items were added or deleted)
+        plugin->Server->Snapshot->RefreshItems(plugin->RDK);
+        int ninvalid = 0;
+        for (int i=0; i<items.size(); i++){
+            Item item = items[i];
+            if (!plugin->Server->Snapshot->ItemValid((quintptr)item)){
+                ninvalid++;
+                continue;
+            }
+            double all_values[nDOFs_MAX];
+            tJoints current_joints = item->Joints();
+            current_joints.GetValues(all_values);
+            for (int j=0; j<ndofs; j++){
+                all_values[j] = joint_values[i*ndofs + j];
+            }
+            item->setJoints(tJoints(all_values, current_joints.Length()));
+        }
+        if (ninvalid > 0){
+            ShowMessage(plugin, QObject::tr("setJointsMulti: %1 RoboDK Items provided are not valid").arg(ninvalid));
+        }
+    });
+    return queued ? UA_STATUSCODE_GOOD : UA_STATUSCODE_BADSHUTDOWN;
+}
+
+// Get the joints of many robots or targets in one call, as a flattened matrix of nDOFs_MAX values per item.
+// The values of invalid items are set to NaN.
+static UA_StatusCode getJointsMulti(void *h, const UA_NodeId objectId, size_t inputSize, const UA_Variant *input, size_t outputSize, UA_Variant *output) {
+    PluginOPCUA *plugin = (PluginOPCUA*)h;
+    if (inputSize < 1 || outputSize < 1){
+        return UA_STATUSCODE_BADARGUMENTSMISSING;
+    }
+    QVector<Item> items;
+    if (!Var_2_ItemVector(input + 0, items)){
+        return UA_STATUSCODE_BADARGUMENTSMISSING;
+    }
+    QVector<double> joint_values(items.size() * nDOFs_MAX, 0.0);
+    int ninvalid = 0;
+    if (!rdk_call(plugin, [&](){
+        plugin->Server->Snapshot->RefreshItems(plugin->RDK);
+        for (int i=0; i<items.size(); i++){
+            double *values = joint_values.data() + i*nDOFs_MAX;
+            if (!plugin->Server->Snapshot->ItemValid((quintptr)items[i])){
+                ninvalid++;
+                std::fill(values, values + nDOFs_MAX, std::numeric_limits<double>::quiet_NaN());
+                continue;
+            }
+            items[i]->Joints().GetValues(values);
+        }
+    })){
+        return SERVER_RUNNING ? UA_STATUSCODE_BADTIMEOUT : UA_STATUSCODE_BADSHUTDOWN;
+    }
+    if (ninvalid > 0){
+        ShowMessage(plugin, QObject::tr("getJointsMulti: %1 RoboDK Items provided are not valid").arg(ninvalid));
+    }
+    DoubleArray_2_Var(joint_values.constData(), joint_values.size(), output + 0);
+    return UA_STATUSCODE_GOOD;
+}
+
+// Get the joint history of a robot (raw samples, oldest first) as timestamps and a flattened matrix of joints, one row per sample.
+// The history is kept by the snapshot: this call does not wait for the RoboDK thread.
+static UA_StatusCode getJointsHistory(void *h, const UA_NodeId objectId, size_t inputSize, const UA_Variant *input, size_t outputSize, UA_Variant *output) {
+    PluginOPCUA *plugin = (PluginOPCUA*)h;
+    if (inputSize < 4 || outputSize < 2){
+        return UA_STATUSCODE_BADARGUMENTSMISSING;
+    }
+    Item item;
+    if (!Var_2_Item(input + 0, &item, nullptr)
+            || input[1].type != &UA_TYPES[UA_TYPES_DATETIME] || input[2].type != &UA_TYPES[UA_TYPES_DATETIME]
+            || input[3].type != &UA_TYPES[UA_TYPES_UINT32]){
+        return UA_STATUSCODE_BADARGUMENTSMISSING;
+    }
+    const UA_DateTime start = *(UA_DateTime*)input[1].data;
+    const UA_DateTime end = *(UA_DateTime*)input[2].data;
+    const UA_UInt32 max_values = *(UA_UInt32*)input[3].data;
+
+    QVector<UA_DateTime> timestamps;
+    QVector<double> joint_values;
+    int ndofs = 0;
+    if (!plugin->Server->Snapshot->History((quintptr)item, start, end, (int)qMin<UA_UInt32>(max_values, INT_MAX), &timestamps, &joint_values, &ndofs)){
+        ShowMessage(plugin, QObject::tr("getJointsHistory: RoboDK Item provided is not a robot of the station"));
+        return UA_STATUSCODE_BADARGUMENTSMISSING;
+    }
+    UA_Variant_setArrayCopy(output + 0, timestamps.constData(), timestamps.size(), &UA_TYPES[UA_TYPES_DATETIME]);
+    DoubleArray_2_Var(joint_values.constData(), joint_values.size(), output + 1);
+    return UA_STATUSCODE_GOOD;
+}
 #endif
 
 
 
 
 
-int opc_server_thread(PluginOPCUA *pPlugin, unsigned short port) {
+
+
+//----------------------------------------------------------------------------------
+// Robot variables: one object per robot of the active station with the Joints, Pose and XYZRPW variables.
+// The variables are read from the snapshot cache, so reads and monitored items don't call the RoboDK API.
+
+/// Variables of a robot object
+enum {
+    ROBOT_JOINTS = 0,
+    ROBOT_POSE = 1,
+    ROBOT_XYZRPW = 2
+};
+
+/// Handle of a robot variable (data source)
+struct tRobotVariable {
+    opcua_snapshot *snapshot;
+    quintptr id;
+    int variable;
+};
+
+/// Nodes of one robot
+struct tRobotObject {
+    /// RoboDK item pointer of the robot
+    quintptr id;
+
+    /// Name of the robot when the nodes were added
+    QString robot_name;
+
+    /// Name of the object node (the robot name, made unique)
+    QString name;
+
+    /// String node IDs, in the order they were added
+    QList<QByteArray> node_ids;
+
+    /// Data source handles
+    QList<tRobotVariable*> variables;
+};
+
+/// Robot nodes of the address space (server thread)
+struct tRobotNodes {
+    PluginOPCUA *plugin;
+
+    /// Minimum sampling interval of the variables (ms)
+    double sampling_interval;
+
+    /// Generation of the robot list used to create the nodes
+    int generation;
+
+    /// Robots that have nodes
+    QList<tRobotObject> objects;
+};
+
+static UA_StatusCode read_RobotVariable(void *h, const UA_NodeId nodeid, UA_Boolean sourceTimeStamp, const UA_NumericRange *range, UA_DataValue *value) {
+    tRobotVariable *var = (tRobotVariable*)h;
+    if(range) {
+        value->hasStatus = true;
+        value->status = UA_STATUSCODE_BADINDEXRANGEINVALID;
+        return UA_STATUSCODE_GOOD;
+    }
+    tRobotSnapshot robot;
+    if (!var->snapshot->Robot(var->id, &robot)){
+        // The robot was deleted: the node will be removed shortly
+        value->hasStatus = true;
+        value->status = UA_STATUSCODE_BADNODEIDUNKNOWN;
+        return UA_STATUSCODE_GOOD;
+    }
+    switch (var->variable){
+    case ROBOT_JOINTS:
+        DoubleArray_2_Var(robot.joints.constData(), robot.joints.size(), &value->value);
+        break;
+    case ROBOT_POSE:
+        DoubleArray_2_Var(robot.pose, 16, &value->value);
+        break;
+    default:
+        DoubleArray_2_Var(robot.xyzrpw, 6, &value->value);
+        break;
+    }
+    value->hasValue = true;
+    if(sourceTimeStamp) {
+        value->hasSourceTimestamp = true;
+        value->sourceTimestamp = robot.timestamp;
+    }
+    return UA_STATUSCODE_GOOD;
+}
+
+static void add_RobotVariable(UA_Server *server, tRobotNodes *nodes, tRobotObject *object, const QByteArray &object_id, int variable){
+    static const char *names[] = {"Joints", "Pose", "XYZRPW"};
+    static const char *descriptions[] = {"Robot joints (deg or mm)",
+                                         "Pose of the TCP with respect to the robot reference (4x4 matrix, column major)",
+                                         "Pose of the TCP with respect to the robot reference as X,Y,Z,r,p,w (mm and deg)"};
+    UA_UInt32 dimensions[1] = {0};
+    dimensions[0] = variable == ROBOT_POSE ? 16 : 6;
+
+    tRobotVariable *var = new tRobotVariable;
+    var->snapshot = nodes->plugin->Server->Snapshot;
+    var->id = object->id;
+    var->variable = variable;
+    object->variables.append(var);
+
+    UA_DataSource ds_robot;
+    ds_robot.handle = var;
+    ds_robot.read = read_RobotVariable;
+    ds_robot.write = nullptr;
+    UA_VariableAttributes va_robot;
+    UA_VariableAttributes_init(&va_robot);
+    va_robot.description = UA_LOCALIZEDTEXT("en_US", descriptions[variable]);
+    va_robot.displayName = UA_LOCALIZEDTEXT("en_US", names[variable]);
+    va_robot.accessLevel = UA_ACCESSLEVELMASK_READ;
+    va_robot.minimumSamplingInterval = nodes->sampling_interval;
+    va_robot.dataType = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+    va_robot.valueRank = 1;
+    if (variable != ROBOT_JOINTS){
+        // The number of joints depends on the robot
+        va_robot.arrayDimensionsSize = 1;
+        va_robot.arrayDimensions = dimensions;
+    }
+    QByteArray variable_id = object_id + "." + names[variable];
+    UA_StatusCode status = UA_Server_addDataSourceVariableNode(server, UA_NODEID_STRING(1, variable_id.constData()), UA_NODEID_STRING(1, object_id.constData()),
+                                        UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT), UA_QUALIFIEDNAME(1, names[variable]),
+                                        UA_NODEID_NULL, va_robot, ds_robot, nullptr);
+    if (status == UA_STATUSCODE_GOOD){
+        object->node_ids.append(variable_id);
+    } else {
+        qDebug() << "Unable to add the OPC-UA node" << variable_id << UA_StatusCode_name(status);
+    }
+}
+
+static void delete_RobotObject(UA_Server *server, tRobotObject *object){
+    // Delete the variables before their objects
+    for (int i=object->node_ids.size()-1; i>=0; i--){
+        UA_Server_deleteNode(server, UA_NODEID_STRING(1, object->node_ids[i].constData()), true);
+    }
+    object->node_ids.clear();
+    qDeleteAll(object->variables);
+    object->variables.clear();
+}
+
+static void add_RobotObject(UA_Server *server, tRobotNodes *nodes, tRobotObject *object){
+    QByteArray name_utf8 = object->name.toUtf8();
+    QByteArray object_id = "Robots." + name_utf8;
+    UA_ObjectAttributes oa_robot;
+    UA_ObjectAttributes_init(&oa_robot);
+    oa_robot.description = UA_LOCALIZEDTEXT("en_US", "RoboDK robot");
+    oa_robot.displayName = UA_LOCALIZEDTEXT("en_US", name_utf8.constData());
+    UA_StatusCode status = UA_Server_addObjectNode(server, UA_NODEID_STRING(1, object_id.constData()), UA_NODEID_STRING(1, "Robots"),
+                            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES), UA_QUALIFIEDNAME(1, name_utf8.constData()),
+                            UA_NODEID_NUMERIC(0, UA_NS0ID_BASEOBJECTTYPE), oa_robot, nullptr, nullptr);
+    if (status != UA_STATUSCODE_GOOD){
+        qDebug() << "Unable to add the OPC-UA node" << object_id << UA_StatusCode_name(status);
+        return;
+    }
+    object->node_ids.append(object_id);
+    add_RobotVariable(server, nodes, object, object_id, ROBOT_JOINTS);
+    add_RobotVariable(server, nodes, object, object_id, ROBOT_POSE);
+    add_RobotVariable(server, nodes, object, object_id, ROBOT_XYZRPW);
+}
+
+// Repeated job of the server: add and remove the robot nodes when robots are added, deleted or renamed.
+// The nodes of the other robots are kept, so the monitored items of the clients are not affected.
+static void update_RobotNodes(UA_Server *server, void *data){
+    tRobotNodes *nodes = (tRobotNodes*)data;
+    int generation = 0;
+    QList<tRobotSnapshot> robots = nodes->plugin->Server->Snapshot->Robots(&generation);
+    if (generation == nodes->generation){
+        return;
+    }
+    nodes->generation = generation;
+
+    // Keep the nodes of the robots that are still in the station with the same name
+    QSet<quintptr> kept;
+    QStringList names;
+    for (int i=nodes->objects.size()-1; i>=0; i--){
+        tRobotObject &object = nodes->objects[i];
+        bool keep = false;
+        for (const tRobotSnapshot &robot : robots){
+            if (robot.id == object.id){
+                keep = robot.name == object.robot_name;
+                break;
+            }
+        }
+        if (keep){
+            kept.insert(object.id);
+            names.append(object.name);
+        } else {
+            delete_RobotObject(server, &object);
+            nodes->objects.removeAt(i);
+        }
+    }
+
+    for (const tRobotSnapshot &robot : robots){
+        if (kept.contains(robot.id)){
+            continue;
+        }
+        // Node IDs are based on the robot name (Robots.<name>.Joints) so that clients can keep them between sessions
+        QString name(robot.name);
+        for (int i=2; names.contains(name); i++){
+            name = QString("%1 (%2)").arg(robot.name).arg(i);
+        }
+        names.append(name);
+
+        tRobotObject object;
+        object.id = robot.id;
+        object.robot_name = robot.name;
+        object.name = name;
+        nodes->objects.append(object);
+        add_RobotObject(server, nodes, &nodes->objects.last());
+    }
+}
+
+
+
+int opc_server_thread(PluginOPCUA *pPlugin, unsigned short port, QString version, double sampling_interval) {
     SERVER_RUNNING_PORT = port;
 
     UA_ServerNetworkLayer nl = UA_ServerNetworkLayerTCP(UA_ConnectionConfig_standard, port);
@@ -438,14 +865,18 @@ int opc_server_thread(PluginOPCUA *pPlugin, unsigned short port) {
     config.networkLayers = &nl;
     config.networkLayersSize = 1;
 
+    // Allow monitored items to sample the robot variables as fast as the configured interval
+    config.samplingIntervalLimits.min = sampling_interval;
+    config.publishingIntervalLimits.min = qMin(config.publishingIntervalLimits.min, sampling_interval);
+
     // load certificate
     config.serverCertificate = loadCertificate();
     config.usernamePasswordLogins;
 
     UA_Server *server = UA_Server_new(config);
 
-    // Add the RoboDK version as a static variable node to the server
-    QString RoboDKVersion = pPlugin->RDK->Version();
+    // Add the RoboDK version as a static variable node to the server (retrieved on the RoboDK thread)
+    QString RoboDKVersion = version;
     UA_VariableAttributes rdkver;
     UA_VariableAttributes_init(&rdkver);
     rdkver.description = UA_LOCALIZEDTEXT("en_US", RoboDKVersion.toUtf8().constData());
@@ -719,8 +1150,135 @@ int opc_server_thread(PluginOPCUA *pPlugin, unsigned short port) {
         pPlugin, // plugin handle
         1, &inItem, 1, &outItem, nullptr);
 
+
+    //////////////////////////////////////////////////////////////////
+    /// \brief setJointsMulti and getJointsMulti: move or read many items with one call
+    ///
+    UA_Argument inMulti[2];
+    UA_Argument_init(&inMulti[0]);
+    UA_Argument_init(&inMulti[1]);
+    inMulti[0].dataType = UA_TYPES[UA_TYPES_UINT64].typeId;
+    inMulti[0].description = UA_LOCALIZEDTEXT("en_US", "RoboDK Item IDs");
+    inMulti[0].name = UA_STRING("Item IDs");
+    inMulti[0].arrayDimensionsSize = 0;
+    inMulti[0].arrayDimensions = nullptr;
+    inMulti[0].valueRank = 1;
+
+    inMulti[1].dataType = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+    inMulti[1].description = UA_LOCALIZEDTEXT("en_US", "Joint Values (deg), the same number of joints for each item, one item after the other");
+    inMulti[1].name = UA_STRING("Joints");
+    inMulti[1].arrayDimensionsSize = 0;
+    inMulti[1].arrayDimensions = nullptr;
+    inMulti[1].valueRank = 1;
+
+    UA_MethodAttributes methodSetJointsMulti;
+    UA_MethodAttributes_init(&methodSetJointsMulti);
+    methodSetJointsMulti.displayName = UA_LOCALIZEDTEXT("en_US", "setJointsMulti");
+    methodSetJointsMulti.executable = true;
+    methodSetJointsMulti.userExecutable = true;
+    UA_Server_addMethodNode(server, UA_NODEID_NUMERIC(1, 2003),
+        UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+        UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+        UA_QUALIFIEDNAME(1, "setJointsMulti"), methodSetJointsMulti,
+        &setJointsMulti, // callback function
+        pPlugin, // plugin handle
+        2, inMulti, 0, nullptr, nullptr);
+
+    UA_Argument outGetJointsMulti;
+    UA_Argument_init(&outGetJointsMulti);
+    outGetJointsMulti.dataType = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+    outGetJointsMulti.description = UA_LOCALIZEDTEXT("en_US", "Joint Values (deg), 12 values for each item, one item after the other");
+    outGetJointsMulti.name = UA_STRING("Joints");
+    outGetJointsMulti.arrayDimensionsSize = 0;
+    outGetJointsMulti.arrayDimensions = nullptr;
+    outGetJointsMulti.valueRank = 1;
+
+    UA_MethodAttributes methodGetJointsMulti;
+    UA_MethodAttributes_init(&methodGetJointsMulti);
+    methodGetJointsMulti.displayName = UA_LOCALIZEDTEXT("en_US", "getJointsMulti");
+    methodGetJointsMulti.executable = true;
+    methodGetJointsMulti.userExecutable = true;
+    UA_Server_addMethodNode(server, UA_NODEID_NUMERIC(1, 1003),
+        UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+        UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+        UA_QUALIFIEDNAME(1, "getJointsMulti"), methodGetJointsMulti,
+        &getJointsMulti, // callback function
+        pPlugin, // plugin handle
+        1, &inMulti[0], 1, &outGetJointsMulti, nullptr);
+
+
+    //////////////////////////////////////////////////////////////////
+    /// \brief getJointsHistory: raw joint samples of a robot in a time range
+    ///
+    UA_Argument inHistory[4];
+    for (int i=0; i<4; i++){
+        UA_Argument_init(&inHistory[i]);
+        inHistory[i].arrayDimensionsSize = 0;
+        inHistory[i].arrayDimensions = nullptr;
+        inHistory[i].valueRank = -1;
+    }
+    inHistory[0].dataType = UA_TYPES[UA_TYPES_UINT64].typeId;
+    inHistory[0].description = UA_LOCALIZEDTEXT("en_US", "RoboDK Item ID of a robot");
+    inHistory[0].name = UA_STRING("Item ID");
+    inHistory[1].dataType = UA_TYPES[UA_TYPES_DATETIME].typeId;
+    inHistory[1].description = UA_LOCALIZEDTEXT("en_US", "Time of the first sample (0 for the oldest sample)");
+    inHistory[1].name = UA_STRING("Start time");
+    inHistory[2].dataType = UA_TYPES[UA_TYPES_DATETIME].typeId;
+    inHistory[2].description = UA_LOCALIZEDTEXT("en_US", "Time of the last sample (0 for the latest sample)");
+    inHistory[2].name = UA_STRING("End time");
+    inHistory[3].dataType = UA_TYPES[UA_TYPES_UINT32].typeId;
+    inHistory[3].description = UA_LOCALIZEDTEXT("en_US", "Maximum number of samples, the most recent ones are returned (0 for no limit)");
+    inHistory[3].name = UA_STRING("Max values");
+
+    UA_Argument outHistory[2];
+    UA_Argument_init(&outHistory[0]);
+    UA_Argument_init(&outHistory[1]);
+    outHistory[0].dataType = UA_TYPES[UA_TYPES_DATETIME].typeId;
+    outHistory[0].description = UA_LOCALIZEDTEXT("en_US", "Time of each sample, oldest first");
+    outHistory[0].name = UA_STRING("Timestamps");
+    outHistory[0].valueRank = 1;
+    outHistory[1].dataType = UA_TYPES[UA_TYPES_DOUBLE].typeId;
+    outHistory[1].description = UA_LOCALIZEDTEXT("en_US", "Joint Values (deg) of each sample, one sample after the other");
+    outHistory[1].name = UA_STRING("Joints");
+    outHistory[1].valueRank = 1;
+
+    UA_MethodAttributes methodHistory;
+    UA_MethodAttributes_init(&methodHistory);
+    methodHistory.displayName = UA_LOCALIZEDTEXT("en_US", "getJointsHistory");
+    methodHistory.executable = true;
+    methodHistory.userExecutable = true;
+    UA_Server_addMethodNode(server, UA_NODEID_NUMERIC(1, 1004),
+        UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+        UA_NODEID_NUMERIC(0, UA_NS0ID_HASCOMPONENT),
+        UA_QUALIFIEDNAME(1, "getJointsHistory"), methodHistory,
+        &getJointsHistory, // callback function
+        pPlugin, // plugin handle
+        4, inHistory, 2, outHistory, nullptr);
+
 #endif
 
+    // Add a folder with one object per robot of the active station
+    UA_ObjectAttributes oa_robots;
+    UA_ObjectAttributes_init(&oa_robots);
+    oa_robots.description = UA_LOCALIZEDTEXT("en_US", "Robots of the active RoboDK station");
+    oa_robots.displayName = UA_LOCALIZEDTEXT("en_US", "Robots");
+    UA_Server_addObjectNode(server, UA_NODEID_STRING(1, "Robots"), UA_NODEID_NUMERIC(0, UA_NS0ID_OBJECTSFOLDER),
+                            UA_NODEID_NUMERIC(0, UA_NS0ID_ORGANIZES), UA_QUALIFIEDNAME(1, "Robots"),
+                            UA_NODEID_NUMERIC(0, UA_NS0ID_FOLDERTYPE), oa_robots, nullptr, nullptr);
+
+    tRobotNodes robot_nodes;
+    robot_nodes.plugin = pPlugin;
+    robot_nodes.sampling_interval = sampling_interval;
+    robot_nodes.generation = -1;
+    update_RobotNodes(server, &robot_nodes);
+
+    // Check for new or deleted robots (the node management functions must run on the server thread)
+    UA_Job job_robots;
+    job_robots.type = UA_Job::UA_JOBTYPE_METHODCALL;
+    job_robots.job.methodCall.data = &robot_nodes;
+    job_robots.job.methodCall.method = update_RobotNodes;
+    UA_Server_addRepeatedJob(server, job_robots, 500, nullptr);
+
     // Run server until we stop the flag
     SERVER_RUNNING = UA_TRUE;
     ShowMessage(pPlugin, QObject::tr("RoboDK's OPC UA server running on port %1").arg(port));
@@ -746,6 +1304,9 @@ int opc_server_thread(PluginOPCUA *pPlugin, unsigned short port) {
     // cleanup
     UA_Server_delete(server);
     nl.deleteMembers(&nl);
+    for (const tRobotObject &object : robot_nodes.objects){
+        qDeleteAll(object.variables);
+    }
 
     SERVER_RUNNING_PORT = -1;
     SERVER_RUNNING = UA_FALSE;
@@ -4,6 +4,8 @@
 #include <QObject>
 
 class PluginOPCUA;
+class opcua_commandqueue;
+class opcua_snapshot;
 
 /// This class creates an instance of an OPC-UA server to interface with RoboDK
 class opcua_server : public QObject
@@ -39,11 +41,23 @@ public:
     /// Start the OPC-UA server on startup
     bool AutoStart;
 
+    /// Fastest sampling interval of the robot variables for monitored items (in ms)
+    double SamplingInterval;
+
+    /// Number of joint samples kept per robot for getJointsHistory
+    int HistorySize;
+
 public:
 
     /// Pointer to the RoboDK plugin interface
     PluginOPCUA *pPlugin;
 
+    /// Queue of RoboDK API calls from the server thread (executed on the RoboDK thread)
+    opcua_commandqueue *Commands;
+
+    /// Robot values published by the server (the RoboDK thread refreshes them once per frame)
+    opcua_snapshot *Snapshot;
+
 };
 
 #endif // OPCUA_SERVER_H
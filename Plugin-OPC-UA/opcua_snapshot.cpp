@@ -0,0 +1,255 @@
+#include "opcua_snapshot.h"
+
+#include "irobodk.h"
+#include "iitem.h"
+
+#include <QMutexLocker>
+
+#include <algorithm>
+
+
+opcua_snapshot::opcua_snapshot(){
+    generation = 0;
+    history_size = 3000;
+    robots_invalid = true;
+    values_invalid = true;
+    items_invalid = true;
+}
+
+void opcua_snapshot::InvalidateRobots(){
+    robots_invalid = true;
+    values_invalid = true;
+    items_invalid = true;
+
+    // The names are cleared right away so that the server thread never uses a name resolved before this change
+    QMutexLocker lock(&mutex);
+    item_names.clear();
+}
+
+void opcua_snapshot::InvalidateValues(){
+    values_invalid = true;
+}
+
+void opcua_snapshot::Refresh(RoboDK *rdk){
+    if (!robots_invalid && !values_invalid){
+        return;
+    }
+
+    // Retrieve the values without holding the lock (the server thread keeps reading the previous values)
+    QList<tRobotSnapshot> updated;
+    if (robots_invalid){
+        QList<Item> items = rdk->getItemList(IItem::ITEM_TYPE_ROBOT);
+        for (Item item : items){
+            tRobotSnapshot robot;
+            robot.id = (quintptr)item;
+            robot.name = item->Name();
+            updated.append(robot);
+        }
+    } else {
+        QMutexLocker lock(&mutex);
+        updated = robots;
+    }
+
+    const UA_DateTime now = UA_DateTime_now();
+    for (tRobotSnapshot &robot : updated){
+        Item item = (Item)robot.id;
+        tJoints joints = item->Joints();
+        robot.joints.resize(joints.Length());
+        for (int i=0; i<joints.Length(); i++){
+            robot.joints[i] = joints.ValuesD()[i];
+        }
+        Mat pose = item->Pose();
+        for (int i=0; i<16; i++){
+            robot.pose[i] = pose.ValuesD()[i];
+        }
+        pose.ToXYZRPW(robot.xyzrpw);
+        robot.timestamp = now;
+    }
+
+    QMutexLocker lock(&mutex);
+    if (robots_invalid){
+        bool same_robots = updated.size() == robots.size();
+        for (int i=0; same_robots && i<updated.size(); i++){
+            same_robots = updated[i].id == robots[i].id && updated[i].name == robots[i].name;
+        }
+        if (!same_robots){
+            generation++;
+        }
+
+        // Allocate the history of the new robots and remove the history of the deleted robots
+        QHash<quintptr, tJointHistory> robots_history;
+        for (const tRobotSnapshot &robot : updated){
+            if (history.contains(robot.id)){
+                robots_history.insert(robot.id, history.value(robot.id));
+                continue;
+            }
+            tJointHistory &robot_history = robots_history[robot.id];
+            robot_history.ndofs = robot.joints.size();
+            robot_history.first = 0;
+            robot_history.count = 0;
+            robot_history.timestamps.resize(history_size);
+            robot_history.joints.resize(history_size * RDK_SIZE_JOINTS_MAX);
+        }
+        history.swap(robots_history);
+    }
+    for (const tRobotSnapshot &robot : updated){
+        add_history(robot);
+    }
+    robots = updated;
+    robots_invalid = false;
+    values_invalid = false;
+}
+
+void opcua_snapshot::add_history(const tRobotSnapshot &robot){
+    QHash<quintptr, tJointHistory>::iterator it = history.find(robot.id);
+    if (it == history.end() || history_size <= 0){
+        return;
+    }
+    tJointHistory &robot_history = it.value();
+    const int ndofs = qMin(robot.joints.size(), RDK_SIZE_JOINTS_MAX);
+    if (robot_history.count > 0 && ndofs == robot_history.ndofs){
+        // Only store the joints that changed
+        const int last = (robot_history.first + robot_history.count - 1) % history_size;
+        if (std::equal(robot.joints.constBegin(), robot.joints.constBegin() + ndofs, robot_history.joints.constData() + last * RDK_SIZE_JOINTS_MAX)){
+            return;
+        }
+    }
+    robot_history.ndofs = ndofs;
+    int next;
+    if (robot_history.count < history_size){
+        next = (robot_history.first + robot_history.count) % history_size;
+        robot_history.count++;
+    } else {
+        // The buffer is full: overwrite the oldest sample
+        next = robot_history.first;
+        robot_history.first = (robot_history.first + 1) % history_size;
+    }
+    robot_history.timestamps[next] = robot.timestamp;
+    std::copy(robot.joints.constBegin(), robot.joints.constBegin() + ndofs, robot_history.joints.begin() + next * RDK_SIZE_JOINTS_MAX);
+}
+
+void opcua_snapshot::SetHistorySize(int samples){
+    QMutexLocker lock(&mutex);
+    history_size = qMax(0, samples);
+    history.clear();
+    robots_invalid = true;
+    values_invalid = true;
+}
+
+bool opcua_snapshot::History(quintptr id, UA_DateTime start, UA_DateTime end, int max_values, QVector<UA_DateTime> *timestamps, QVector<double> *joints, int *ndofs){
+    QMutexLocker lock(&mutex);
+    QHash<quintptr, tJointHistory>::const_iterator it = history.constFind(id);
+    if (it == history.constEnd()){
+        return false;
+    }
+    const tJointHistory &robot_history = it.value();
+    *ndofs = robot_history.ndofs;
+    timestamps->clear();
+    joints->clear();
+    auto in_range = [&](int id_sample){
+        const UA_DateTime time = robot_history.timestamps[id_sample];
+        return (start == 0 || time >= start) && (end == 0 || time <= end);
+    };
+
+    // Skip the oldest samples of the range if there are more than max_values
+    int skip = 0;
+    if (max_values > 0){
+        for (int i=0; i<robot_history.count; i++){
+            if (in_range((robot_history.first + i) % history_size)){
+                skip++;
+            }
+        }
+        skip = qMax(0, skip - max_values);
+    }
+    for (int i=0; i<robot_history.count; i++){
+        const int id_sample = (robot_history.first + i) % history_size;
+        if (!in_range(id_sample)){
+            continue;
+        }
+        if (skip > 0){
+            skip--;
+            continue;
+        }
+        timestamps->append(robot_history.timestamps[id_sample]);
+        const double *values = robot_history.joints.constData() + id_sample * RDK_SIZE_JOINTS_MAX;
+        for (int j=0; j<robot_history.ndofs; j++){
+            joints->append(values[j]);
+        }
+    }
+    return true;
+}
+
+QList<tRobotSnapshot> opcua_snapshot::Robots(int *list_generation){
+    QMutexLocker lock(&mutex);
+    if (list_generation != nullptr){
+        *list_generation = generation;
+    }
+    return robots;
+}
+
+int opcua_snapshot::Generation(){
+    QMutexLocker lock(&mutex);
+    return generation;
+}
+
+bool opcua_snapshot::Robot(quintptr id, tRobotSnapshot *robot){
+    QMutexLocker lock(&mutex);
+    for (const tRobotSnapshot &cached : robots){
+        if (cached.id == id){
+            *robot = cached;
+            return true;
+        }
+    }
+    return false;
+}
+
+void opcua_snapshot::RefreshItems(RoboDK *rdk){
+    if (!items_invalid){
+        return;
+    }
+    QSet<quintptr> station_items;
+    QList<Item> item_list = rdk->getItemList();
+    for (Item item : item_list){
+        station_items.insert((quintptr)item);
+    }
+    QMutexLocker lock(&mutex);
+    items.swap(station_items);
+    items_invalid = false;
+}
+
+bool opcua_snapshot::ItemValid(quintptr id){
+    QMutexLocker lock(&mutex);
+    return items.contains(id);
+}
+
+Item opcua_snapshot::ItemByName(RoboDK *rdk, const QString &name){
+    // The index of items and the names are updated after EventChanged (items added, deleted or renamed)
+    RefreshItems(rdk);
+    {
+        QMutexLocker lock(&mutex);
+        QHash<QString, Item>::const_iterator it = item_names.constFind(name);
+        if (it != item_names.constEnd() && items.contains((quintptr)it.value())){
+            return it.value();
+        }
+    }
+
+    // Search the station tree without holding the lock. Names that are not found are not cached: an item may get this name later.
+    Item item = rdk->getItem(name);
+    QMutexLocker lock(&mutex);
+    if (item == nullptr || !items.contains((quintptr)item)){
+        item_names.remove(name);
+        return nullptr;
+    }
+    item_names.insert(name, item);
+    return item;
+}
+
+bool opcua_snapshot::CachedItem(const QString &name, Item *item){
+    QMutexLocker lock(&mutex);
+    QHash<QString, Item>::const_iterator it = item_names.constFind(name);
+    if (it == item_names.constEnd() || !items.contains((quintptr)it.value())){
+        return false;
+    }
+    *item = it.value();
+    return true;
+}
@@ -0,0 +1,143 @@
+#ifndef OPCUA_SNAPSHOT_H
+#define OPCUA_SNAPSHOT_H
+
+#include <QString>
+#include <QList>
+#include <QVector>
+#include <QSet>
+#include <QHash>
+#include <QMutex>
+
+#include "robodktypes.h"
+#include "open62541.h"
+
+
+/// Values of a robot copied from the RoboDK thread
+struct tRobotSnapshot {
+    /// RoboDK item pointer (used as the robot ID)
+    quintptr id;
+
+    /// Name of the robot in the station tree
+    QString name;
+
+    /// Robot joints (deg or mm)
+    QVector<double> joints;
+
+    /// Pose of the robot TCP with respect to the robot reference frame (4x4 matrix, column major, as in the RoboDK API)
+    double pose[16];
+
+    /// Same pose as X, Y, Z, r, p, w (mm and deg)
+    double xyzrpw[6];
+
+    /// Time the values were retrieved from RoboDK
+    UA_DateTime timestamp;
+};
+
+
+/// History of the joints of a robot: ring buffer with a fixed capacity, allocated once per robot.
+/// A sample is added when the joints change, so the history covers a longer time when the robot is idle.
+struct tJointHistory {
+    /// Number of joints of the robot
+    int ndofs;
+
+    /// Position of the oldest sample
+    int first;
+
+    /// Number of samples in the buffer
+    int count;
+
+    /// Time of each sample (capacity)
+    QVector<UA_DateTime> timestamps;
+
+    /// Joints of each sample (capacity x RDK_SIZE_JOINTS_MAX)
+    QVector<double> joints;
+};
+
+
+/// Cache of the robot values published by the OPC-UA server.
+/// The RoboDK thread refreshes the cache once per frame and the server thread reads it,
+/// so the OPC-UA reads and monitored items don't call the RoboDK API.
+class opcua_snapshot
+{
+public:
+    opcua_snapshot();
+
+    /// The list of robots must be retrieved again: items were added or deleted or the station changed (RoboDK thread)
+    void InvalidateRobots();
+
+    /// The robot values must be retrieved again: something moved (RoboDK thread)
+    void InvalidateValues();
+
+    /// Update the cache if it was invalidated since the last call (RoboDK thread, called once per frame)
+    void Refresh(RoboDK *rdk);
+
+    /// Copy the list of robots and their values (server thread)
+    /// \param list_generation set to the generation of the robot list, which changes every time a robot is added, deleted or renamed
+    QList<tRobotSnapshot> Robots(int *list_generation = nullptr);
+
+    /// Generation of the robot list (server thread)
+    int Generation();
+
+    /// Copy the values of one robot (server thread). Returns false if the robot is no longer in the station.
+    bool Robot(quintptr id, tRobotSnapshot *robot);
+
+    /// Set the number of samples kept in the joint history of each robot and clear the history (RoboDK thread)
+    void SetHistorySize(int samples);
+
+    ///
+    /// \brief Copy the joint history of a robot, oldest sample first (server thread)
+    /// \param start, end time range of the samples (inclusive). The range is not bounded if the value is 0.
+    /// \param max_values maximum number of samples returned (the most recent ones of the range), 0 for no limit
+    /// \param ndofs set to the number of joints per sample
+    /// \return false if the robot is not in the station
+    ///
+    bool History(quintptr id, UA_DateTime start, UA_DateTime end, int max_values, QVector<UA_DateTime> *timestamps, QVector<double> *joints, int *ndofs);
+
+    /// Update the index of the station items if items were added or deleted since the last call (RoboDK thread)
+    void RefreshItems(RoboDK *rdk);
+
+    /// Returns true if the item is in the active station, using the index of items instead of the RoboDK API (call RefreshItems first)
+    bool ItemValid(quintptr id);
+
+    /// Item of the active station with the given name (RoboDK thread). The station tree is only searched if the name is not cached:
+    /// the names are cleared by InvalidateRobots (EventChanged) and cached items are checked with the index of items, without calling RoboDK.
+    /// Returns nullptr if there is no item with this name (this is not cached).
+    Item ItemByName(RoboDK *rdk, const QString &name);
+
+    /// Look up a name in the cache of ItemByName (server thread). Returns false if the name is not cached or the item is not in the index.
+    /// The station may change before the item is used: resolve the name again with ItemByName on the RoboDK thread before using it.
+    bool CachedItem(const QString &name, Item *item);
+
+private:
+    /// Add the current joints of a robot to its history (the mutex must be locked). Nothing is allocated.
+    void add_history(const tRobotSnapshot &robot);
+
+private:
+    /// Protects the robot list, the generation and the item caches
+    QMutex mutex;
+
+    /// Robots of the active station and their values
+    QList<tRobotSnapshot> robots;
+
+    /// Generation of the robot list
+    int generation;
+
+    /// Joint history of each robot
+    QHash<quintptr, tJointHistory> history;
+
+    /// Capacity of the joint history of each robot
+    int history_size;
+
+    /// Index of all the items of the active station
+    QSet<quintptr> items;
+
+    /// Items found by name. Cleared when items are added, deleted or renamed (EventChanged).
+    QHash<QString, Item> item_names;
+
+    /// Pending updates (RoboDK thread only)
+    bool robots_invalid;
+    bool values_invalid;
+    bool items_invalid;
+};
+
+#endif // OPCUA_SNAPSHOT_H
@@ -8,7 +8,7 @@ bool Var_2_Item(const UA_Variant *var, IItem **item, RoboDK *rdk){
         return false;
     }
     *item = (IItem*) ((UA_UInt64*)var->data)[0];
-    if (!rdk->Valid(*item)){
+    if (rdk != nullptr && !rdk->Valid(*item)){
         qDebug()<<"Item ID does not exist: " << *item;
         *item = nullptr;
         return false;
@@ -42,7 +42,7 @@ bool Var_2_Str(const UA_Variant *var, QString &str){
     qDebug() << "Received array: " << str;
     return true;
 }
-bool Var_2_DoubleArray(const UA_Variant *var, double *values, UA_UInt32 maxlen){
+bool Var_2_DoubleArray(const UA_Variant *var, double *values, UA_UInt32 maxlen, UA_UInt32 *count){
     if (var->type->typeId.identifier.numeric != UA_TYPES[UA_TYPES_DOUBLE].typeId.identifier.numeric){
         //qDebug()<<"Invalid array type or dimension: " << var->type;
         return false;
@@ -51,9 +51,36 @@ bool Var_2_DoubleArray(const UA_Variant *var, double *values, UA_UInt32 maxlen){
     for (unsigned int i=0; i<size; i++){
         values[i] = ((UA_Double*) var->data)[i];
     }
+    if (count != nullptr){
+        *count = size;
+    }
     //qDebug() << "Received number: " << str;
     return true;
 }
+bool Var_2_DoubleVector(const UA_Variant *var, QVector<double> &values){
+    if (var->type->typeId.identifier.numeric != UA_TYPES[UA_TYPES_DOUBLE].typeId.identifier.numeric){
+        return false;
+    }
+    // a scalar is an array of one value
+    size_t size = UA_Variant_isScalar(var) ? 1 : var->arrayLength;
+    values.resize((int)size);
+    for (size_t i=0; i<size; i++){
+        values[(int)i] = ((UA_Double*) var->data)[i];
+    }
+    return true;
+}
+bool Var_2_ItemVector(const UA_Variant *var, QVector<IItem*> &items){
+    if (var->type->typeId.identifier.numeric != UA_TYPES[UA_TYPES_UINT64].typeId.identifier.numeric){
+        qDebug()<<"Invalid item array type: " << var->type;
+        return false;
+    }
+    size_t size = UA_Variant_isScalar(var) ? 1 : var->arrayLength;
+    items.resize((int)size);
+    for (size_t i=0; i<size; i++){
+        items[(int)i] = (IItem*) ((UA_UInt64*)var->data)[i];
+    }
+    return true;
+}
 
 //-------------------------------------------------------------------------
 /// Helper function to convert a pointer to an OPC-UA pointer
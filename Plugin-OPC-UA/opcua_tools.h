@@ -3,13 +3,14 @@
 
 
 #include <QString>
+#include <QVector>
 #include "robodktools.h"
 
 #include "open62541.h"
 
 
 
-/// Convert an OPC-UA Variant to an item pointer
+/// Convert an OPC-UA Variant to an item pointer. The item is not validated if rdk is null (the RoboDK API must be used from the RoboDK thread)
 bool Var_2_Item(const UA_Variant *var, IItem **item, RoboDK *rdk);
 
 /// Convert an OPC-UA variant to an int
@@ -21,8 +22,14 @@ bool Var_2_Double(const UA_Variant *var, UA_Double *value);
 /// Convert an OPC-UA variant to a QString
 bool Var_2_Str(const UA_Variant *var, QString &str);
 
-/// Convert an OPC-UA variant to a double array
-bool Var_2_DoubleArray(const UA_Variant *var, double *values, UA_UInt32 maxlen);
+/// Convert an OPC-UA variant to a double array (count is set to the number of values retrieved)
+bool Var_2_DoubleArray(const UA_Variant *var, double *values, UA_UInt32 maxlen, UA_UInt32 *count=nullptr);
+
+/// Convert an OPC-UA variant (array of any length) to a vector of doubles
+bool Var_2_DoubleVector(const UA_Variant *var, QVector<double> &values);
+
+/// Convert an OPC-UA variant (array of any length) to a list of item pointers. The items are not validated.
+bool Var_2_ItemVector(const UA_Variant *var, QVector<IItem*> &items);
 
 
 //-------------------------------------------------------------------------
@@ -4,6 +4,7 @@
 #include "iitem.h"
 
 #include "formopcsettings.h"
+#include "opcua_snapshot.h"
 
 #include <QMainWindow>
 #include <QToolBar>
@@ -26,7 +27,7 @@
 #else
 #include <unistd.h>
 void Sleep(unsigned int milliseconds) {
-    sleep(milliseconds);
+    usleep(milliseconds * 1000);
 }
 #endif
 
@@ -239,6 +240,14 @@ QString PluginOPCUA::PluginCommand(const QString &command, const QString &value)
         // Start the OPC-UA server, unless 0 is passed as the value
         callback_StartServer(!value.contains("0"));
         return "Done";
+    } else if (command.compare("ServerPort", Qt::CaseInsensitive) == 0){
+        // Set the port of the server (used the next time the server starts) and return the current port
+        int port = value.toInt();
+        if (port > 0 && port <= 0xFFFF){
+            Server->Port = (unsigned short)port;
+            emit UpdateForm();
+        }
+        return QString::number(Server->Port);
     } else if (command.compare("ClientBrowse", Qt::CaseInsensitive) == 0){
         // Use an OPC-UA Client to connect to the server. A value can be optionally provided to override the Endpoint URL
         // Trick: Create a macro such as the following one to update the variables automatically every 100 ms
@@ -263,6 +272,11 @@ QString PluginOPCUA::PluginCommand(const QString &command, const QString &value)
             Client->Browse(false);
         }
         return "Done";
+    } else if (command.compare("ClientStats", Qt::CaseInsensitive) == 0){
+        // Return the statistics of the client subscription (changes per node and publish latency)
+        QString stats = Client->SubscriptionStats();
+        LogAdd(stats);
+        return stats;
     }
     return "";
 }
@@ -274,21 +288,28 @@ void PluginOPCUA::PluginEvent(TypeEvent event_type){
         case EventRender:
             /// Display/Render the 3D scene.
             /// At this moment we can call RDK->DrawGeometry to customize the displayed scene
+            // Update the robot values published by the server once per frame (only if something moved or changed)
+            if (!Server->IsStopped()){
+                Server->Snapshot->Refresh(RDK);
+            }
             break;
         case EventMoved:
             /// qDebug() << "Something has moved, such as a robot, reference frame, object or tool.
             /// It is very likely that an EventRender will be triggered immediately after this event
+            Server->Snapshot->InvalidateValues();
             break;
         case EventChanged:
             /// qDebug() << "An item has been added or deleted. Current station: " << RDK->getActiveStation()->Name();
             /// If we added a new item (for example, a reference frame) it is very likely that an EventMoved will follow with the updated position of the newly added item(s)
             /// This event is also triggered when we change the active station and a new station gains focus.
             // qDebug() << "==== EventChanged ====" << RDK->getActiveStation()->Name();
+            Server->Snapshot->InvalidateRobots();
             break;
         case EventChangedStation:
             // we changed the station so load the new settings
             //qDebug() << "==== EventChangedStation ====" << RDK->getActiveStation()->Name();
             LoadSettings();
+            Server->Snapshot->InvalidateRobots();
             break;
         case EventAbout2Save:
             // qDebug() << "==== EventAbout2Save ====" << RDK->getActiveStation()->Name();
@@ -340,6 +361,15 @@ bool PluginOPCUA::LoadSettings(){
     ds >> Client->EndpointUrl;
     ds >> Client->AutoStart;
     ds >> Client->KeepConnected;
+    if (version >= 3){
+        ds >> Server->SamplingInterval;
+    }
+    if (version >= 4){
+        ds >> Client->UseSubscription;
+    }
+    if (version >= 5){
+        ds >> Server->HistorySize;
+    }
     emit UpdateForm();
     qDebug() << "Done";
     return true;
@@ -350,13 +380,16 @@ void PluginOPCUA::SaveSettings(){
     qDebug() << "Saving OPC-UA plugin settings...";
     QByteArray data;
     QDataStream ds(&data, QIODevice::WriteOnly);
-    qint64 version = 2;
+    qint64 version = 5;
     ds << version;
     ds << Server->Port;
     ds << Server->AutoStart;
     ds << Client->EndpointUrl;
     ds << Client->AutoStart;
     ds << Client->KeepConnected;
+    ds << Server->SamplingInterval;
+    ds << Client->UseSubscription;
+    ds << Server->HistorySize;
 
     RDK->setData(PluginName(), data);
 
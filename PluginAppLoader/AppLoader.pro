@@ -37,6 +37,7 @@ CONFIG         += plugin
 #QT += core gui
 QT += widgets
 QT += network   # Allows using QTcpSocket
+QT += concurrent # Scan the App folders and extract packages on a thread pool
 
 # Define your plugin name (name of the DLL file generated)
 TARGET          = AppLoader
@@ -93,20 +94,28 @@ CONFIG(release, debug|release) {
 INCLUDEPATH += ./zip
 
 HEADERS += \
+    appdiscovery.h \
     applistdelegate.h \
     apploader.h \
     dialogapplist.h \
     installerdialog.h \
+    packageextractor.h \
+    pythonpool.h \
+    requirementschecker.h \
     tableheader.h \
     unzipper.h \
     zip/miniz.h \
     zip/zip.h
 
 SOURCES += \
+    appdiscovery.cpp \
     applistdelegate.cpp \
     apploader.cpp \
     dialogapplist.cpp \
     installerdialog.cpp \
+    packageextractor.cpp \
+    pythonpool.cpp \
+    requirementschecker.cpp \
     unzipper.cpp \
     zip/zip.c
 
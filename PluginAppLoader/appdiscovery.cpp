@@ -0,0 +1,419 @@
+#include "appdiscovery.h"
+
+#include <QDir>
+#include <QFile>
+#include <QSettings>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QHash>
+#include <QSaveFile>
+#include <QDebug>
+#include <QAtomicInt>
+#include <QtConcurrent/QtConcurrentMap>
+
+
+/// Version of the index file (the index is ignored if the version does not match)
+static const int IndexVersion = 1;
+
+/// Modification time of a file or folder in ms since epoch, -1 if it does not exist
+static qint64 ModificationTime(const QString &path){
+    QFileInfo info(path);
+    if (!info.exists()){
+        return -1;
+    }
+    return info.lastModified().toMSecsSinceEpoch();
+}
+
+static QJsonArray ToJson(const QStringList &list){
+    return QJsonArray::fromStringList(list);
+}
+
+static QStringList ToStringList(const QJsonValue &value){
+    QStringList list;
+    for (const QJsonValue &item : value.toArray()){
+        list.append(item.toString());
+    }
+    return list;
+}
+
+
+AppDiscovery::AppDiscovery(const QString &indexFile):
+    _indexFile(indexFile),
+    _loadedFromIndex(0),
+    _elapsedMs(0)
+{
+}
+
+int AppDiscovery::LoadedFromIndex() const {
+    return _loadedFromIndex;
+}
+
+qint64 AppDiscovery::ElapsedMs() const {
+    return _elapsedMs;
+}
+
+QList<tAppInfo> AppDiscovery::Scan(const QFileInfoList &directories, int globalCount, bool useIndex){
+    QElapsedTimer timer;
+    timer.start();
+    _loadedFromIndex = 0;
+
+    // Apps of the previous scan, by folder
+    QHash<QString, tAppInfo> indexed;
+    if (useIndex){
+        for (const tAppInfo &app : loadIndex()){
+            indexed.insert(app.SignaturePaths.value(0), app);
+        }
+    }
+
+    // Folders to scan, in order
+    struct tScanJob {
+        QFileInfo Directory;
+        bool Global;
+    };
+    QList<tScanJob> jobs;
+    for (int dindex = 0; dindex < directories.size(); ++dindex){
+        const QFileInfo &directoryInfo = directories.at(dindex);
+
+        // Ignore folders that start with an underscore
+        QString dirApp = directoryInfo.fileName();
+        if (dirApp.startsWith("_") || dirApp.startsWith(".")){
+            continue;
+        }
+        jobs.append({directoryInfo, dindex < globalCount});
+    }
+
+    // Check the unchanged Apps and scan the other ones. Each folder is independent: they are processed in parallel
+    // because most of the time is spent waiting for the file system.
+    QAtomicInt loadedFromIndex(0);
+    QList<tAppInfo> apps = QtConcurrent::blockingMapped<QList<tAppInfo>>(jobs, [&indexed, &loadedFromIndex](const tScanJob &job){
+        QHash<QString, tAppInfo>::const_iterator it = indexed.constFind(job.Directory.absoluteFilePath());
+        if (it != indexed.constEnd() && it.value().Global == job.Global && signatureValid(it.value())){
+            loadedFromIndex.fetchAndAddRelaxed(1);
+            return it.value();
+        }
+        return scanApp(job.Directory, job.Global);
+    });
+    _loadedFromIndex = loadedFromIndex.loadAcquire();
+
+    // Only save the index if something changed
+    if (_loadedFromIndex != apps.size() || indexed.size() != apps.size()){
+        saveIndex(apps);
+    }
+    _elapsedMs = timer.elapsed();
+    qDebug() << "Apps found: " << apps.size() << " loaded from the index: " << _loadedFromIndex << " time (ms): " << _elapsedMs;
+    return apps;
+}
+
+tAppInfo AppDiscovery::scanApp(const QFileInfo &directoryInfo, bool global){
+    tAppInfo app;
+    app.DirApp = directoryInfo.fileName();
+    app.Global = global;
+    app.HasInit = false;
+    app.HasRequirements = false;
+
+    QString dirAppComplete = directoryInfo.absoluteFilePath();
+    app.SignaturePaths.append(dirAppComplete);
+
+    // Retrieve and/or create the INI file related to this app
+    QString fileSettings = dirAppComplete + "/AppConfig.ini";
+
+    // Check if the ini file exists, otherwise, try with the older Settings.ini file
+    bool fileExist = QFile::exists(fileSettings);
+    if (!fileExist){
+        fileSettings = dirAppComplete + "/Settings.ini";
+        fileExist = QFile::exists(fileSettings);
+        if (!fileExist){
+            // Check if we want to forward the app location to another folder (useful if we use GitHub)
+            QString fileLinkTo = dirAppComplete + "/AppLink.ini";
+            if (QFile::exists(fileLinkTo)){
+                app.SignaturePaths.append(fileLinkTo);
+                QSettings linksettings(fileLinkTo, QSettings::IniFormat);
+                QString pathLink = linksettings.value("Path", "").toString();
+                pathLink.replace("\\","/"); // Qt Docs: QSettings always treats backslash as a special character and provides no API for reading or writing such entries.
+                if (!pathLink.isEmpty()){
+                    QDir pathLinkDir(pathLink);
+                    if (pathLinkDir.exists()){
+                        dirAppComplete = pathLink;
+                        app.SignaturePaths.append(dirAppComplete);
+                        fileSettings = dirAppComplete + "/AppConfig.ini";
+                        qDebug() << "Linking app dir to: " << dirAppComplete;
+                        fileExist = QFile::exists(fileSettings);
+                        if (!fileExist){
+                            // Try with the older Settings.ini file
+                            fileSettings = dirAppComplete + "/Settings.ini";
+                            fileExist = QFile::exists(fileSettings);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    if (!fileExist){
+         fileSettings = dirAppComplete + "/AppConfig.ini"; // Use default INI file name
+    }
+    app.DirAppComplete = dirAppComplete;
+    app.FileSettings = fileSettings;
+
+    {
+        // Load settings and save them (default settings will be set)
+        QSettings settings(fileSettings, QSettings::IniFormat);
+        app.MenuName = settings.value("MenuName", app.DirApp).toString();
+        app.MenuParent = settings.value("MenuParent", "").toString();
+        app.Version = settings.value("Version", "1.0.0").toString();
+        app.MenuPriority = settings.value("MenuPriority", 50.0).toDouble();
+        app.MenuVisible = settings.value("MenuVisible", true).toBool();
+        app.ToolbarArea = settings.value("ToolbarArea", 2).toInt();
+        app.ToolbarSize = settings.value("ToolbarSizeRatio", 1.5).toDouble();
+        app.RunCommands = settings.value("RunCommands", QStringList()).toStringList();
+
+        settings.setValue("MenuName", app.MenuName);
+        settings.setValue("MenuParent", app.MenuParent);
+        settings.setValue("Version", app.Version);
+        settings.setValue("MenuPriority", app.MenuPriority);
+        settings.setValue("MenuVisible", app.MenuVisible);
+
+        // Remove obsoleted key
+        if (settings.contains("Enabled"))
+            settings.remove("Enabled");
+
+        settings.setValue("ToolbarArea", app.ToolbarArea);
+        settings.setValue("ToolbarSizeRatio", app.ToolbarSize);
+        settings.setValue("RunCommands", app.RunCommands);
+
+        // Get the list of files in the folder
+        QDir dirAppi(dirAppComplete);
+        QStringList filesApp(dirAppi.entryList(QDir::Files));
+
+        // Same rule as QFile::exists for the icons
+        Qt::CaseSensitivity caseSensitivity = Qt::CaseSensitive;
+#ifdef Q_OS_WIN
+        caseSensitivity = Qt::CaseInsensitive;
+#endif
+
+        for (const QString &file : filesApp){
+            if (file.compare("__init__.py", Qt::CaseSensitive) == 0){
+                app.HasInit = true;
+            }
+
+            // Files that starts with _ are skipped as they are 'internal' files
+            if (file.startsWith("_")){
+                continue;
+            }
+
+            if (file.compare("requirements.txt", Qt::CaseSensitive) == 0){
+                app.HasRequirements = true;
+            }
+
+            if (!file.endsWith(".py", Qt::CaseInsensitive) && !file.endsWith(".exe", Qt::CaseInsensitive)){
+                continue;
+            }
+
+            tAppScript script;
+            script.File = file;
+
+            // Get the key name for the settings file
+            QString keyName(file);
+            if (file.endsWith(".py", Qt::CaseInsensitive)){
+                keyName.chop(3); // ends with PY
+            } else {
+                keyName.chop(4); // ends with EXE
+            }
+            script.KeyName = keyName;
+
+            QString name_guess(QString(keyName).replace("_"," "));
+
+            // Read settings from AppSettings if they exist, otherwise, set the default values
+            script.DisplayName = settings.value(keyName + "/DisplayName", name_guess).toString();
+            script.Comment = settings.value(keyName + "/Description", name_guess).toString();
+            script.Visible = settings.value(keyName + "/Visible", true).toBool();
+            script.DeveloperOnly = settings.value(keyName + "/DeveloperOnly", false).toBool();
+            script.Shortcut = settings.value(keyName + "/Shortcut", "").toString();
+            script.Checkable = settings.value(keyName + "/Checkable", false).toBool();
+            script.CheckableGroup = settings.value(keyName + "/CheckableGroup", -1).toInt();
+            script.AddToMenu = settings.value(keyName + "/AddToMenu", true).toBool();
+            script.AddToToolbar = settings.value(keyName + "/AddToToolbar", true).toBool();
+            script.Priority = settings.value(keyName + "/Priority", 50.0f).toDouble();
+            script.TypesRightClick = settings.value(keyName + "/TypeOnContextMenu", QStringList("")).toStringList(); // Multiple item support. Format can be "TypeOnContextMenu=int" or "TypeOnContextMenu=int, int, .."
+            script.TypesDoubleClick = settings.value(keyName + "/TypeOnDoubleClick", QStringList("")).toStringList(); // Multiple item support. Format can be "TypeOnDoubleClick=int" or "TypeOnDoubleClick=int, int, .."
+
+            // Prevent empty names
+            if (script.DisplayName.isEmpty()){
+                script.DisplayName = keyName;
+            }
+
+            // Save settings to AppSettings file to let the user change them if desired
+            settings.setValue(keyName + "/DisplayName", script.DisplayName);
+            settings.setValue(keyName + "/Description", script.Comment);
+            settings.setValue(keyName + "/Visible", script.Visible);
+            settings.setValue(keyName + "/DeveloperOnly", script.DeveloperOnly);
+            settings.setValue(keyName + "/Shortcut", script.Shortcut);
+            settings.setValue(keyName + "/Checkable", script.Checkable);
+            settings.setValue(keyName + "/CheckableGroup", script.CheckableGroup);
+            settings.setValue(keyName + "/AddToMenu", script.AddToMenu);
+            settings.setValue(keyName + "/AddToToolbar", script.AddToToolbar);
+            settings.setValue(keyName + "/Priority", script.Priority);
+            settings.setValue(keyName + "/TypeOnContextMenu", script.TypesRightClick);
+            settings.setValue(keyName + "/TypeOnDoubleClick", script.TypesDoubleClick);
+
+            // try to find a matching image given the key name (the folder list is used instead of probing each file)
+            static const char *extensions[] = {".svg", ".png", ".jpg", ".ico"};
+            for (const char *extension : extensions){
+                if (filesApp.contains(keyName + extension, caseSensitivity)){
+                    script.IconFile = dirAppComplete + "/" + keyName + extension;
+                    if (filesApp.contains(keyName + "Checked" + extension, caseSensitivity)){
+                        script.IconFileChecked = dirAppComplete + "/" + keyName + "Checked" + extension;
+                    }
+                    break;
+                }
+            }
+            app.Scripts.append(script);
+        }
+
+        // Write the default settings now, so that the modification times of the signature include this change
+        settings.sync();
+    }
+
+    app.SignaturePaths.append(fileSettings);
+    for (const QString &path : app.SignaturePaths){
+        app.SignatureTimes.append(ModificationTime(path));
+    }
+    return app;
+}
+
+bool AppDiscovery::signatureValid(const tAppInfo &app){
+    if (app.SignaturePaths.isEmpty() || app.SignaturePaths.size() != app.SignatureTimes.size()){
+        return false;
+    }
+    for (int i = 0; i < app.SignaturePaths.size(); i++){
+        if (ModificationTime(app.SignaturePaths[i]) != app.SignatureTimes[i]){
+            return false;
+        }
+    }
+    return true;
+}
+
+QList<tAppInfo> AppDiscovery::loadIndex() const {
+    QList<tAppInfo> apps;
+    QFile file(_indexFile);
+    if (_indexFile.isEmpty() || !file.open(QFile::ReadOnly)){
+        return apps;
+    }
+    QJsonObject index = QJsonDocument::fromJson(file.readAll()).object();
+    if (index.value("version").toInt() != IndexVersion){
+        return apps;
+    }
+    for (const QJsonValue &value : index.value("apps").toArray()){
+        QJsonObject obj = value.toObject();
+        tAppInfo app;
+        app.DirApp = obj.value("dir").toString();
+        app.DirAppComplete = obj.value("path").toString();
+        app.FileSettings = obj.value("settings").toString();
+        app.Global = obj.value("global").toBool();
+        app.MenuName = obj.value("menuName").toString();
+        app.MenuParent = obj.value("menuParent").toString();
+        app.Version = obj.value("version").toString();
+        app.MenuPriority = obj.value("menuPriority").toDouble();
+        app.MenuVisible = obj.value("menuVisible").toBool();
+        app.ToolbarArea = obj.value("toolbarArea").toInt();
+        app.ToolbarSize = obj.value("toolbarSize").toDouble();
+        app.RunCommands = ToStringList(obj.value("runCommands"));
+        app.HasInit = obj.value("init").toBool();
+        app.HasRequirements = obj.value("requirements").toBool();
+        for (const QJsonValue &scriptValue : obj.value("scripts").toArray()){
+            QJsonObject scriptObj = scriptValue.toObject();
+            tAppScript script;
+            script.File = scriptObj.value("file").toString();
+            script.KeyName = scriptObj.value("key").toString();
+            script.DisplayName = scriptObj.value("displayName").toString();
+            script.Comment = scriptObj.value("description").toString();
+            script.Visible = scriptObj.value("visible").toBool();
+            script.DeveloperOnly = scriptObj.value("developerOnly").toBool();
+            script.Shortcut = scriptObj.value("shortcut").toString();
+            script.Checkable = scriptObj.value("checkable").toBool();
+            script.CheckableGroup = scriptObj.value("checkableGroup").toInt();
+            script.AddToMenu = scriptObj.value("addToMenu").toBool();
+            script.AddToToolbar = scriptObj.value("addToToolbar").toBool();
+            script.Priority = scriptObj.value("priority").toDouble();
+            script.TypesRightClick = ToStringList(scriptObj.value("typeOnContextMenu"));
+            script.TypesDoubleClick = ToStringList(scriptObj.value("typeOnDoubleClick"));
+            script.IconFile = scriptObj.value("icon").toString();
+            script.IconFileChecked = scriptObj.value("iconChecked").toString();
+            app.Scripts.append(script);
+        }
+        app.SignaturePaths = ToStringList(obj.value("signaturePaths"));
+        for (const QJsonValue &time : obj.value("signatureTimes").toArray()){
+            app.SignatureTimes.append((qint64)time.toDouble());
+        }
+        apps.append(app);
+    }
+    return apps;
+}
+
+void AppDiscovery::saveIndex(const QList<tAppInfo> &apps) const {
+    if (_indexFile.isEmpty()){
+        return;
+    }
+    QJsonArray appsArray;
+    for (const tAppInfo &app : apps){
+        QJsonObject obj;
+        obj["dir"] = app.DirApp;
+        obj["path"] = app.DirAppComplete;
+        obj["settings"] = app.FileSettings;
+        obj["global"] = app.Global;
+        obj["menuName"] = app.MenuName;
+        obj["menuParent"] = app.MenuParent;
+        obj["version"] = app.Version;
+        obj["menuPriority"] = app.MenuPriority;
+        obj["menuVisible"] = app.MenuVisible;
+        obj["toolbarArea"] = app.ToolbarArea;
+        obj["toolbarSize"] = app.ToolbarSize;
+        obj["runCommands"] = ToJson(app.RunCommands);
+        obj["init"] = app.HasInit;
+        obj["requirements"] = app.HasRequirements;
+        QJsonArray scriptsArray;
+        for (const tAppScript &script : app.Scripts){
+            QJsonObject scriptObj;
+            scriptObj["file"] = script.File;
+            scriptObj["key"] = script.KeyName;
+            scriptObj["displayName"] = script.DisplayName;
+            scriptObj["description"] = script.Comment;
+            scriptObj["visible"] = script.Visible;
+            scriptObj["developerOnly"] = script.DeveloperOnly;
+            scriptObj["shortcut"] = script.Shortcut;
+            scriptObj["checkable"] = script.Checkable;
+            scriptObj["checkableGroup"] = script.CheckableGroup;
+            scriptObj["addToMenu"] = script.AddToMenu;
+            scriptObj["addToToolbar"] = script.AddToToolbar;
+            scriptObj["priority"] = script.Priority;
+            scriptObj["typeOnContextMenu"] = ToJson(script.TypesRightClick);
+            scriptObj["typeOnDoubleClick"] = ToJson(script.TypesDoubleClick);
+            scriptObj["icon"] = script.IconFile;
+            scriptObj["iconChecked"] = script.IconFileChecked;
+            scriptsArray.append(scriptObj);
+        }
+        obj["scripts"] = scriptsArray;
+        obj["signaturePaths"] = ToJson(app.SignaturePaths);
+        QJsonArray times;
+        for (qint64 time : app.SignatureTimes){
+            times.append((double)time);
+        }
+        obj["signatureTimes"] = times;
+        appsArray.append(obj);
+    }
+    QJsonObject index;
+    index["version"] = IndexVersion;
+    index["apps"] = appsArray;
+
+    // Write a temporary file first so that an interrupted write never leaves a corrupted index
+    QSaveFile file(_indexFile);
+    if (!file.open(QFile::WriteOnly)){
+        qDebug() << "Unable to save the App index: " << _indexFile;
+        return;
+    }
+    file.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+    file.commit();
+}
@@ -0,0 +1,121 @@
+#ifndef APPDISCOVERY_H
+#define APPDISCOVERY_H
+
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QFileInfo>
+
+
+/// Settings of a script (action) of an App, as read from the App settings file
+struct tAppScript {
+    /// File name of the script (PY or EXE)
+    QString File;
+
+    /// Name of the script without extension (section of the settings file)
+    QString KeyName;
+
+    QString DisplayName;
+    QString Comment;
+    bool Visible;
+    bool DeveloperOnly;
+    QString Shortcut;
+    bool Checkable;
+    int CheckableGroup;
+    bool AddToMenu;
+    bool AddToToolbar;
+    double Priority;
+    QStringList TypesRightClick;
+    QStringList TypesDoubleClick;
+
+    /// Icon file (empty if the script has no icon) and icon shown when the action is checked (empty if none)
+    QString IconFile;
+    QString IconFileChecked;
+};
+
+/// Everything AppLoader needs to know about an App folder to create its menu and toolbar.
+/// It does not contain any widget, so it can be built on any thread and saved in the discovery index.
+struct tAppInfo {
+    /// Name of the folder inside the Apps folder
+    QString DirApp;
+
+    /// Absolute path of the App (the folder of the AppLink.ini target, if any)
+    QString DirAppComplete;
+
+    /// Settings file of the App (AppConfig.ini or Settings.ini)
+    QString FileSettings;
+
+    /// The App is in the global Apps folder (not in the user folder)
+    bool Global;
+
+    QString MenuName;
+    QString MenuParent;
+    QString Version;
+    double MenuPriority;
+    bool MenuVisible;
+    int ToolbarArea;
+    double ToolbarSize;
+    QStringList RunCommands;
+
+    /// The App has an __init__.py file (its parent folder is added to the PYTHONPATH)
+    bool HasInit;
+
+    /// The App has a requirements.txt file
+    bool HasRequirements;
+
+    /// Scripts of the App, in the order of the folder
+    QList<tAppScript> Scripts;
+
+    /// Files and folders that define the App, with their modification time (ms since epoch, -1 if missing).
+    /// The App is scanned again when one of them changes.
+    QStringList SignaturePaths;
+    QList<qint64> SignatureTimes;
+};
+
+
+///
+/// \brief The AppDiscovery class scans the App folders in parallel (thread pool) and keeps an index of the Apps found.
+/// The index is saved to disk: Apps whose folders and settings file did not change since the last scan are loaded from the index,
+/// without reading their settings file or listing their files (this matters when the Apps are on a network drive).
+///
+class AppDiscovery
+{
+public:
+    AppDiscovery(const QString &indexFile);
+
+    ///
+    /// \brief Retrieve the Apps of a list of folders
+    /// \param directories App folders (global Apps first)
+    /// \param globalCount number of folders in the global Apps folder
+    /// \param useIndex load the unchanged Apps from the index (set it to false to scan all the folders)
+    /// \return Apps found, in the order of the folders (folders ignored such as _Folder are not listed)
+    ///
+    QList<tAppInfo> Scan(const QFileInfoList &directories, int globalCount, bool useIndex = true);
+
+    /// Number of Apps loaded from the index during the last scan
+    int LoadedFromIndex() const;
+
+    /// Time of the last scan in milliseconds
+    qint64 ElapsedMs() const;
+
+private:
+    /// Read all the information of an App folder (runs on a thread of the pool)
+    static tAppInfo scanApp(const QFileInfo &directoryInfo, bool global);
+
+    /// Returns true if the files of the App did not change since it was scanned
+    static bool signatureValid(const tAppInfo &app);
+
+    /// Load and save the index
+    QList<tAppInfo> loadIndex() const;
+    void saveIndex(const QList<tAppInfo> &apps) const;
+
+private:
+    QString _indexFile;
+
+    int _loadedFromIndex;
+
+    qint64 _elapsedMs;
+};
+
+#endif // APPDISCOVERY_H
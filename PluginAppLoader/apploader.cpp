@@ -4,6 +4,9 @@
 #include "irobodk.h"
 #include "iitem.h"
 #include "installerdialog.h"
+#include "appdiscovery.h"
+#include "requirementschecker.h"
+#include "pythonpool.h"
 
 #include <QMainWindow>
 #include <QToolBar>
@@ -98,6 +101,19 @@ QString AppLoader::PluginLoad(QMainWindow *mw, QMenuBar *menubar, QStatusBar *st
 
     PathUserApps = userPath.absolutePath();
 
+    // The index of the Apps is saved next to the user Apps folder
+    Discovery = new AppDiscovery(QFileInfo(PathUserApps).absolutePath() + "/AppLoaderIndex.json");
+
+    // Python requirements are checked in the background, the Apps that passed the check are cached next to the index
+    Requirements = new RequirementsChecker(QFileInfo(PathUserApps).absolutePath() + "/AppLoaderRequirements.ini", this);
+    connect(Requirements, &RequirementsChecker::progress, this, &AppLoader::onRequirementsProgress);
+    connect(Requirements, &RequirementsChecker::installStarted, this, &AppLoader::onRequirementsInstall);
+    connect(Requirements, &RequirementsChecker::installFailed, this, &AppLoader::onRequirementsFailed);
+
+    // Optional pool of Python interpreters started ahead of time to run the scripts (disabled by default)
+    Pool = new PythonPool(QFileInfo(PathUserApps).absolutePath() + "/AppLoaderLauncher.py", this);
+    Pool->SetSize(PythonPoolSetting());
+
     // Here you can add all the "Actions": these actions are callbacks from buttons selected from the menu or the toolbar
     action_Apps = new QAction(tr("Apps List"));
     action_Apps->setShortcut(QKeySequence("Shift+A"));
@@ -155,6 +171,16 @@ void AppLoader::PluginUnload(){
     }
 
     AppsDelete();
+
+    delete Discovery;
+    Discovery = nullptr;
+
+    // the processes were stopped above
+    delete Requirements;
+    Requirements = nullptr;
+
+    delete Pool;
+    Pool = nullptr;
 }
 
 void AppLoader::PluginLoadToolbar(QMainWindow *mw, int icon_size){
@@ -246,7 +272,29 @@ bool AppLoader::PluginItemClickMulti(QList<Item> &item_list, QMenu *menu, TypeCl
 
 QString AppLoader::PluginCommand(const QString &command, const QString &value){
     qDebug() << "Received command: " << command << "    With value: " << value;
-    if (command.startsWith("Reload", Qt::CaseInsensitive)) {
+    if (command.startsWith("AppsSearchTime", Qt::CaseInsensitive)) {
+        // Reload the Apps and report the time it took (use NoIndex as the value to scan all the App folders)
+        AppsReload(value.compare("NoIndex", Qt::CaseInsensitive) != 0);
+        return QString("%1 Apps, %2 from the index, %3 ms").arg(ListMenus.size()).arg(Discovery->LoadedFromIndex()).arg(Discovery->ElapsedMs());
+    } else if (command.startsWith("PythonPoolSize", Qt::CaseInsensitive)) {
+        // Number of Python interpreters kept ready to run the scripts (0 disables the pool)
+        if (!value.isEmpty()){
+            int size = qMax(0, value.toInt());
+            QString applicationName = QCoreApplication::applicationName();
+            if (applicationName.isEmpty())
+                applicationName = "RoboDK";
+
+            QSettings pluginSettings(QSettings::IniFormat, QSettings::UserScope,
+                                     applicationName, PluginName().remove(' '));
+            pluginSettings.setValue("PythonPoolSize", size);
+            Pool->SetSize(size);
+            Pool->Warm(RDK->getParam("PYTHON_EXEC"), ScriptEnvironment());
+        }
+        return QString::number(Pool->Size());
+    } else if (command.startsWith("PythonPoolLatency", Qt::CaseInsensitive)) {
+        // Compare the time to run a script with a new process and with the interpreter pool (value: number of runs)
+        return Pool->MeasureLatency(RDK->getParam("PYTHON_EXEC"), ScriptEnvironment(), value.isEmpty() ? 5 : value.toInt());
+    } else if (command.startsWith("Reload", Qt::CaseInsensitive)) {
         AppsReload();
         return "Apps reloaded";
     } else if (command.startsWith("OpenFile", Qt::CaseInsensitive)) {
@@ -344,9 +392,9 @@ void AppLoader::EnableApp(const QString& path, bool enable)
 }
 
 //----------------------------------------------------------------------------------
-void AppLoader::AppsReload(){
+void AppLoader::AppsReload(bool use_index){
     // Navigate files
-    AppsSearch();
+    AppsSearch(false, use_index);
 
     // force reload of apps
     AppsLoadMenus();
@@ -397,7 +445,7 @@ void AppLoader::AppsDelete(){
     }
 }
 
-void AppLoader::AppsSearch(bool install_requirements){
+void AppLoader::AppsSearch(bool install_requirements, bool use_index){
     // We keep the list of all toolbars and menus to sort them properly and display the toolbar when required
     // (global variable)
     //QList<tAppMenu*> ListMenus;
@@ -416,104 +464,37 @@ void AppLoader::AppsSearch(bool install_requirements){
     int globalCount = directories.size();
     directories.append(userPath.entryInfoList(QDir::Dirs));
 
-    int appsenabled_count = 0;
-    for (int dindex = 0; dindex < directories.size(); ++dindex) {
-        const QFileInfo& directoryInfo = directories.at(dindex);
+    // Read the App folders on a thread pool (unchanged Apps are loaded from the index)
+    QList<tAppInfo> apps = Discovery->Scan(directories, globalCount, use_index);
 
-        bool global = (dindex < globalCount);
+    // List of enabled apps (the same for all apps)
+    QString applicationName = QCoreApplication::applicationName();
+    if (applicationName.isEmpty())
+        applicationName = "RoboDK";
 
-        QString dirApp = directoryInfo.fileName();
+    QString pluginName = PluginName().remove(' ');
 
-        // Ignore folders that start with an underscore
-        if (dirApp.startsWith("_") || dirApp.startsWith(".")){
-            continue;
-        }
-        qDebug() << "Loading App dir: " << dirApp;
+    QSettings pluginSettings(QSettings::IniFormat, QSettings::UserScope,
+                             applicationName, pluginName);
 
-        QString dirAppComplete = directoryInfo.absoluteFilePath();
-
-        // Retrieve and/or create the INI file related to this app
-        QString fileSettings = dirAppComplete + "/AppConfig.ini";
-
-        // Check if the ini file exists, otherwise, try with the older Settings.ini file
-        bool fileExist = QFile::exists(fileSettings);
-        if (!fileExist){
-            fileSettings = dirAppComplete + "/Settings.ini";
-            fileExist = QFile::exists(fileSettings);
-            if (!fileExist){
-                // Check if we want to forward the app location to another folder (useful if we use GitHub)
-                QString fileLinkTo = dirAppComplete + "/AppLink.ini";
-                if (QFile::exists(fileLinkTo)){
-                    QSettings linksettings(fileLinkTo, QSettings::IniFormat);
-                    QString pathLink = linksettings.value("Path", "").toString();
-                    pathLink.replace("\\","/"); // Qt Docs: QSettings always treats backslash as a special character and provides no API for reading or writing such entries.
-                    if (!pathLink.isEmpty()){
-                        QDir pathLinkDir(pathLink);
-                        if (pathLinkDir.exists()){
-                            dirAppComplete = pathLink;
-                            fileSettings = dirAppComplete + "/AppConfig.ini";
-                            qDebug() << "Linking app dir to: " << dirAppComplete;
-                            fileExist = QFile::exists(fileSettings);
-                            if (!fileExist){
-                                // Try with the older Settings.ini file
-                                fileSettings = dirAppComplete + "/Settings.ini";
-                                fileExist = QFile::exists(fileSettings);
-                            }
-                        }
-                    }
-                }
-            }
-        }
+    QStringList enabledApps;
+    pluginSettings.beginGroup("Enabled");
+    int count = pluginSettings.value("count", 0).toInt();
+    enabledApps.reserve(count);
+    for (int eindex = 0; eindex < count; ++eindex)
+        enabledApps << pluginSettings.value(QString::number(eindex)).toString();
+    pluginSettings.endGroup();
 
-        if (!fileExist){
-             fileSettings = dirAppComplete + "/AppConfig.ini"; // Use default INI file name
-        }
+    // Create the menus, toolbars and actions (GUI thread)
+    int appsenabled_count = 0;
+    for (const tAppInfo &app : apps){
+        const QString &dirApp = app.DirApp;
+        const QString &dirAppComplete = app.DirAppComplete;
+        const QString &fileSettings = app.FileSettings;
+        qDebug() << "Loading App dir: " << dirApp;
 
         RDK->ShowMessage(tr("Loading App ") + dirApp + tr(". Using settings file: ") + fileSettings, false);
 
-        // Load settings and save them (default settings will be set)
-        QSettings settings(fileSettings, QSettings::IniFormat);
-        QString menuName = settings.value("MenuName", dirApp).toString();
-        QString menuParent = settings.value("MenuParent", "").toString();
-        QString version = settings.value("Version", "1.0.0").toString();
-        double menuPriority = settings.value("MenuPriority", 50.0).toDouble();
-        bool menuVisible = settings.value("MenuVisible", true).toBool();
-        int toolbarArea = settings.value("ToolbarArea", 2).toInt();
-        double toolbarSize = settings.value("ToolbarSizeRatio", 1.5).toDouble();
-        QStringList RunCommands = settings.value("RunCommands", QStringList()).toStringList();
-
-        settings.setValue("MenuName", menuName);
-        settings.setValue("MenuParent", menuParent);
-        settings.setValue("Version", version);
-        settings.setValue("MenuPriority", menuPriority);
-        settings.setValue("MenuVisible", menuVisible);
-
-        // Remove obsoleted key
-        if (settings.contains("Enabled"))
-            settings.remove("Enabled");
-
-        settings.setValue("ToolbarArea", toolbarArea);
-        settings.setValue("ToolbarSizeRatio", toolbarSize);
-        settings.setValue("RunCommands", RunCommands);
-
-
-        QString applicationName = QCoreApplication::applicationName();
-        if (applicationName.isEmpty())
-            applicationName = "RoboDK";
-
-        QString pluginName = PluginName().remove(' ');
-
-        QSettings pluginSettings(QSettings::IniFormat, QSettings::UserScope,
-                                 applicationName, pluginName);
-
-        QStringList enabledApps;
-        pluginSettings.beginGroup("Enabled");
-        int count = pluginSettings.value("count", 0).toInt();
-        enabledApps.reserve(count);
-        for (int eindex = 0; eindex < count; ++eindex)
-            enabledApps << pluginSettings.value(QString::number(eindex)).toString();
-        pluginSettings.endGroup();
-
 #ifdef Q_OS_WIN
         bool appEnabled = enabledApps.contains(fileSettings, Qt::CaseInsensitive);
 #else
@@ -522,10 +503,10 @@ void AppLoader::AppsSearch(bool install_requirements){
 
 
         // Create a new list for menus and toolbars
-        tAppToolbar *appToolbar = new tAppToolbar(menuName, menuPriority, toolbarArea,
-                                                  toolbarSize, appEnabled);
-        tAppMenu *appMenu = new tAppMenu(menuName, menuParent, menuPriority, menuVisible,
-                                         appEnabled, global, version, dirApp, fileSettings);
+        tAppToolbar *appToolbar = new tAppToolbar(app.MenuName, app.MenuPriority, app.ToolbarArea,
+                                                  app.ToolbarSize, appEnabled);
+        tAppMenu *appMenu = new tAppMenu(app.MenuName, app.MenuParent, app.MenuPriority, app.MenuVisible,
+                                         appEnabled, app.Global, app.Version, dirApp, fileSettings);
         appMenu->Toolbar = appToolbar;
         ListMenus.append(appMenu);
         ListToolbars.append(appToolbar);
@@ -533,13 +514,26 @@ void AppLoader::AppsSearch(bool install_requirements){
         // Run commands specified by each app (there could be conflicts/contradictions)
         if (appEnabled){
             appsenabled_count = appsenabled_count + 1;
-            foreach (QString command, RunCommands){
+            foreach (QString command, app.RunCommands){
                 if (!command.isEmpty()){
                     RDK->Command(command);
                 }
             }
         }
 
+        if (appEnabled && app.HasInit){
+            // Add the App's directory to the search path for Python modules (PYTHONPATH). Typically C:/RoboDK/Apps unless there is an AppLink.ini
+            QString appDir = QFileInfo(dirAppComplete).absolutePath();
+            if (!PypathAppsDirs.contains(appDir)){
+                PypathAppsDirs.append(appDir);
+            }
+        }
+
+        if (appEnabled && install_requirements && app.HasRequirements){
+            // Verify the Python dependencies in the background (the Apps that passed the check before are skipped)
+            Requirements->Check(dirApp, dirAppComplete + "/requirements.txt", RDK->getParam("PYTHON_EXEC"));
+        }
+
         // List of actions for the menu
         QList<tAppAction*> menuActions;
         // List of actions for the toolbar
@@ -548,149 +542,38 @@ void AppLoader::AppsSearch(bool install_requirements){
         QList<QActionGroup*> actionGroups;
         QList<int> actionGroupIds;
 
-
-        // Get the list of files in the folder
-        QDir dirAppi(dirAppComplete);
-        QStringList filesApp(dirAppi.entryList(QDir::Files));
-
-        // Iterate through each App (folder)
-        foreach (QString file, filesApp){
-
-            if (appEnabled && file.compare("__init__.py", Qt::CaseSensitive) == 0){
-                // Add the App's directory to the search path for Python modules (PYTHONPATH). Typically C:/RoboDK/Apps unless there is an AppLink.ini
-                QString appDir = QFileInfo(dirAppComplete).absolutePath();
-                if (!PypathAppsDirs.contains(appDir)){
-                    PypathAppsDirs.append(appDir);
-                }
-            }
-
-            // Files that starts with _ are skipped as they are 'internal' files
-            if (file.startsWith("_")){
-                continue;
-            }
-
-            if (appEnabled && install_requirements && (file.compare("requirements.txt", Qt::CaseSensitive) == 0)){
-                // Preload all dependencies to the Python Interpreter
-                qDebug() << "Installing Python dependencies for " + dirApp;
-
-                QProcess process;
-                connect(&process, &QProcess::readyRead, this, &AppLoader::onPipReadyRead);
-                process.setProcessChannelMode(QProcess::MergedChannels);
-
-                // Check if requirements are missing. This is quicker than pip install, thus it does not hang the UI as much.
-                QStringList args;
-                args << "-c" << "import pkg_resources; pkg_resources.require(open('" + dirAppComplete + "/" + file + "',mode='r'))";
-                process.start(RDK->getParam("PYTHON_EXEC"), args);
-                if (!process.waitForFinished(-1) ||
-                    process.error() == QProcess::FailedToStart ||
-                    process.exitStatus() != QProcess::NormalExit){
-                    qDebug() << "Unable to check Python dependencies for " + dirApp;
-                    continue;
-                }
-                if (process.exitCode() == 0){ // 1 means something to install
-                    qDebug() << "All dependencies are installed for " + dirApp;
-                    continue;
-                }
-                process.close();
-
-                // Install missing requirements (hangs the UI)
-                RDK->ShowMessage("Installing additionnal Python dependencies for App \"" + dirApp + "\". See requirements.txt in the app folder.\n\nRoboDK might become unresponsive during this process, please wait.", true);
-
-                // Using a detached process on Windows breaks the debugger (requires run from terminal).
-                // This solution works in all cases, but is time consuming.. do this only when loading the plugin.
-                args.clear();
-                args << "-m" << "pip" << "install" << "--ignore-installed" << "-r" << dirAppComplete + "/" + file;
-                process.start(RDK->getParam("PYTHON_EXEC"), args);
-                if (!process.waitForFinished(-1) ||
-                    process.error() == QProcess::FailedToStart ||
-                    process.exitStatus() != QProcess::NormalExit ||
-                    process.exitCode() < 0){
-                    RDK->ShowMessage("Failed to install additional Python dependencies for App \"" + dirApp + "\".", true);
-                }
-            }
-
-            if (!file.endsWith(".py", Qt::CaseInsensitive) && !file.endsWith(".exe", Qt::CaseInsensitive)){
-                continue;
-            }
-
-            // Get the key name for the settings file
-            QString keyName(file);
-            if (file.endsWith(".py", Qt::CaseInsensitive)){
-                keyName.chop(3); // ends with PY
-            } else {
-                keyName.chop(4); // ends with EXE
-            }
-
-            QString name_guess(QString(keyName).replace("_"," "));
-
-            // Read settings from AppSettings if they exist, otherwise, set the default values
-            QString displayName = settings.value(keyName + "/DisplayName", name_guess).toString();
-            QString comment = settings.value(keyName + "/Description", name_guess).toString();
-            bool visible = settings.value(keyName + "/Visible", true).toBool();
-            bool developerOnly = settings.value(keyName + "/DeveloperOnly", false).toBool();
-            QString shortcutstr = settings.value(keyName + "/Shortcut", "").toString();
-            bool checkable = settings.value(keyName + "/Checkable", false).toBool();
-            int checkable_group = settings.value(keyName + "/CheckableGroup", -1).toInt();
-            bool addToMenu = settings.value(keyName + "/AddToMenu", true).toBool();
-            bool addToToolBar = settings.value(keyName + "/AddToToolbar", true).toBool();
-            double priority = settings.value(keyName + "/Priority", 50.0f).toDouble();
-            QStringList types_rightclick_str = settings.value(keyName + "/TypeOnContextMenu", QStringList("")).toStringList(); // Multiple item support. Format can be "TypeOnContextMenu=int" or "TypeOnContextMenu=int, int, .."
-            QStringList types_doubleclick_str = settings.value(keyName + "/TypeOnDoubleClick", QStringList("")).toStringList(); // Multiple item support. Format can be "TypeOnDoubleClick=int" or "TypeOnDoubleClick=int, int, .."
+        // Iterate through each script of the App
+        for (const tAppScript &script : app.Scripts){
+            const QString &file = script.File;
+            const QString &displayName = script.DisplayName;
+            const QString &comment = script.Comment;
+            const bool checkable = script.Checkable;
+            const int checkable_group = script.CheckableGroup;
+            const QString &shortcutstr = script.Shortcut;
+            const double priority = script.Priority;
+            const bool addToMenu = script.AddToMenu;
+            const bool addToToolBar = script.AddToToolbar;
 
             // Remove invalid inputs from string lists
-            QList<int> types_rightclick = ParseStringList(types_rightclick_str);
-            QList<int> types_doubleclick = ParseStringList(types_doubleclick_str);
-
-            // Prevent empty names
-            if (displayName.isEmpty()){
-                displayName = keyName;
-            }
-
-            // Save settings to AppSettings file to let the user change them if desired
-            settings.setValue(keyName + "/DisplayName", displayName);
-            settings.setValue(keyName + "/Description", comment);
-            settings.setValue(keyName + "/Visible", visible);
-            settings.setValue(keyName + "/DeveloperOnly", developerOnly);
-            settings.setValue(keyName + "/Shortcut", shortcutstr);
-            settings.setValue(keyName + "/Checkable", checkable);
-            settings.setValue(keyName + "/CheckableGroup", checkable_group);
-            settings.setValue(keyName + "/AddToMenu", addToMenu);
-            settings.setValue(keyName + "/AddToToolbar", addToToolBar);
-            settings.setValue(keyName + "/Priority", priority);
-            settings.setValue(keyName + "/TypeOnContextMenu",  types_rightclick_str);
-            settings.setValue(keyName + "/TypeOnDoubleClick",  types_doubleclick_str);
+            QList<int> types_rightclick = ParseStringList(script.TypesRightClick);
+            QList<int> types_doubleclick = ParseStringList(script.TypesDoubleClick);
 
             // Forget about this action if it is set to non visible
-            if (!visible || (!isDeveloperMode && developerOnly)){
+            if (!script.Visible || (!isDeveloperMode && script.DeveloperOnly)){
                 continue;
             }
 
-            // try to find a matching image given the key name:
+            // matching image given the key name (found when the App was scanned)
             QIcon *icon;
-            QString fileCompleteNoExt(dirAppComplete + "/" + keyName);
-            QString iconfile;
-            if (QFile::exists(fileCompleteNoExt + ".svg")){
-                iconfile = fileCompleteNoExt + ".svg";
-                icon = new QIcon(iconfile);
-            } else if (QFile::exists(fileCompleteNoExt + ".png")){
-                iconfile = fileCompleteNoExt + ".png";
-                icon = new QIcon(iconfile);
-            } else if (QFile::exists(fileCompleteNoExt + ".jpg")){
-                iconfile = fileCompleteNoExt + ".jpg";
-                icon = new QIcon(iconfile);
-            } else if (QFile::exists(fileCompleteNoExt + ".ico")){
-                iconfile = fileCompleteNoExt + ".ico";
-                icon = new QIcon(iconfile);
+            if (!script.IconFile.isEmpty()){
+                icon = new QIcon(script.IconFile);
             } else {
                 icon = new QIcon();
             }
 
             // add icon active
-            if (checkable && iconfile.length() > 4){
-                QString iconfile_checked = QString(iconfile).insert(iconfile.length()-4,"Checked");
-                if (QFile::exists(iconfile_checked)){
-                    icon->addFile(iconfile_checked, QSize(), QIcon::Mode::Normal, QIcon::State::On);
-                }
+            if (checkable && !script.IconFileChecked.isEmpty()){
+                icon->addFile(script.IconFileChecked, QSize(), QIcon::Mode::Normal, QIcon::State::On);
             }
 
             // create the new action
@@ -831,6 +714,9 @@ void AppLoader::AppsSearch(bool install_requirements){
         qDebug() << "Python path: " << RDK->Command("PYTHONPATH", pypath);
     }
 
+    // Start the interpreters of the pool with the new PYTHONPATH
+    Pool->Warm(RDK->getParam("PYTHON_EXEC"), ScriptEnvironment());
+
     // Done
     QString msg(tr("Done loading Apps"));
     if (appsenabled_count > 0){
@@ -999,9 +885,24 @@ void AppLoader::onRunScript(){
         RDK->setParam(param_name, action->isChecked() ? "1" : "0");
     }
 
+    // Add RoboDK's environnement to the process
+    QStringList env = ScriptEnvironment();
+    QString pythonExec = RDK->getParam("PYTHON_EXEC");
+    bool isPython = filepath.endsWith(".py", Qt::CaseInsensitive);
+
     // start the process
-    QProcess *proc = new QProcess();
+    // Scripts of checkable actions keep their own process, other scripts can run in an interpreter of the pool (robodk is already imported)
+    QProcess *proc = nullptr;
+    if (isPython && !action->isCheckable()){
+        proc = Pool->Take(pythonExec, env);
+    }
+    bool pooled = (proc != nullptr);
+    if (!pooled){
+        proc = new QProcess();
+        proc->setEnvironment(env);
+    }
     proc->setObjectName("Process: " + filepath);
+    proc->setProperty("startTime", QDateTime::currentMSecsSinceEpoch());
 
     connect(proc, SIGNAL(finished(int)), this, SLOT(onScriptFinished()));
     connect(proc, SIGNAL(readyReadStandardOutput()),this,SLOT(onScriptReadyRead()));
@@ -1052,7 +953,39 @@ void AppLoader::onRunScript(){
         }
     }
 
-    // Add RoboDK's environnement to the process
+    // run the script
+    QStringList args;
+    if (action->isCheckable()){ // pass an argument if the option is checkable
+        args.append(action->isChecked() ? "Checked" : "Unchecked");
+    }
+    if (pooled){
+        qDebug() << "Running script (interpreter pool): " << filepath;
+        PythonPool::Run(proc, filepath, args);
+    } else if (isPython){
+        args.prepend(filepath);
+        qDebug() << "Running script: " << filepath;
+        proc->start(pythonExec, args);
+    } else {
+        qDebug() << "Running custom executable: " << filepath;
+        proc->start(filepath);
+    }
+    qDebug() << "Arguments: " << args;
+
+}
+
+int AppLoader::PythonPoolSetting(){
+    QString applicationName = QCoreApplication::applicationName();
+    if (applicationName.isEmpty())
+        applicationName = "RoboDK";
+
+    QString pluginName = PluginName().remove(' ');
+
+    QSettings pluginSettings(QSettings::IniFormat, QSettings::UserScope,
+                             applicationName, pluginName);
+    return pluginSettings.value("PythonPoolSize", 0).toInt();
+}
+
+QStringList AppLoader::ScriptEnvironment(){
 #ifdef Q_OS_WIN
     QString path_sep(";");
 #else
@@ -1075,23 +1008,7 @@ void AppLoader::onRunScript(){
     QString apiport = RDK->Command("PORT","");
     env.insert("ROBODK_API_PORT", apiport);
 
-    proc->setEnvironment(env.toStringList());
-
-    // run the script
-    QStringList args;
-    if (action->isCheckable()){ // pass an argument if the option is checkable
-        args.append(action->isChecked() ? "Checked" : "Unchecked");
-    }
-    if (filepath.endsWith(".py", Qt::CaseInsensitive)){
-        args.prepend(filepath);
-        qDebug() << "Running script: " << filepath;
-        proc->start(RDK->getParam("PYTHON_EXEC"), args);
-    } else {
-        qDebug() << "Running custom executable: " << filepath;
-        proc->start(filepath);
-    }
-    qDebug() << "Arguments: " << args;
-
+    return env.toStringList();
 }
 
 // Triggered when a script finished executing
@@ -1105,6 +1022,7 @@ void AppLoader::onScriptFinished(){
     QObject::disconnect(proc);
 
     qDebug().noquote() << "Script finished with exit code: " << proc->exitCode() << "->" << proc->objectName();
+    qDebug() << "Script time: " << QDateTime::currentMSecsSinceEpoch() - proc->property("startTime").toLongLong() << "ms";
     // Display warning message when there is an error
     if (proc->exitCode() != 0){
         /*QString script_path("unknown");
@@ -1168,6 +1086,25 @@ void AppLoader::onScriptReadyRead(){
     qDebug() << "---- done ----";
 }
 
+void AppLoader::onRequirementsProgress(int done, int total)
+{
+    if (done < total){
+        RDK->ShowMessage(tr("Checking Python dependencies of the Apps (%1/%2)").arg(done + 1).arg(total), false);
+    } else {
+        RDK->ShowMessage(tr("Done checking Python dependencies of the Apps"), false);
+    }
+}
+
+void AppLoader::onRequirementsInstall(const QString &appName)
+{
+    RDK->ShowMessage("Installing additionnal Python dependencies for App \"" + appName + "\". See requirements.txt in the app folder.", false);
+}
+
+void AppLoader::onRequirementsFailed(const QString &appName)
+{
+    RDK->ShowMessage("Failed to install additional Python dependencies for App \"" + appName + "\".", true);
+}
+
 void AppLoader::onPipReadyRead()
 {
     QProcess* process = qobject_cast<QProcess*>(QObject::sender());
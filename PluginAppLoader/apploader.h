@@ -17,6 +17,9 @@ class IRoboDK;
 class IItem;
 
 class DialogAppList;
+class AppDiscovery;
+class RequirementsChecker;
+class PythonPool;
 
 class tAppMenu;
 
@@ -127,13 +130,14 @@ public:
     void EnableApp(const QString& path, bool enable);
 
     /// Reload all apps
-    void AppsReload();
+    /// \param use_index load the unchanged Apps from the discovery index (set it to false to scan all the App folders)
+    void AppsReload(bool use_index=true);
 
     /// Unload and delete all apps (cleanup)
     void AppsDelete();
 
     /// Look for apps in the Apps folder
-    void AppsSearch(bool install_requirements=false);
+    void AppsSearch(bool install_requirements=false, bool use_index=true);
 
     /// Retrieve all apps and load them in the main menu
     void AppsLoadMenus();
@@ -147,6 +151,12 @@ public:
     /// remove all toolbars
     void AppsUnloadToolbars();
 
+    /// Environment of the scripts: RoboDK's PYTHONPATH and API port
+    QStringList ScriptEnvironment();
+
+    /// Size of the Python interpreter pool saved in the plugin settings
+    int PythonPoolSetting();
+
     /// Run Python code from Qt
     //bool RunPythonShell(const QString &python_exec, const QString &python_code);
 
@@ -187,6 +197,15 @@ public slots:
     /// Called on pip output (eg: print to stdout/default)
     void onPipReadyRead();
 
+    /// Called when the Python dependencies of an App were checked
+    void onRequirementsProgress(int done, int total);
+
+    /// Called when the missing Python dependencies of an App are being installed
+    void onRequirementsInstall(const QString &appName);
+
+    /// Called when the missing Python dependencies of an App could not be installed
+    void onRequirementsFailed(const QString &appName);
+
 
 // define your actions: usually, one action per button
 private:
@@ -197,6 +216,15 @@ private:
     /// Path to Local User Apps folder (usually C:/Users/<username>/AppData/Roaming/RoboDK/Apps/)
     QString PathUserApps;
 
+    /// Scans the App folders and keeps the index of the Apps found
+    AppDiscovery *Discovery;
+
+    /// Verifies the Python requirements of the Apps in the background
+    RequirementsChecker *Requirements;
+
+    /// Python interpreters started ahead of time to run the scripts
+    PythonPool *Pool;
+
     /// List of directories containing enabled Apps (including AppLinks) to add to PYTHONPATH. i.e. C:/RoboDK/Apps/MyApp -> C:/RoboDK/Apps, C:/RoboDK/Apps/MyApp/AppLink.ini -> C:/DirOfMyApp
     QStringList PypathAppsDirs;
 
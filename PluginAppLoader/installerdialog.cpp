@@ -2,22 +2,47 @@
 #include "ui_installerdialog.h"
 #include "apploader.h"
 #include "unzipper.h"
+#include "packageextractor.h"
 
 #include <QMessageBox>
 #include <QFileInfo>
 #include <QStringList>
-#include <QTemporaryFile>
+#include <QTextStream>
 #include <QSettings>
 #include <QComboBox>
 #include <QDebug>
 #include <QString>
 
 
+// Read a value of the General section of an INI file loaded in memory
+static QString manifestValue(const QByteArray& manifest, const QString& key){
+    QTextStream stream(manifest);
+    bool general = true;
+    while (!stream.atEnd()) {
+        QString line = stream.readLine().trimmed();
+        if (line.startsWith('[')) {
+            general = (line.compare("[General]", Qt::CaseInsensitive) == 0);
+            continue;
+        }
+
+        int equal = line.indexOf('=');
+        if (!general || equal < 0 || line.left(equal).trimmed() != key)
+            continue;
+
+        QString value = line.mid(equal + 1).trimmed();
+        if (value.size() > 1 && value.startsWith('"') && value.endsWith('"'))
+            value = value.mid(1, value.size() - 2);
+        return value;
+    }
+    return QString();
+}
+
 
 InstallerDialog::InstallerDialog(AppLoader* apploader, QWidget* parent) :
     QDialog(parent),
     ui(new Ui::InstallerDialog),
-    pAppLoader(apploader)
+    pAppLoader(apploader),
+    extractor(nullptr)
 {
     ui->setupUi(this);
     setModal(true);
@@ -64,17 +89,6 @@ bool InstallerDialog::processPackage(const QString& package){
     QDir globalFolder(pAppLoader->PathApps);
     QDir userFolder(pAppLoader->PathUserApps);
 
-    QTemporaryFile temporaryFile;
-    QString temporaryFileName;
-    if (!temporaryFile.open()) {
-        QMessageBox::critical(parentWidget(), tr("Error"),
-            tr("Unable to create temporary file"),
-            QMessageBox::Close);
-        return false;
-    }
-    temporaryFileName = temporaryFile.fileName();
-    temporaryFile.close();
-
     ApplicationRecord record;
     int installedCount = 0;
     int newCount = 0;
@@ -90,14 +104,14 @@ bool InstallerDialog::processPackage(const QString& package){
 
         name.truncate(slash);
 
-        if (!unzipper.entryExtract(temporaryFileName))
+        // The manifest is read in memory, no need to extract it
+        QByteArray manifest;
+        if (!unzipper.entryRead(manifest))
             continue;
 
-        QSettings manifest(temporaryFileName, QSettings::IniFormat);
-
         record.clear();
         record.name = name;
-        record.proposedVersion = QVersionNumber::fromString(manifest.value("Version").toString());
+        record.proposedVersion = QVersionNumber::fromString(manifestValue(manifest, "Version"));
 
         bool installed = false;
 
@@ -270,15 +284,21 @@ void InstallerDialog::populateTable(int limit, bool installed){
 }
 
 void InstallerDialog::on_buttonBox_accepted(){
+    if (extractor)
+        return;
+
     Unzipper unzipper(packageName);
     if (!unzipper.open()) {
         QMessageBox::critical(this, tr("Error"),
             tr("Unable to open package file:<br><b>%1</b>").arg(packageName),
             QMessageBox::Close);
-        reject();
+        QDialog::reject();
         return;
     }
 
+    QList<tPackageEntry> entries;
+    enableFolders.clear();
+
     for (int row = 0; row < ui->tableWidget->rowCount(); ++row) {
         QComboBox* comboBox = qobject_cast<QComboBox*>(ui->tableWidget->cellWidget(row, 4));
         if (!comboBox || !comboBox->property("action-record").isValid())
@@ -310,14 +330,63 @@ void InstallerDialog::on_buttonBox_accepted(){
             if (!name.startsWith(entity.name + "/"))
                 continue;
 
+            // The folders are created here, the files are extracted in parallel
             QFileInfo fileInfo(folder.absoluteFilePath(name));
             folder.mkpath(fileInfo.absolutePath());
-            unzipper.entryExtract(fileInfo.absoluteFilePath());
+
+            tPackageEntry entry;
+            entry.Index = i;
+            entry.Name = name;
+            entry.Destination = fileInfo.absoluteFilePath();
+            entries.append(entry);
         }
 
         if (entity.path.isEmpty())
-            pAppLoader->EnableApp(folder.absoluteFilePath(entity.name), true);
+            enableFolders.append(folder.absoluteFilePath(entity.name));
+    }
+    unzipper.close();
+
+    // Extract the files without blocking the dialog
+    ui->tableWidget->setEnabled(false);
+    ui->buttonBox->setEnabled(false);
+    ui->progressBar->setRange(0, qMax(1, entries.size()));
+    ui->progressBar->setValue(0);
+    ui->progressBar->setVisible(true);
+
+    extractor = new PackageExtractor(packageName, this);
+    connect(extractor, &PackageExtractor::progress, this, &InstallerDialog::onExtractProgress);
+    connect(extractor, &PackageExtractor::finished, this, &InstallerDialog::onExtractFinished);
+    extractor->Start(entries);
+}
+
+void InstallerDialog::onExtractProgress(int done, int total){
+    ui->progressBar->setRange(0, qMax(1, total));
+    ui->progressBar->setValue(done);
+}
+
+void InstallerDialog::onExtractFinished(bool success){
+    if (!success) {
+        QStringList errors = extractor->Errors();
+        QString list = QStringList(errors.mid(0, 10)).join("<br>");
+        if (errors.size() > 10)
+            list += "<br>...";
+        QMessageBox::warning(this, tr("Error"),
+            tr("Unable to extract %1 files from the package:<br>%2").arg(errors.size()).arg(list),
+            QMessageBox::Close);
     }
+
+    for (const QString& folder : enableFolders)
+        pAppLoader->EnableApp(folder, true);
+
+    extractor->deleteLater();
+    extractor = nullptr;
     accept();
 }
 
+void InstallerDialog::reject(){
+    // The dialog can't be closed while files are being extracted
+    if (extractor)
+        return;
+
+    QDialog::reject();
+}
@@ -9,6 +9,7 @@
 
 
 class AppLoader;
+class PackageExtractor;
 
 namespace Ui {
 class InstallerDialog;
@@ -45,14 +46,21 @@ public:
     bool addExistingApp(ApplicationRecord& record, const QDir& folder, bool global);
     void populateTable(int limit, bool installed);
 
+public slots:
+    void reject() override;
+
 private slots:
     void on_buttonBox_accepted();
+    void onExtractProgress(int done, int total);
+    void onExtractFinished(bool success);
 
 private:
     Ui::InstallerDialog* ui;
     AppLoader* pAppLoader;
     QString packageName;
     QList<ApplicationRecord> records;
+    PackageExtractor* extractor;
+    QStringList enableFolders;
 };
 
 #endif // INSTALLERDIALOG_H
@@ -0,0 +1,104 @@
+#include "packageextractor.h"
+#include "unzipper.h"
+
+#include <QFile>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+
+
+PackageExtractor::PackageExtractor(const QString &package, QObject *parent)
+    : QObject(parent)
+    , _package(package)
+    , _done(0)
+    , _cancel(0)
+    , _total(0)
+{
+    connect(&_watcher, &QFutureWatcher<QStringList>::finished, this, &PackageExtractor::onFinished);
+}
+
+PackageExtractor::~PackageExtractor(){
+    Cancel();
+    _watcher.waitForFinished();
+}
+
+void PackageExtractor::Start(const QList<tPackageEntry> &entries){
+    if (IsRunning())
+        return;
+
+    _errors.clear();
+    _done.storeRelease(0);
+    _cancel.storeRelease(0);
+    _total = entries.size();
+
+    // Spread the files among the threads (one after the other, so that large and small files are mixed)
+    int count = qBound(1, QThread::idealThreadCount(), qMax(1, entries.size()));
+    _chunks.clear();
+    for (int i = 0; i < count; ++i){
+        tPackageChunk chunk;
+        chunk.Owner = this;
+        _chunks.append(chunk);
+    }
+    for (int i = 0; i < entries.size(); ++i){
+        _chunks[i % count].Entries.append(entries.at(i));
+    }
+
+    emit progress(0, _total);
+    _watcher.setFuture(QtConcurrent::mapped(_chunks, &PackageExtractor::extractChunk));
+}
+
+void PackageExtractor::Cancel(){
+    _cancel.storeRelease(1);
+}
+
+bool PackageExtractor::IsRunning() const {
+    return _watcher.isRunning();
+}
+
+QStringList PackageExtractor::Errors() const {
+    return _errors;
+}
+
+QStringList PackageExtractor::extractChunk(const tPackageChunk &chunk){
+    QStringList errors;
+
+    // miniz reads the package with a single file pointer: each thread needs its own handle
+    Unzipper unzipper(chunk.Owner->_package);
+    if (!unzipper.open()){
+        for (const tPackageEntry &entry : chunk.Entries){
+            errors.append(entry.Name);
+        }
+        return errors;
+    }
+
+    for (const tPackageEntry &entry : chunk.Entries){
+        if (chunk.Owner->_cancel.loadAcquire() != 0){
+            errors.append(entry.Name);
+            continue;
+        }
+
+        // The file is written as it is decompressed, the extraction fails if the CRC does not match
+        if (!unzipper.selectEntry(entry.Index) || !unzipper.entryExtract(entry.Destination)){
+            QFile::remove(entry.Destination);
+            errors.append(entry.Name);
+        }
+        chunk.Owner->countEntry();
+    }
+    return errors;
+}
+
+void PackageExtractor::countEntry(){
+    int done = _done.fetchAndAddRelaxed(1) + 1;
+
+    // Report each percent, not each file (packages may have thousands of files)
+    if (done == _total || (done * 100 / _total) != ((done - 1) * 100 / _total)){
+        emit progress(done, _total);
+    }
+}
+
+void PackageExtractor::onFinished(){
+    for (const QStringList &errors : _watcher.future().results()){
+        _errors.append(errors);
+    }
+    _chunks.clear();
+    emit finished(_errors.isEmpty());
+}
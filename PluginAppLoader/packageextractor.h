@@ -0,0 +1,89 @@
+#ifndef PACKAGEEXTRACTOR_H
+#define PACKAGEEXTRACTOR_H
+
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QAtomicInt>
+#include <QFutureWatcher>
+
+
+/// File of a package to extract
+struct tPackageEntry {
+    /// Index of the entry in the package
+    quint32 Index;
+
+    /// Name of the entry in the package (used for messages)
+    QString Name;
+
+    /// Destination file (the folder must exist)
+    QString Destination;
+};
+
+
+///
+/// \brief The PackageExtractor class extracts files of a package (rdkp) on the thread pool without blocking the GUI thread.
+/// The files are split among the threads, each thread opens the package on its own and streams its files directly to their destination.
+/// The CRC of each file is verified while it is extracted.
+///
+class PackageExtractor : public QObject
+{
+    Q_OBJECT
+
+public:
+    PackageExtractor(const QString &package, QObject *parent = nullptr);
+
+    /// Cancels the extraction and waits for the threads
+    ~PackageExtractor();
+
+    /// Start extracting the files (returns immediately)
+    void Start(const QList<tPackageEntry> &entries);
+
+    /// Stop extracting after the files being extracted
+    void Cancel();
+
+    bool IsRunning() const;
+
+    /// Files that could not be extracted (empty on success)
+    QStringList Errors() const;
+
+signals:
+    /// Emitted from the extraction threads when the progress changes
+    void progress(int done, int total);
+
+    /// All the files were processed (successful if no errors)
+    void finished(bool success);
+
+private slots:
+    void onFinished();
+
+private:
+    /// Files extracted by one thread
+    struct tPackageChunk {
+        PackageExtractor *Owner;
+        QList<tPackageEntry> Entries;
+    };
+
+    /// Extract the files of a chunk with a new handle to the package (runs on a thread of the pool). Returns the errors.
+    static QStringList extractChunk(const tPackageChunk &chunk);
+
+    /// Count an extracted file and report the progress
+    void countEntry();
+
+private:
+    QString _package;
+
+    QList<tPackageChunk> _chunks;
+
+    QFutureWatcher<QStringList> _watcher;
+
+    QAtomicInt _done;
+    QAtomicInt _cancel;
+    int _total;
+
+    QStringList _errors;
+};
+
+#endif // PACKAGEEXTRACTOR_H
@@ -0,0 +1,238 @@
+#include "pythonpool.h"
+
+#include <QProcess>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QTemporaryFile>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QDebug>
+
+
+/// Line printed by the launcher once the robodk package is imported
+static const char LauncherReady[] = "RoboDK AppLoader launcher ready";
+
+/// Launcher script: import the robodk package ahead of time, then run one script sent through stdin as a line of JSON
+static const char LauncherScript[] =
+"# Launcher of the AppLoader plugin for RoboDK (generated file)\n"
+"import sys, os, json, runpy\n"
+"try:\n"
+"    from robodk import robolink\n"
+"except ImportError:\n"
+"    try:\n"
+"        import robolink\n"
+"    except ImportError:\n"
+"        pass\n"
+"sys.stdout.write('RoboDK AppLoader launcher ready\\n')\n"
+"sys.stdout.flush()\n"
+"job = sys.stdin.readline()\n"
+"if not job:\n"
+"    sys.exit(0)\n"
+"job = json.loads(job)\n"
+"script = os.path.abspath(job['script'])\n"
+"sys.argv = [script] + job['args']\n"
+"sys.path[0] = os.path.dirname(script)\n"
+"runpy.run_path(script, run_name='__main__')\n";
+
+
+PythonPool::PythonPool(const QString &launcherFile, QObject *parent)
+    : QObject(parent)
+    , _launcherFile(launcherFile)
+    , _size(0)
+{
+}
+
+PythonPool::~PythonPool(){
+    Clear();
+}
+
+void PythonPool::SetSize(int size){
+    _size = qMax(0, size);
+    while (_ready.size() + _starting.size() > _size){
+        QProcess *process = !_ready.isEmpty() ? _ready.takeLast() : _starting.takeLast();
+        process->disconnect(this);
+        process->kill();
+        process->deleteLater();
+    }
+}
+
+int PythonPool::Size() const {
+    return _size;
+}
+
+void PythonPool::Warm(const QString &pythonExec, const QStringList &environment){
+    if (pythonExec != _pythonExec || environment != _environment){
+        // PYTHONPATH or the API port changed: the interpreters must be started again
+        Clear();
+        _pythonExec = pythonExec;
+        _environment = environment;
+    }
+    if (_size <= 0 || _pythonExec.isEmpty() || !writeLauncher()){
+        return;
+    }
+
+    while (_ready.size() + _starting.size() < _size){
+        QProcess *process = startInterpreter(this);
+        connect(process, &QProcess::readyReadStandardOutput, this, &PythonPool::onStartingReadyRead);
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, process](){
+            removeInterpreter(process);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, process](QProcess::ProcessError error){
+            // finished is not emitted if the process could not start
+            if (error == QProcess::FailedToStart){
+                removeInterpreter(process);
+            }
+        });
+        _starting.append(process);
+    }
+}
+
+QProcess *PythonPool::Take(const QString &pythonExec, const QStringList &environment){
+    if (_size <= 0){
+        return nullptr;
+    }
+
+    QProcess *process = nullptr;
+    if (pythonExec == _pythonExec && environment == _environment && !_ready.isEmpty()){
+        process = _ready.takeFirst();
+        process->disconnect(this);
+        process->setParent(nullptr);
+    }
+
+    // Refill the pool
+    Warm(pythonExec, environment);
+    return process;
+}
+
+bool PythonPool::Run(QProcess *process, const QString &script, const QStringList &args){
+    QJsonObject job;
+    job["script"] = script;
+    job["args"] = QJsonArray::fromStringList(args);
+    QByteArray line = QJsonDocument(job).toJson(QJsonDocument::Compact) + "\n";
+    return process->write(line) == line.size();
+}
+
+void PythonPool::Clear(){
+    for (QProcess *process : _starting + _ready){
+        process->disconnect(this);
+        process->kill();
+        process->waitForFinished(1000);
+        delete process;
+    }
+    _starting.clear();
+    _ready.clear();
+}
+
+void PythonPool::onStartingReadyRead(){
+    QProcess *process = qobject_cast<QProcess*>(QObject::sender());
+    if (process == nullptr || !_starting.contains(process)){
+        return;
+    }
+    if (readReady(process)){
+        disconnect(process, &QProcess::readyReadStandardOutput, this, &PythonPool::onStartingReadyRead);
+        _starting.removeAll(process);
+        _ready.append(process);
+    }
+}
+
+void PythonPool::removeInterpreter(QProcess *process){
+    // The interpreter is not started again right away, so an invalid Python setup does not start processes in a loop (it is started again with the next script)
+    qDebug() << "Python interpreter of the pool stopped with exit code " << process->exitCode();
+    qDebug().noquote() << process->readAllStandardError().trimmed();
+    _starting.removeAll(process);
+    _ready.removeAll(process);
+    process->disconnect(this);
+    process->deleteLater();
+}
+
+bool PythonPool::writeLauncher() const {
+    QFile file(_launcherFile);
+    if (file.open(QIODevice::ReadOnly) && file.readAll() == QByteArray(LauncherScript)){
+        return true;
+    }
+    file.close();
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)){
+        qDebug() << "Unable to save the Python launcher: " << _launcherFile;
+        return false;
+    }
+    return file.write(LauncherScript) == qint64(sizeof(LauncherScript) - 1);
+}
+
+QProcess *PythonPool::startInterpreter(QObject *parent) const {
+    QProcess *process = new QProcess(parent);
+    process->setObjectName("Python interpreter pool");
+    process->setEnvironment(_environment);
+    process->start(_pythonExec, QStringList() << _launcherFile);
+    return process;
+}
+
+bool PythonPool::readReady(QProcess *process){
+    while (process->canReadLine()){
+        QByteArray line = process->readLine().trimmed();
+        if (line == LauncherReady){
+            return true;
+        }
+        // output of the robodk import, such as warnings
+        qDebug().noquote() << "Python interpreter pool: " << line;
+    }
+    return false;
+}
+
+QString PythonPool::MeasureLatency(const QString &pythonExec, const QStringList &environment, int runs){
+    QString savedExec(_pythonExec);
+    QStringList savedEnvironment(_environment);
+    _pythonExec = pythonExec;
+    _environment = environment;
+    auto restore = [&](){
+        _pythonExec = savedExec;
+        _environment = savedEnvironment;
+    };
+
+    QTemporaryFile script(QDir::tempPath() + "/AppLoaderLatencyXXXXXX.py");
+    if (!writeLauncher() || !script.open()){
+        restore();
+        return "Unable to create the test script";
+    }
+    script.write("from robodk import robolink\n");
+    script.close();
+
+    runs = qMax(1, runs);
+    qint64 coldMs = 0;
+    qint64 warmMs = 0;
+    for (int i = 0; i < runs; i++){
+        // New process, as when the pool is disabled
+        QElapsedTimer timer;
+        timer.start();
+        QProcess cold;
+        cold.setEnvironment(_environment);
+        cold.start(_pythonExec, QStringList() << script.fileName());
+        if (!cold.waitForFinished(60000) || cold.exitCode() != 0){
+            restore();
+            return "Unable to run Python: " + QString(cold.readAllStandardError()).trimmed();
+        }
+        coldMs += timer.elapsed();
+
+        // Interpreter of the pool: the time to start it is not counted, the pool starts it before it is needed
+        QProcess *warm = startInterpreter(nullptr);
+        bool ready = false;
+        while (!ready && warm->waitForReadyRead(60000)){
+            ready = readReady(warm);
+        }
+        if (!ready){
+            delete warm;
+            restore();
+            return "Unable to start the Python launcher";
+        }
+        timer.restart();
+        Run(warm, script.fileName(), QStringList());
+        warm->waitForFinished(60000);
+        warmMs += timer.elapsed();
+        delete warm;
+    }
+    restore();
+
+    return QString("New process: %1 ms, interpreter pool: %2 ms (average of %3 runs)").arg(coldMs / runs).arg(warmMs / runs).arg(runs);
+}
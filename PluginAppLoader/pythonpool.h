@@ -0,0 +1,92 @@
+#ifndef PYTHONPOOL_H
+#define PYTHONPOOL_H
+
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+
+
+class QProcess;
+
+
+///
+/// \brief The PythonPool class keeps a few Python interpreters started ahead of time, with the robodk package already imported.
+/// Each interpreter runs a small launcher that waits for one script to run (sent through stdin as a line of JSON), runs it as __main__ and exits,
+/// so a script started from the pool behaves like a script started with its own process: same output, same exit code and nothing shared with other scripts.
+/// The pool starts a new interpreter every time one is taken.
+///
+class PythonPool : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// \param launcherFile path where the launcher script is saved
+    PythonPool(const QString &launcherFile, QObject *parent = nullptr);
+    ~PythonPool();
+
+    /// Number of interpreters kept ready (0 disables the pool)
+    void SetSize(int size);
+    int Size() const;
+
+    ///
+    /// \brief Start interpreters until the pool is full. The interpreters started with another Python executable or environment are stopped.
+    /// \param pythonExec Python interpreter
+    /// \param environment environment of the scripts (as in QProcess::setEnvironment)
+    ///
+    void Warm(const QString &pythonExec, const QStringList &environment);
+
+    ///
+    /// \brief Take an interpreter that is ready to run a script, and start another one in the background.
+    /// \return nullptr if no interpreter is ready for this Python executable and environment. The caller owns the process.
+    ///
+    QProcess *Take(const QString &pythonExec, const QStringList &environment);
+
+    /// Run a script in an interpreter returned by Take
+    static bool Run(QProcess *process, const QString &script, const QStringList &args);
+
+    /// Stop all the interpreters of the pool
+    void Clear();
+
+    ///
+    /// \brief Compare the time it takes to run a script that imports the robodk package, with a new process and with an interpreter of the pool.
+    /// Blocks until all the runs are done.
+    /// \return summary of the average times
+    ///
+    QString MeasureLatency(const QString &pythonExec, const QStringList &environment, int runs);
+
+private slots:
+    /// Called on the output of an interpreter that is starting, until the launcher is ready
+    void onStartingReadyRead();
+
+private:
+    /// Called when an interpreter of the pool stopped before it was used
+    void removeInterpreter(QProcess *process);
+
+    /// Save the launcher script if it is missing or outdated
+    bool writeLauncher() const;
+
+    /// Start an interpreter with the launcher
+    QProcess *startInterpreter(QObject *parent) const;
+
+    /// Read the output of an interpreter until the launcher is ready
+    static bool readReady(QProcess *process);
+
+private:
+    QString _launcherFile;
+
+    int _size;
+
+    /// Python executable and environment of the interpreters of the pool
+    QString _pythonExec;
+    QStringList _environment;
+
+    /// Interpreters importing the robodk package
+    QList<QProcess*> _starting;
+
+    /// Interpreters ready to run a script
+    QList<QProcess*> _ready;
+};
+
+#endif // PYTHONPOOL_H
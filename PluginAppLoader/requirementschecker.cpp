@@ -0,0 +1,186 @@
+#include "requirementschecker.h"
+
+#include <QProcess>
+#include <QFile>
+#include <QSettings>
+#include <QCryptographicHash>
+#include <QThread>
+#include <QDebug>
+
+
+RequirementsChecker::RequirementsChecker(const QString &cacheFile, QObject *parent)
+    : QObject(parent)
+    , _cacheFile(cacheFile)
+    , _maxChecks(qBound(1, QThread::idealThreadCount(), 4))
+    , _installProcess(nullptr)
+    , _done(0)
+    , _total(0)
+{
+}
+
+void RequirementsChecker::Check(const QString &appName, const QString &requirementsFile, const QString &pythonExec){
+    if (_pending.contains(requirementsFile)){
+        return;
+    }
+
+    tRequirements requirements;
+    requirements.AppName = appName;
+    requirements.File = requirementsFile;
+    requirements.PythonExec = pythonExec;
+    requirements.Hash = hashRequirements(requirementsFile, pythonExec);
+
+    // Skip the Apps that passed the check with the same requirements and interpreter
+    if (!requirements.Hash.isEmpty()){
+        QSettings cache(_cacheFile, QSettings::IniFormat);
+        if (cache.contains(requirements.Hash)){
+            qDebug() << "All dependencies are installed for " + appName + " (cached)";
+            return;
+        }
+    }
+
+    if (!IsBusy()){
+        _done = 0;
+        _total = 0;
+    }
+    _pending.insert(requirementsFile);
+    _checkQueue.append(requirements);
+    _total++;
+    emit progress(_done, _total);
+    startNext();
+}
+
+bool RequirementsChecker::IsBusy() const {
+    return !_pending.isEmpty();
+}
+
+QString RequirementsChecker::hashRequirements(const QString &requirementsFile, const QString &pythonExec){
+    QFile file(requirementsFile);
+    if (!file.open(QIODevice::ReadOnly)){
+        return QString();
+    }
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(file.readAll());
+    hash.addData(pythonExec.toUtf8());
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+void RequirementsChecker::startNext(){
+    // Check if requirements are missing (several Apps at a time). This is quicker than pip install.
+    while (!_checkQueue.isEmpty() && _checkProcesses.size() < _maxChecks){
+        tRequirements requirements = _checkQueue.takeFirst();
+        QStringList args;
+        args << "-c" << "import pkg_resources; pkg_resources.require(open('" + requirements.File + "',mode='r'))";
+        QProcess *process = startProcess(requirements, args);
+        connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, [this, process](){
+            checkFinished(process);
+        });
+        connect(process, &QProcess::errorOccurred, this, [this, process](QProcess::ProcessError error){
+            // finished is not emitted if the process could not start
+            if (error == QProcess::FailedToStart){
+                process->setProperty("failedToStart", true);
+                checkFinished(process);
+            }
+        });
+        _checkProcesses.append(process);
+        _checkRunning.append(requirements);
+        process->start(requirements.PythonExec, args);
+    }
+
+    // Install the missing requirements one App at a time: pip instances running at the same time may conflict
+    if (_installProcess == nullptr && !_installQueue.isEmpty()){
+        _installRunning = _installQueue.takeFirst();
+        emit installStarted(_installRunning.AppName);
+
+        QStringList args;
+        args << "-m" << "pip" << "install" << "--ignore-installed" << "-r" << _installRunning.File;
+        _installProcess = startProcess(_installRunning, args);
+        connect(_installProcess, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished), this, &RequirementsChecker::installFinished);
+        connect(_installProcess, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error){
+            if (error == QProcess::FailedToStart){
+                _installProcess->setProperty("failedToStart", true);
+                installFinished();
+            }
+        });
+        _installProcess->start(_installRunning.PythonExec, args);
+    }
+}
+
+QProcess *RequirementsChecker::startProcess(const tRequirements &requirements, const QStringList &args){
+    qDebug() << "Python dependencies for " + requirements.AppName << args;
+    QProcess *process = new QProcess(this);
+    process->setProcessChannelMode(QProcess::MergedChannels);
+    connect(process, &QProcess::readyRead, this, &RequirementsChecker::onReadyRead);
+    return process;
+}
+
+void RequirementsChecker::checkFinished(QProcess *process){
+    int index = _checkProcesses.indexOf(process);
+    if (index < 0){
+        return;
+    }
+    _checkProcesses.removeAt(index);
+    tRequirements requirements = _checkRunning.takeAt(index);
+    process->disconnect(this);
+    process->deleteLater();
+
+    if (process->property("failedToStart").toBool() || process->exitStatus() != QProcess::NormalExit){
+        qDebug() << "Unable to check Python dependencies for " + requirements.AppName;
+        complete(requirements, false);
+    } else if (process->exitCode() == 0){ // 1 means something to install
+        qDebug() << "All dependencies are installed for " + requirements.AppName;
+        complete(requirements, true);
+    } else {
+        _installQueue.append(requirements);
+    }
+    startNext();
+}
+
+void RequirementsChecker::installFinished(){
+    QProcess *process = _installProcess;
+    if (process == nullptr){
+        return;
+    }
+    _installProcess = nullptr;
+    process->disconnect(this);
+    process->deleteLater();
+
+    bool passed = !process->property("failedToStart").toBool() &&
+                  process->exitStatus() == QProcess::NormalExit &&
+                  process->exitCode() == 0;
+    if (!passed){
+        emit installFailed(_installRunning.AppName);
+    }
+    complete(_installRunning, passed);
+    startNext();
+}
+
+void RequirementsChecker::onReadyRead(){
+    QProcess* process = qobject_cast<QProcess*>(QObject::sender());
+    if (!process)
+        return;
+
+    while (true)
+    {
+        QByteArray line = process->readLine();
+        if (line.isEmpty())
+            break;
+
+        qDebug().noquote() << "pip: " << line.trimmed();
+    }
+}
+
+void RequirementsChecker::complete(const tRequirements &requirements, bool passed){
+    if (passed && !requirements.Hash.isEmpty()){
+        // Only the results that passed are cached, so failed Apps are checked again on the next load
+        QSettings cache(_cacheFile, QSettings::IniFormat);
+        cache.setValue(requirements.Hash, requirements.File);
+        cache.sync();
+    }
+
+    _pending.remove(requirements.File);
+    _done++;
+    emit progress(_done, _total);
+    if (_pending.isEmpty()){
+        emit finished();
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef REQUIREMENTSCHECKER_H
+#define REQUIREMENTSCHECKER_H
+
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QSet>
+
+
+class QProcess;
+
+
+///
+/// \brief The RequirementsChecker class verifies the Python requirements (requirements.txt) of the Apps without blocking the GUI thread.
+/// The requirements are checked with a few Python processes running at the same time, and the missing requirements are installed with pip, one App at a time.
+/// When the requirements of an App are met, a hash of its requirements.txt and the Python interpreter is saved to a cache file,
+/// so the App is not checked again until one of them changes.
+///
+class RequirementsChecker : public QObject
+{
+    Q_OBJECT
+
+public:
+    RequirementsChecker(const QString &cacheFile, QObject *parent = nullptr);
+
+    ///
+    /// \brief Add the requirements of an App to the queue (returns immediately)
+    /// \param appName name of the App (used for messages)
+    /// \param requirementsFile path to the requirements.txt file
+    /// \param pythonExec Python interpreter
+    ///
+    void Check(const QString &appName, const QString &requirementsFile, const QString &pythonExec);
+
+    /// Returns true if there are requirements being checked or installed
+    bool IsBusy() const;
+
+signals:
+    /// Emitted every time the requirements of an App are processed
+    void progress(int done, int total);
+
+    /// Missing requirements are being installed for an App
+    void installStarted(const QString &appName);
+
+    /// The missing requirements of an App could not be installed
+    void installFailed(const QString &appName);
+
+    /// All the queued requirements were processed
+    void finished();
+
+private slots:
+    /// Called on pip output (eg: print to stdout/default)
+    void onReadyRead();
+
+private:
+    struct tRequirements {
+        QString AppName;
+        QString File;
+        QString PythonExec;
+        QString Hash;
+    };
+
+    /// Hash of the requirements file and the interpreter (empty if the file can't be read)
+    static QString hashRequirements(const QString &requirementsFile, const QString &pythonExec);
+
+    /// Start the queued processes, within the maximum number of processes
+    void startNext();
+
+    QProcess *startProcess(const tRequirements &requirements, const QStringList &args);
+
+    /// Called when a check or the install completes
+    void checkFinished(QProcess *process);
+    void installFinished();
+
+    /// Done with the requirements of an App
+    void complete(const tRequirements &requirements, bool passed);
+
+private:
+    QString _cacheFile;
+
+    /// Maximum number of checks running at the same time
+    int _maxChecks;
+
+    QList<tRequirements> _checkQueue;
+    QList<tRequirements> _installQueue;
+
+    /// Requirements of the running processes
+    QList<QProcess*> _checkProcesses;
+    QList<tRequirements> _checkRunning;
+    QProcess *_installProcess;
+    tRequirements _installRunning;
+
+    /// Requirements files queued or running, to not check the same App twice
+    QSet<QString> _pending;
+
+    int _done;
+    int _total;
+};
+
+#endif // REQUIREMENTSCHECKER_H
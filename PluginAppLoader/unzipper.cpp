@@ -73,6 +73,15 @@ bool Unzipper::entryExtract(const QString& destination, bool overwrite) {
     return (zip_entry_extract(_zip, &callbackExtract, &file) >= 0);
 }
 
+bool Unzipper::entryRead(QByteArray& data) const {
+    if (entryIsDirectory())
+        return false;
+
+    data.resize(static_cast<int>(zip_entry_size(_zip)));
+    ssize_t result = zip_entry_noallocread(_zip, data.data(), static_cast<size_t>(data.size()));
+    return (result == data.size());
+}
+
 bool Unzipper::isOpen() const {
     return (_zip != nullptr);
 }
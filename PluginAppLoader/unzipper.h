@@ -3,6 +3,7 @@
 
 
 #include <QString>
+#include <QByteArray>
 
 
 struct zip_t;
@@ -23,6 +24,7 @@ public:
     QString entryName() const;
     bool entryIsDirectory() const;
     bool entryExtract(const QString& destination, bool overwrite = true);
+    bool entryRead(QByteArray& data) const;
 
     bool isOpen() const;
 
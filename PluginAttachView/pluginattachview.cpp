@@ -106,32 +106,20 @@ static Mat getPoseWrt(Item item1, Item item2, RoboDK *rdk){
 }
 
 
-// Set the pose of the item with respect to the absolute reference frame, accounting for inverse kinematics.
-static void setPoseAbsIK(Item item, Mat pose_abs, Item station){
-    if (item->Type() == IItem::ITEM_TYPE_STATION){
-        return;
-    }
-
-    QList<Item> parents = getAncestors(item);
-    if (parents.size() == 1){
-        item->setPose(pose_abs);
-        return;
-    }
-
-    if (item->Type() == IItem::ITEM_TYPE_TOOL){
-        pose_abs = pose_abs * item->PoseTool().inv() * item->Parent()->PoseTool();
-        item = item->Parent();
-        parents.pop_front();
+// Returns true if both poses are the same (within a tolerance in mm and in the rotation terms).
+static bool samePose(const Mat &pose1, const Mat &pose2, double tolerance = 1e-6){
+    if (!pose1.Valid() || !pose2.Valid()){
+        return false;
     }
 
-    Mat pose = getAncestorPose(parents[0], station).inv() * pose_abs;
-
-    if (item->Type() == IItem::ITEM_TYPE_ROBOT){
-        Mat pose_tool = item->PoseTool();
-        item->setJoints(item->SolveIK(pose, nullptr, &pose_tool));
-    } else {
-        item->setPose(pose);
+    const double *v1 = pose1.ValuesD();
+    const double *v2 = pose2.ValuesD();
+    for (int i = 0; i < 16; i++){
+        if (qAbs(v1[i] - v2[i]) > tolerance){
+            return false;
+        }
     }
+    return true;
 }
 
 //------------------------------- RoboDK Plug-in commands ------------------------------
@@ -241,6 +229,7 @@ QString PluginAttachView::PluginCommand(const QString &command, const QString &v
     // Expected format: "View2Item", "Item". Attach the View to the Item
     //                  "Item2View", "Item". Attach the Item to the View
     //                  "Detach", "". Detach any relationships
+    //                  "IKStats", "" or "reset". Retrieve (or reset) the inverse kinematics counters of the anchor
     //
     // For now, prompting the user for selection is not supported through the PluginCommand.
 
@@ -279,6 +268,14 @@ QString PluginAttachView::PluginCommand(const QString &command, const QString &v
     } else if (command.compare("Detach", Qt::CaseInsensitive) == 0) {
         view_anchor.clear();
         return "OK";
+
+    } else if (command.compare("IKStats", Qt::CaseInsensitive) == 0) {
+        QString stats = QString("requests=%1 solves=%2 avoided=%3 failures=%4")
+                .arg(ik_stats.requests).arg(ik_stats.solves).arg(ik_stats.solves_avoided).arg(ik_stats.failures);
+        if (value.compare("reset", Qt::CaseInsensitive) == 0){
+            ik_stats.clear();
+        }
+        return stats;
     }
 
     return "";
@@ -387,7 +384,7 @@ void PluginAttachView::updateAnchorPose(){
     if (view_anchor.is_master){
         // Set the anchor using the View
         Mat view_pose = vp_2_camabs(RDK->ViewPose().inv());
-        setPoseAbsIK(view_anchor.anchor, view_pose, view_anchor.station);
+        setPoseAbsIK(view_anchor.anchor, view_pose, view_anchor.station, &view_anchor.ik_cache);
     }
 
     RDK->Render(RoboDK::RenderUpdateOnly);
@@ -425,3 +422,62 @@ void PluginAttachView::cleanupRemovedItems() {
         }
     }
 }
+
+
+void PluginAttachView::setPoseAbsIK(Item item, Mat pose_abs, Item station, ik_cache_t *cache){
+    if (item->Type() == IItem::ITEM_TYPE_STATION){
+        return;
+    }
+
+    QList<Item> parents = getAncestors(item);
+    if (parents.size() == 1){
+        item->setPose(pose_abs);
+        return;
+    }
+
+    if (item->Type() == IItem::ITEM_TYPE_TOOL){
+        pose_abs = pose_abs * item->PoseTool().inv() * item->Parent()->PoseTool();
+        item = item->Parent();
+        parents.pop_front();
+    }
+
+    Mat pose = getAncestorPose(parents[0], station).inv() * pose_abs;
+
+    if (item->Type() != IItem::ITEM_TYPE_ROBOT){
+        item->setPose(pose);
+        return;
+    }
+
+    ik_stats.requests++;
+    Mat pose_tool = item->PoseTool();
+    if (cache->robot != item){
+        cache->clear();
+        cache->robot = item;
+    }
+
+    if (cache->valid && samePose(pose, cache->pose_target) && samePose(pose_tool, cache->pose_tool)){
+        // The view did not move with respect to the robot: the last solution is still valid.
+        // Only restore it if the robot was moved by something else in the meantime.
+        ik_stats.solves_avoided++;
+        if (item->Joints().Compare(cache->joints) > 1e-6){
+            item->setJoints(cache->joints);
+        }
+        return;
+    }
+
+    // Seed the solver with the last solution so it converges faster and does not jump between configurations
+    tJoints joints_close = cache->valid ? cache->joints : item->Joints();
+    tJoints joints = item->SolveIK(pose, &joints_close, &pose_tool);
+    ik_stats.solves++;
+    if (!joints.Valid()){
+        ik_stats.failures++;
+        cache->valid = false;
+        return;
+    }
+
+    cache->valid = true;
+    cache->pose_target = pose;
+    cache->pose_tool = pose_tool;
+    cache->joints = joints;
+    item->setJoints(joints);
+}
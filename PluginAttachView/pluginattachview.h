@@ -86,16 +86,56 @@ private:
     QAction *action_slave_view_to_anchor { nullptr };
     QAction *action_slave_anchor_to_view { nullptr };
 
+public:
+    /// Warm-start cache used to move a robot anchor with the view without solving the inverse kinematics from scratch on every frame.
+    struct ik_cache_t
+    {
+        bool valid { false }; // True if the cached joints are a solution for the cached target
+        Item robot { nullptr }; // Robot that was solved (the anchor itself or the parent robot of a tool)
+        Mat pose_target; // Last target pose, with respect to the robot base
+        Mat pose_tool; // Tool pose used to solve the last target
+        tJoints joints; // Last solution, used as joints_close for the next solve
+
+        void clear(){
+            valid = false;
+            robot = nullptr;
+        }
+    };
+
+    /// Counters of the inverse kinematics requests made to move the anchor
+    struct ik_stats_t
+    {
+        qint64 requests { 0 }; // Number of times the robot anchor had to follow the view
+        qint64 solves { 0 }; // Number of calls to SolveIK
+        qint64 solves_avoided { 0 }; // Number of requests served from the cache (target did not change)
+        qint64 failures { 0 }; // Number of calls to SolveIK that did not return a valid solution
+
+        void clear(){
+            requests = 0;
+            solves = 0;
+            solves_avoided = 0;
+            failures = 0;
+        }
+    };
+
+    /// Set the pose of the item with respect to the absolute reference frame, accounting for inverse kinematics.
+    /// Robots are solved using the last solution as a seed, and not solved at all if the target did not change.
+    void setPoseAbsIK(Item item, Mat pose_abs, Item station, ik_cache_t *cache);
+
+private:
+
     struct view_anchor_t
     {
         bool is_master { false }; // True if the view updates the anchor, else the anchor updates the view
         Item anchor { nullptr };
         Item station { nullptr };
+        ik_cache_t ik_cache;
 
         void clear(){
             is_master = false;
             anchor = nullptr;
             station = nullptr;
+            ik_cache.clear();
         }
     };
 
@@ -103,6 +143,8 @@ private:
 
     Item last_clicked_item { nullptr };
 
+    ik_stats_t ik_stats;
+
 
 };
 //! [0]
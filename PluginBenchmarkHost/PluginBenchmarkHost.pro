@@ -0,0 +1,59 @@
+#----------------- HELP --------------
+# PluginBenchmarkHost loads a RoboDK plugin with a mock RoboDK API (no RoboDK required)
+# and runs a benchmark script: see README.md
+#
+# Example:
+# PluginBenchmarkHost ~/RoboDK/bin/plugins/libPluginLVDT.so scripts/lvdt.txt --json lvdt.json
+#------------------------------------
+
+
+#----------------- TEMPLATE --------- (Qt console application)
+TEMPLATE        = app
+CONFIG         += console c++17
+CONFIG         -= app_bundle
+#------------------------------------
+
+QT += widgets
+
+TARGET          = PluginBenchmarkHost
+
+# Remove the console output of the sample kinematics (used by the mock robots)
+DEFINES += SAMPLEKINEMATICS_QUIET
+
+*-clang* {
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-deprecated-declarations
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-deprecated-copy-with-user-provided-copy
+}
+
+*-g++* {
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-comment
+    QMAKE_CXXFLAGS_WARN_ON += -Wno-deprecated-copy
+}
+
+INCLUDEPATH += $$PWD/../robotextensions/samplekinematics
+
+HEADERS += \
+    mockitem.h \
+    mockrobodk.h \
+    ../PluginExample/pluginbenchmark.h \
+    ../robotextensions/samplekinematics/samplekinematics.h
+
+SOURCES += \
+    main.cpp \
+    mockitem.cpp \
+    mockrobodk.cpp \
+    ../PluginExample/pluginbenchmark.cpp \
+    ../robotextensions/samplekinematics/samplekinematics.cpp
+
+DISTFILES += \
+    README.md \
+    scripts/attachobject.txt \
+    scripts/collisionsensor.txt \
+    scripts/lvdt.txt \
+    scripts/opcua.txt
+
+
+#--------------------------
+# Header and source files required by any RoboDK plugin
+# Do not change this section, make sure to have the robodk_interface folder up one folder
+include($$PWD/../robodk_interface/robodk_interface.pri)
@@ -0,0 +1,458 @@
+// PluginBenchmarkHost loads a RoboDK plugin in a mock RoboDK (MockRoboDK) and runs a benchmark script without RoboDK.
+// Usage: PluginBenchmarkHost <plugin library> <script> [--json report.json] [--baseline report.json] [--threshold 0.1] [--verbose]
+// See README.md for the script format.
+
+#include "mockrobodk.h"
+#include "mockitem.h"
+#include "iapprobodk.h"
+#include "../PluginExample/pluginbenchmark.h"
+
+#include <QApplication>
+#include <QMainWindow>
+#include <QMenuBar>
+#include <QStatusBar>
+#include <QMenu>
+#include <QDialog>
+#include <QTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QDateTime>
+#include <QSysInfo>
+#include <QElapsedTimer>
+#include <QPluginLoader>
+#include <QScopedPointer>
+
+#include <cstdio>
+
+
+static bool verbose = false;
+
+// Hide the debug output of the plugins unless --verbose is used
+static void message_handler(QtMsgType type, const QMessageLogContext &context, const QString &msg) {
+    Q_UNUSED(context)
+    if (!verbose && (type == QtDebugMsg || type == QtInfoMsg)) {
+        return;
+    }
+    fprintf(stderr, "%s\n", qPrintable(msg));
+}
+
+static QTextStream &out() {
+    static QTextStream stream(stdout);
+    return stream;
+}
+
+static const QMap<QString, IAppRoboDK::TypeEvent> &event_types() {
+    static const QMap<QString, IAppRoboDK::TypeEvent> events = {
+        {"render", IAppRoboDK::EventRender},
+        {"moved", IAppRoboDK::EventMoved},
+        {"changed", IAppRoboDK::EventChanged},
+        {"changedstation", IAppRoboDK::EventChangedStation},
+        {"about2save", IAppRoboDK::EventAbout2Save},
+        {"about2changestation", IAppRoboDK::EventAbout2ChangeStation},
+        {"about2closestation", IAppRoboDK::EventAbout2CloseStation},
+        {"trajectorystep", IAppRoboDK::EventTrajectoryStep}
+    };
+    return events;
+}
+
+static bool parse_joints(const QString &text, tJoints *joints) {
+    QStringList values = text.split(',');
+    QVector<double> numbers;
+    for (const QString &value : values) {
+        bool ok = false;
+        numbers.append(value.trimmed().toDouble(&ok));
+        if (!ok) {
+            return false;
+        }
+    }
+    *joints = tJoints(numbers.constData(), numbers.size());
+    return true;
+}
+
+
+///
+/// \brief The HostScript class runs the actions of a benchmark script on a plugin loaded in a MockRoboDK.
+/// Each timed action is added to a BenchmarkSuite, so the report has the same JSON format as the benchmark of PluginExample.
+///
+class HostScript {
+public:
+    HostScript(IAppRoboDK *plugin, MockRoboDK *rdk, QMainWindow *mw) : plugin(plugin), rdk(rdk), mw(mw) {
+    }
+
+    /// Run all the lines of a script. Returns false and sets \a error on the first invalid line.
+    bool Run(const QStringList &lines, QString *error);
+
+    const BenchmarkSuite &Suite() const { return suite; }
+
+    /// Number of API calls (MockRoboDK and MockItem) per iteration of a timed action
+    double CallsPerIteration(const QString &name) const { return calls_per_iteration.value(name); }
+
+    /// The plugin is loaded (PluginLoad was called and PluginUnload was not)
+    bool Loaded() const { return loaded; }
+
+private:
+    /// Time an action \a count times (after \a warmup calls) and add the result to the suite
+    void time_action(const QString &name, int warmup, int count, const std::function<void(int)> &action);
+
+    /// Right click an item and trigger the action of the menu whose text matches \a action_text
+    bool click_item(Item item, const QString &action_text);
+
+    bool run_action(const QString &kind, const QStringList &args, const QMap<QString, QString> &options, const QString &line, QString *error);
+
+private:
+    IAppRoboDK *plugin;
+    MockRoboDK *rdk;
+    QMainWindow *mw;
+    BenchmarkSuite suite;
+    bool loaded = false;
+
+    /// API calls per iteration of each timed action, printed with the results
+    QMap<QString, double> calls_per_iteration;
+};
+
+bool HostScript::Run(const QStringList &lines, QString *error) {
+    static const QStringList station_items = {"station", "frame", "object", "target", "program", "robot", "axes", "tool"};
+
+    // Consecutive item lines are loaded together as one station
+    QStringList station_lines;
+    auto flush_station = [&]() {
+        if (station_lines.isEmpty()) {
+            return true;
+        }
+        bool ok = rdk->LoadStation(station_lines, error);
+        station_lines.clear();
+        return ok;
+    };
+
+    for (int line_id = 0; line_id < lines.size(); line_id++) {
+        const QString line = lines[line_id].trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        QStringList words = MockRoboDK::SplitWords(line);
+        const QString kind = words.takeFirst().toLower();
+        if (station_items.contains(kind)) {
+            station_lines.append(line);
+            continue;
+        }
+        if (!flush_station()) {
+            return false;
+        }
+
+        QStringList args;
+        QMap<QString, QString> options;
+        for (const QString &word : words) {
+            int equal = word.indexOf('=');
+            if (equal > 0 && !word.left(equal).contains(',')) {
+                options[word.left(equal).toLower()] = word.mid(equal + 1);
+            } else {
+                args.append(word);
+            }
+        }
+        if (!run_action(kind, args, options, line, error)) {
+            if (error != nullptr) {
+                *error = QString("Line %1: %2").arg(line_id + 1).arg(*error);
+            }
+            return false;
+        }
+    }
+    return flush_station();
+}
+
+void HostScript::time_action(const QString &name, int warmup, int count, const std::function<void(int)> &action) {
+    for (int i = 0; i < warmup; i++) {
+        action(i);
+    }
+    rdk->ResetCalls();
+    QVector<qint64> samples_ns;
+    samples_ns.reserve(count);
+    QElapsedTimer timer;
+    for (int i = 0; i < count; i++) {
+        timer.start();
+        action(i);
+        samples_ns.append(timer.nsecsElapsed());
+    }
+    quint64 ncalls = 0;
+    for (quint64 n : rdk->Calls()) {
+        ncalls += n;
+    }
+    calls_per_iteration[name] = count > 0 ? double(ncalls) / count : 0.0;
+    suite.Add(name, samples_ns);
+}
+
+bool HostScript::click_item(Item item, const QString &action_text) {
+    QMenu menu;
+    plugin->PluginItemClick(item, &menu, IAppRoboDK::ClickRight);
+    if (action_text.isEmpty()) {
+        return true;
+    }
+    for (QAction *action : menu.actions()) {
+        if (action->text().remove('&').compare(action_text, Qt::CaseInsensitive) == 0) {
+            action->trigger();
+            return true;
+        }
+    }
+    return false;
+}
+
+bool HostScript::run_action(const QString &kind, const QStringList &args, const QMap<QString, QString> &options, const QString &line, QString *error) {
+    static const QStringList require_plugin = {"unload", "event", "command", "click", "move", "delete"};
+    if (!loaded && require_plugin.contains(kind)) {
+        *error = "The plugin must be loaded first (load)";
+        return false;
+    }
+
+    const int count = qMax(1, options.value("count", "1").toInt());
+    const int warmup = qMax(0, options.value("warmup", "0").toInt());
+    const QString name = options.value("name", line);
+
+    if (kind == "latency") {
+        // latency <method|*> <microseconds>
+        if (args.size() != 2) {
+            *error = "Expected: latency <method|*> <us>";
+            return false;
+        }
+        rdk->SetLatency(args[0], args[1].toDouble());
+
+    } else if (kind == "load") {
+        // load [settings]: PluginLoad and PluginLoadToolbar
+        time_action(name, 0, 1, [&](int) {
+            plugin->PluginLoad(mw, mw->menuBar(), mw->statusBar(), rdk, args.value(0));
+            plugin->PluginLoadToolbar(mw, 24);
+        });
+        loaded = true;
+
+    } else if (kind == "unload") {
+        time_action(name, 0, 1, [&](int) {
+            plugin->PluginUnload();
+        });
+        loaded = false;
+
+    } else if (kind == "event") {
+        // event <name> [count=N] [warmup=N]
+        const IAppRoboDK::TypeEvent event_type = event_types().value(args.value(0).toLower(), IAppRoboDK::TypeEvent(0));
+        if (event_type == 0) {
+            *error = "Unknown event: " + args.value(0);
+            return false;
+        }
+        time_action(name, warmup, count, [&](int) {
+            plugin->PluginEvent(event_type);
+        });
+
+    } else if (kind == "command") {
+        // command <command> [value] [count=N] [warmup=N]
+        if (args.isEmpty()) {
+            *error = "Expected: command <command> [value]";
+            return false;
+        }
+        QString result;
+        time_action(name, warmup, count, [&](int) {
+            result = plugin->PluginCommand(args[0], args.value(1));
+        });
+        if (verbose) {
+            out() << args[0] << ": " << result << "\n";
+        }
+
+    } else if (kind == "click") {
+        // click <item> [action text] [count=N]
+        Item item = rdk->getItem(args.value(0));
+        if (item == nullptr) {
+            *error = "Item not found: " + args.value(0);
+            return false;
+        }
+        bool found = true;
+        time_action(name, warmup, count, [&](int) {
+            found = click_item(item, args.value(1)) && found;
+        });
+        if (!found) {
+            *error = "Menu action not found: " + args.value(1);
+            return false;
+        }
+
+    } else if (kind == "joints") {
+        // joints <robot> <j1,j2,...>: set the joints without timing (for example, to prepare a state)
+        Item robot = rdk->getItem(args.value(0), IItem::ITEM_TYPE_ROBOT);
+        tJoints joints;
+        if (robot == nullptr || !parse_joints(args.value(1), &joints)) {
+            *error = "Expected: joints <robot> <j1,j2,...>";
+            return false;
+        }
+        robot->setJoints(joints);
+
+    } else if (kind == "move") {
+        // move <robot> <from joints> <to joints> [steps=N] [event=Moved]: move in steps, with one event per step
+        Item robot = rdk->getItem(args.value(0), IItem::ITEM_TYPE_ROBOT);
+        tJoints from;
+        tJoints to;
+        if (robot == nullptr || !parse_joints(args.value(1), &from) || !parse_joints(args.value(2), &to) || from.Length() != to.Length()) {
+            *error = "Expected: move <robot> <j1,j2,...> <j1,j2,...> [steps=N]";
+            return false;
+        }
+        const int steps = qMax(1, options.value("steps", "100").toInt());
+        const IAppRoboDK::TypeEvent event_type = event_types().value(options.value("event", "moved").toLower(), IAppRoboDK::EventMoved);
+        time_action(name, 0, steps, [&](int step) {
+            tJoints joints(from.Length());
+            const double t = (steps > 1) ? double(step) / (steps - 1) : 1.0;
+            for (int i = 0; i < from.Length(); i++) {
+                joints.Data()[i] = from.ValuesD()[i] + (to.ValuesD()[i] - from.ValuesD()[i]) * t;
+            }
+            robot->setJoints(joints);
+            plugin->PluginEvent(event_type);
+        });
+
+    } else if (kind == "delete") {
+        // delete <item>: remove an item and notify the plugin
+        Item item = rdk->getItem(args.value(0));
+        if (item == nullptr) {
+            *error = "Item not found: " + args.value(0);
+            return false;
+        }
+        item->Delete();
+        time_action(name, 0, 1, [&](int) {
+            plugin->PluginEvent(IAppRoboDK::EventChanged);
+        });
+
+    } else if (kind == "stats") {
+        // stats: print the API calls made since the last stats/timed action
+        QMap<QString, quint64> calls = rdk->Calls();
+        out() << "API calls:\n";
+        for (auto it = calls.constBegin(); it != calls.constEnd(); ++it) {
+            out() << QString("  %1 %2\n").arg(it.key(), -28).arg(it.value());
+        }
+        rdk->ResetCalls();
+
+    } else {
+        *error = "Unknown action: " + kind;
+        return false;
+    }
+    return true;
+}
+
+
+int main(int argc, char *argv[]) {
+    if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+    QApplication app(argc, argv);
+
+    QStringList args = app.arguments();
+    args.removeFirst();
+    QString json_path;
+    QString baseline_path;
+    double threshold = 0.10;
+    QStringList positional;
+    for (int i = 0; i < args.size(); i++) {
+        if (args[i] == "--verbose") {
+            verbose = true;
+        } else if (args[i] == "--json" && i + 1 < args.size()) {
+            json_path = args[++i];
+        } else if (args[i] == "--baseline" && i + 1 < args.size()) {
+            baseline_path = args[++i];
+        } else if (args[i] == "--threshold" && i + 1 < args.size()) {
+            threshold = args[++i].toDouble();
+        } else {
+            positional.append(args[i]);
+        }
+    }
+    if (positional.size() != 2) {
+        fprintf(stderr, "Usage: PluginBenchmarkHost <plugin library> <script> [--json report.json] [--baseline report.json] [--threshold 0.1] [--verbose]\n");
+        return 2;
+    }
+    qInstallMessageHandler(message_handler);
+
+    QFile script_file(positional[1]);
+    if (!script_file.open(QFile::ReadOnly | QFile::Text)) {
+        fprintf(stderr, "Unable to open script: %s\n", qPrintable(positional[1]));
+        return 2;
+    }
+    const QStringList lines = QString::fromUtf8(script_file.readAll()).split('\n');
+
+    QPluginLoader loader(positional[0]);
+    IAppRoboDK *plugin = qobject_cast<IAppRoboDK*>(loader.instance());
+    if (plugin == nullptr) {
+        fprintf(stderr, "Unable to load plugin: %s\n", qPrintable(loader.errorString()));
+        return 2;
+    }
+
+    QScopedPointer<QMainWindow> mw(new QMainWindow());
+    QScopedPointer<MockRoboDK> rdk(new MockRoboDK());
+    rdk->on_plugin_command = [plugin](const QString &plugin_name, const QString &command, const QString &value) {
+        if (!plugin_name.isEmpty() && plugin_name != plugin->PluginName()) {
+            return QString();
+        }
+        return plugin->PluginCommand(command, value);
+    };
+
+    // Accept the modal dialogs opened by the plugins (input dialogs keep their default value)
+    QTimer dialog_timer;
+    dialog_timer.setInterval(20);
+    QObject::connect(&dialog_timer, &QTimer::timeout, []() {
+        QDialog *dialog = qobject_cast<QDialog*>(QApplication::activeModalWidget());
+        if (dialog != nullptr) {
+            dialog->accept();
+        }
+    });
+    dialog_timer.start();
+
+    HostScript script(plugin, rdk.data(), mw.data());
+    QString error;
+    if (!script.Run(lines, &error)) {
+        fprintf(stderr, "%s\n", qPrintable(error));
+        return 2;
+    }
+
+    out() << QString("%1 | %2 | %3 | %4 | %5 | %6 | %7 | %8\n").arg("Action", -40).arg("Samples", 7).arg("Mean us", 10)
+             .arg("p50 us", 10).arg("p95 us", 10).arg("p99 us", 10).arg("Max us", 10).arg("API calls", 9);
+    for (const BenchmarkResult &result : script.Suite().Results()) {
+        out() << QString("%1 | %2 | %3 | %4 | %5 | %6 | %7 | %8\n").arg(result.name.left(40), -40).arg(result.samples, 7)
+                 .arg(result.mean_us, 10, 'f', 2).arg(result.p50_us, 10, 'f', 2).arg(result.p95_us, 10, 'f', 2)
+                 .arg(result.p99_us, 10, 'f', 2).arg(result.max_us, 10, 'f', 2)
+                 .arg(script.CallsPerIteration(result.name), 9, 'f', 1);
+    }
+    out().flush();
+
+    QJsonObject environment;
+    environment["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+    environment["host"] = "PluginBenchmarkHost";
+    environment["plugin"] = plugin->PluginName();
+    environment["script"] = QFileInfo(positional[1]).fileName();
+    environment["system"] = QSysInfo::prettyProductName();
+    environment["cpu"] = QSysInfo::currentCpuArchitecture();
+    environment["qt"] = QString(qVersion());
+    const QJsonObject report = script.Suite().ToJson(environment);
+
+    if (!json_path.isEmpty()) {
+        QFile file(json_path);
+        if (!file.open(QFile::WriteOnly)) {
+            fprintf(stderr, "Unable to write report: %s\n", qPrintable(json_path));
+            return 2;
+        }
+        file.write(QJsonDocument(report).toJson());
+    }
+
+    int exit_code = 0;
+    if (!baseline_path.isEmpty()) {
+        QFile file(baseline_path);
+        if (!file.open(QFile::ReadOnly)) {
+            fprintf(stderr, "Unable to open baseline: %s\n", qPrintable(baseline_path));
+            return 2;
+        }
+        BenchmarkComparison comparison = BenchmarkSuite::Compare(report, QJsonDocument::fromJson(file.readAll()).object(), threshold);
+        for (const QString &line : comparison.lines) {
+            out() << line << "\n";
+        }
+        if (!comparison.regressions.isEmpty()) {
+            out() << "Regressions: " << comparison.regressions.join(", ") << "\n";
+            exit_code = 1;
+        }
+        out().flush();
+    }
+
+    if (script.Loaded()) {
+        plugin->PluginUnload();
+    }
+    return exit_code;
+}
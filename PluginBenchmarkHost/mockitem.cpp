@@ -0,0 +1,1049 @@
+#include "mockitem.h"
+#include "mockrobodk.h"
+
+#include "samplekinematics.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+// Layout of the robot parameters used by samplekinematics (see the iRobot_... functions in samplekinematics.cpp)
+static const int ROBOT_PARAMS_SIZE = 100 * 20;
+static const int ROBOT_PARAMS_NDOFS = 1 * 20 + 1;
+static const int ROBOT_PARAMS_SENSES = 3 * 20 + 4;
+static const int ROBOT_PARAMS_DHM = 10 * 20;
+static const int ROBOT_PARAMS_LOWER = 30 * 20;
+static const int ROBOT_PARAMS_UPPER = 31 * 20;
+
+// Weight of the orientation error of the inverse kinematics (mm per rad)
+static const double IK_ROTATION_WEIGHT = 1000.0;
+
+
+// Orientation error between 2 poses (rad): 0.5 * (n1 x n2 + o1 x o2 + a1 x a2). Poses are column-major arrays.
+static void rotation_error(const double pose1[16], const double pose2[16], double error[3]) {
+    error[0] = error[1] = error[2] = 0.0;
+    for (int axis = 0; axis < 3; axis++) {
+        const double *v1 = pose1 + 4 * axis;
+        const double *v2 = pose2 + 4 * axis;
+        error[0] += 0.5 * (v1[1] * v2[2] - v1[2] * v2[1]);
+        error[1] += 0.5 * (v1[2] * v2[0] - v1[0] * v2[2]);
+        error[2] += 0.5 * (v1[0] * v2[1] - v1[1] * v2[0]);
+    }
+}
+
+// Weighted pose error [x, y, z, rx, ry, rz] to go from pose1 to pose2
+static void pose_error(const double pose1[16], const double pose2[16], double error[6]) {
+    for (int i = 0; i < 3; i++) {
+        error[i] = pose2[12 + i] - pose1[12 + i];
+    }
+    rotation_error(pose1, pose2, error + 3);
+    for (int i = 3; i < 6; i++) {
+        error[i] *= IK_ROTATION_WEIGHT;
+    }
+}
+
+// Solve the 6x6 linear system a * x = b in place (Gaussian elimination with partial pivoting)
+static bool solve6(double a[6][6], double b[6]) {
+    for (int col = 0; col < 6; col++) {
+        int pivot = col;
+        for (int row = col + 1; row < 6; row++) {
+            if (std::fabs(a[row][col]) > std::fabs(a[pivot][col])) {
+                pivot = row;
+            }
+        }
+        if (std::fabs(a[pivot][col]) < 1e-12) {
+            return false;
+        }
+        if (pivot != col) {
+            std::swap(a[pivot], a[col]);
+            std::swap(b[pivot], b[col]);
+        }
+        for (int row = col + 1; row < 6; row++) {
+            double factor = a[row][col] / a[col][col];
+            for (int k = col; k < 6; k++) {
+                a[row][k] -= factor * a[col][k];
+            }
+            b[row] -= factor * b[col];
+        }
+    }
+    for (int row = 5; row >= 0; row--) {
+        for (int k = row + 1; k < 6; k++) {
+            b[row] -= a[row][k] * b[k];
+        }
+        b[row] /= a[row][row];
+    }
+    return true;
+}
+
+
+MockItem::MockItem(MockRoboDK *rdk, int type, const QString &name, MockItem *parent) :
+    rdk(rdk), type(type), name(name), parent(parent), pose_tool(), pose_frame() {
+    if (parent != nullptr) {
+        parent->children.append(this);
+    }
+}
+
+MockItem::~MockItem() {
+}
+
+void MockItem::setKinematics(const QVector<QVector<double>> &dh, const QVector<bool> &prismatic) {
+    const int ndofs = qMin(static_cast<int>(dh.size()), RDK_SIZE_JOINTS_MAX);
+    robot_params.fill(0.0, ROBOT_PARAMS_SIZE);
+    robot_params[ROBOT_PARAMS_NDOFS] = ndofs;
+    for (int i = 0; i < ndofs; i++) {
+        const QVector<double> &row = dh[i];
+        double *dhm = robot_params.data() + ROBOT_PARAMS_DHM + 20 * i;
+        dhm[0] = row.value(0) * M_PI / 180.0;
+        dhm[1] = row.value(1);
+        dhm[2] = row.value(2) * M_PI / 180.0;
+        dhm[3] = row.value(3);
+        dhm[4] = prismatic.value(i, false) ? 1.0 : 0.0;
+        robot_params[ROBOT_PARAMS_SENSES + i] = 1.0;
+        robot_params[ROBOT_PARAMS_LOWER + i] = -180.0;
+        robot_params[ROBOT_PARAMS_UPPER + i] = 180.0;
+    }
+
+    joints = tJoints(ndofs);
+    joints_home = tJoints(ndofs);
+    lower_limits = tJoints(ndofs);
+    upper_limits = tJoints(ndofs);
+    for (int i = 0; i < ndofs; i++) {
+        lower_limits.Data()[i] = -180.0;
+        upper_limits.Data()[i] = 180.0;
+    }
+}
+
+int MockItem::DOFs() const {
+    return robot_params.isEmpty() ? 0 : static_cast<int>(robot_params[ROBOT_PARAMS_NDOFS]);
+}
+
+Mat MockItem::ChildrenPoseAbs() {
+    Mat base = pose_abs();
+    Mat flange;
+    if (DOFs() > 0 && flange_pose(joints.ValuesD(), &flange)) {
+        return base * flange;
+    }
+    return base;
+}
+
+MockItem *MockItem::Station() {
+    MockItem *item = this;
+    while (item->parent != nullptr) {
+        item = item->parent;
+    }
+    return item->type == ITEM_TYPE_STATION ? item : nullptr;
+}
+
+void MockItem::setProgramPath(const QList<tJoints> &path) {
+    program_path = path;
+}
+
+bool MockItem::flange_pose(const double *q, Mat *flange, QList<Mat> *joint_poses) const {
+    const int ndofs = DOFs();
+    double values[16];
+    if (joint_poses != nullptr) {
+        QVector<double> all(16 * (ndofs + 1));
+        if (::SolveFK_CAD(q, values, all.data(), ndofs + 1, robot_params.constData()) != 1) {
+            return false;
+        }
+        for (int i = 0; i <= ndofs; i++) {
+            joint_poses->append(Mat(all.constData() + 16 * i));
+        }
+    } else if (::SolveFK(q, values, robot_params.constData()) != 1) {
+        return false;
+    }
+    *flange = Mat(values);
+    return true;
+}
+
+bool MockItem::solve_ik(const Mat &flange, const tJoints &seed, tJoints *result) const {
+    const int ndofs = DOFs();
+    if (ndofs == 0) {
+        return false;
+    }
+    const double *params = robot_params.constData();
+    double target[16];
+    std::copy(flange.ValuesD(), flange.ValuesD() + 16, target);
+
+    double q[RDK_SIZE_JOINTS_MAX] = {};
+    for (int i = 0; i < ndofs; i++) {
+        q[i] = i < seed.Length() ? seed.ValuesD()[i] : joints.ValuesD()[i];
+    }
+
+    // Damped least squares with a finite differences Jacobian (in double precision: Mat stores floats)
+    const double step = 1e-5;
+    const double damping = 1e-3;
+    for (int iteration = 0; iteration < 100; iteration++) {
+        double current[16];
+        if (::SolveFK(q, current, params) != 1) {
+            return false;
+        }
+        double error[6];
+        pose_error(current, target, error);
+        double norm = 0.0;
+        for (int i = 0; i < 6; i++) {
+            norm += error[i] * error[i];
+        }
+        if (norm < 1e-6) {
+            *result = tJoints(q, ndofs);
+            return true;
+        }
+
+        double jacobian[6][RDK_SIZE_JOINTS_MAX];
+        for (int j = 0; j < ndofs; j++) {
+            double q_step[RDK_SIZE_JOINTS_MAX];
+            std::copy(q, q + ndofs, q_step);
+            q_step[j] += step;
+            double moved[16];
+            if (::SolveFK(q_step, moved, params) != 1) {
+                q_step[j] -= 2 * step;
+                if (::SolveFK(q_step, moved, params) != 1) {
+                    return false;
+                }
+            }
+            double delta[6];
+            pose_error(current, moved, delta);
+            const double sign = q_step[j] > q[j] ? 1.0 : -1.0;
+            for (int i = 0; i < 6; i++) {
+                jacobian[i][j] = sign * delta[i] / step;
+            }
+        }
+
+        // dq = J' * (J * J' + damping * I)^-1 * error
+        double jjt[6][6];
+        for (int r = 0; r < 6; r++) {
+            for (int c = 0; c < 6; c++) {
+                double sum = (r == c) ? damping : 0.0;
+                for (int j = 0; j < ndofs; j++) {
+                    sum += jacobian[r][j] * jacobian[c][j];
+                }
+                jjt[r][c] = sum;
+            }
+        }
+        if (!solve6(jjt, error)) {
+            return false;
+        }
+        for (int j = 0; j < ndofs; j++) {
+            double dq = 0.0;
+            for (int i = 0; i < 6; i++) {
+                dq += jacobian[i][j] * error[i];
+            }
+            q[j] = qBound(lower_limits.ValuesD()[j], q[j] + dq, upper_limits.ValuesD()[j]);
+        }
+    }
+    return false;
+}
+
+bool MockItem::move_joints(const tJoints &target) {
+    if (DOFs() == 0 || target.Length() < DOFs()) {
+        return false;
+    }
+    joints.SetValues(target.ValuesD(), DOFs());
+    return true;
+}
+
+Mat MockItem::pose_abs() {
+    if (parent == nullptr) {
+        return pose;
+    }
+    return parent->ChildrenPoseAbs() * pose;
+}
+
+MockItem *MockItem::robot() {
+    if (DOFs() > 0) {
+        return this;
+    }
+    MockItem *linked = static_cast<MockItem*>(links.value(ITEM_TYPE_ROBOT, nullptr));
+    if (linked != nullptr) {
+        return linked;
+    }
+    for (MockItem *item = parent; item != nullptr; item = item->parent) {
+        if (item->DOFs() > 0) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
+
+//------------------------------- IItem ------------------------------
+
+int MockItem::Type() {
+    rdk->Call("Type");
+    return type;
+}
+
+bool MockItem::Save(const QString &filename) {
+    rdk->Call("Item::Save");
+    Q_UNUSED(filename)
+    return false;
+}
+
+void MockItem::Delete() {
+    rdk->Call("Delete");
+    rdk->RemoveItem(this);
+}
+
+void MockItem::setParent(Item new_parent) {
+    rdk->Call("setParent");
+    MockItem *item = static_cast<MockItem*>(new_parent);
+    if (item == nullptr || item == parent) {
+        return;
+    }
+    if (parent != nullptr) {
+        parent->children.removeAll(this);
+    }
+    parent = item;
+    parent->children.append(this);
+}
+
+void MockItem::setParentStatic(Item new_parent) {
+    rdk->Call("setParentStatic");
+    MockItem *item = static_cast<MockItem*>(new_parent);
+    if (item == nullptr || item == parent) {
+        return;
+    }
+    Mat pose_absolute = pose_abs();
+    if (parent != nullptr) {
+        parent->children.removeAll(this);
+    }
+    parent = item;
+    parent->children.append(this);
+    pose = parent->ChildrenPoseAbs().Inverted() * pose_absolute;
+}
+
+Item MockItem::Parent() {
+    rdk->Call("Parent");
+    return parent;
+}
+
+QList<Item> MockItem::Childs() {
+    rdk->Call("Childs");
+    return children;
+}
+
+bool MockItem::Visible() {
+    rdk->Call("Visible");
+    return visible;
+}
+
+void MockItem::setVisible(bool is_visible, int visible_frame) {
+    rdk->Call("setVisible");
+    Q_UNUSED(visible_frame)
+    visible = is_visible;
+}
+
+QString MockItem::Name() {
+    rdk->Call("Name");
+    return name;
+}
+
+void MockItem::setName(const QString &new_name) {
+    rdk->Call("setName");
+    name = new_name;
+}
+
+QString MockItem::Command(const QString &cmd, const QString &value) {
+    rdk->Call("Item::Command");
+    if (value.isEmpty()) {
+        return params.value(cmd);
+    }
+    params[cmd] = value;
+    return "OK";
+}
+
+bool MockItem::setPose(const Mat new_pose) {
+    rdk->Call("setPose");
+    pose = new_pose;
+    return true;
+}
+
+Mat MockItem::Pose() {
+    rdk->Call("Pose");
+    return pose;
+}
+
+void MockItem::setGeometryPose(Mat new_pose, bool apply_transf) {
+    rdk->Call("setGeometryPose");
+    Q_UNUSED(apply_transf)
+    geometry_pose = new_pose;
+}
+
+Mat MockItem::GeometryPose() {
+    rdk->Call("GeometryPose");
+    return geometry_pose;
+}
+
+Mat MockItem::PoseTool() {
+    rdk->Call("PoseTool");
+    MockItem *tool = static_cast<MockItem*>(links.value(ITEM_TYPE_TOOL, nullptr));
+    return tool != nullptr ? tool->pose_tool : pose_tool;
+}
+
+Mat MockItem::PoseFrame() {
+    rdk->Call("PoseFrame");
+    MockItem *frame = static_cast<MockItem*>(links.value(ITEM_TYPE_FRAME, nullptr));
+    return frame != nullptr ? frame->pose : pose_frame;
+}
+
+void MockItem::setPoseFrame(const Mat frame_pose) {
+    rdk->Call("setPoseFrame");
+    pose_frame = frame_pose;
+}
+
+void MockItem::setPoseFrame(const Item frame_item) {
+    rdk->Call("setPoseFrame");
+    links[ITEM_TYPE_FRAME] = frame_item;
+}
+
+void MockItem::setPoseTool(const Mat tool_pose) {
+    rdk->Call("setPoseTool");
+    pose_tool = tool_pose;
+}
+
+void MockItem::setPoseTool(const Item tool_item) {
+    rdk->Call("setPoseTool");
+    links[ITEM_TYPE_TOOL] = tool_item;
+}
+
+void MockItem::setPoseAbs(const Mat pose_absolute) {
+    rdk->Call("setPoseAbs");
+    if (parent != nullptr) {
+        pose = parent->ChildrenPoseAbs().Inverted() * pose_absolute;
+    } else {
+        pose = pose_absolute;
+    }
+}
+
+Mat MockItem::PoseAbs() {
+    rdk->Call("PoseAbs");
+    return pose_abs();
+}
+
+void MockItem::setColor(const tColor &clr) {
+    rdk->Call("setColor");
+    color = clr;
+}
+
+void MockItem::Scale(double scale) {
+    rdk->Call("Scale");
+    Q_UNUSED(scale)
+}
+
+void MockItem::Scale(double scale_xyz[3]) {
+    rdk->Call("Scale");
+    Q_UNUSED(scale_xyz)
+}
+
+void MockItem::setAsCartesianTarget() {
+    rdk->Call("setAsCartesianTarget");
+    joint_target = false;
+}
+
+void MockItem::setAsJointTarget() {
+    rdk->Call("setAsJointTarget");
+    joint_target = true;
+}
+
+bool MockItem::isJointTarget() {
+    rdk->Call("isJointTarget");
+    return joint_target;
+}
+
+tJoints MockItem::Joints() {
+    rdk->Call("Joints");
+    return joints;
+}
+
+tJoints MockItem::JointsHome() {
+    rdk->Call("JointsHome");
+    return joints_home;
+}
+
+void MockItem::setJointsHome(const tJoints &jnts) {
+    rdk->Call("setJointsHome");
+    joints_home = jnts;
+}
+
+Item MockItem::ObjectLink(int link_id) {
+    rdk->Call("ObjectLink");
+    Q_UNUSED(link_id)
+    return this;
+}
+
+Item MockItem::getLink(int type_linked) {
+    rdk->Call("getLink");
+    if (type_linked == ITEM_TYPE_ROBOT) {
+        return robot();
+    }
+    return links.value(type_linked, nullptr);
+}
+
+void MockItem::setJoints(const tJoints &jnts) {
+    rdk->Call("setJoints");
+    if (DOFs() > 0) {
+        move_joints(jnts);
+    } else {
+        joints = jnts;
+    }
+}
+
+int MockItem::JointLimits(tJoints *lower, tJoints *upper) {
+    rdk->Call("JointLimits");
+    if (lower != nullptr) {
+        *lower = lower_limits;
+    }
+    if (upper != nullptr) {
+        *upper = upper_limits;
+    }
+    return DOFs() > 0 ? 1 : 0;
+}
+
+int MockItem::setJointLimits(const tJoints &lower, const tJoints &upper) {
+    rdk->Call("setJointLimits");
+    const int ndofs = DOFs();
+    if (ndofs == 0 || lower.Length() < ndofs || upper.Length() < ndofs) {
+        return 0;
+    }
+    lower_limits.SetValues(lower.ValuesD(), ndofs);
+    upper_limits.SetValues(upper.ValuesD(), ndofs);
+    for (int i = 0; i < ndofs; i++) {
+        robot_params[ROBOT_PARAMS_LOWER + i] = lower.ValuesD()[i];
+        robot_params[ROBOT_PARAMS_UPPER + i] = upper.ValuesD()[i];
+    }
+    return 1;
+}
+
+void MockItem::setRobot(const Item &item) {
+    rdk->Call("setRobot");
+    links[ITEM_TYPE_ROBOT] = item;
+}
+
+Item MockItem::AddTool(const Mat &tool_pose, const QString &tool_name) {
+    rdk->Call("AddTool");
+    MockItem *tool = rdk->AddItem(ITEM_TYPE_TOOL, tool_name, this);
+    tool->pose_tool = tool_pose;
+    links[ITEM_TYPE_TOOL] = tool;
+    return tool;
+}
+
+Mat MockItem::SolveFK(const tJoints &jnts, const Mat *tool_pose, const Mat *reference_pose) {
+    rdk->Call("SolveFK");
+    Mat flange;
+    if (DOFs() == 0 || jnts.Length() < DOFs() || !flange_pose(jnts.ValuesD(), &flange)) {
+        return Mat(false);
+    }
+    if (tool_pose != nullptr) {
+        flange = flange * (*tool_pose);
+    }
+    if (reference_pose != nullptr) {
+        flange = reference_pose->Inverted() * flange;
+    }
+    return flange;
+}
+
+void MockItem::JointsConfig(const tJoints &jnts, tConfig config) {
+    rdk->Call("JointsConfig");
+    double rlf[3] = {0.0, 0.0, 0.0};
+    if (DOFs() >= 5 && jnts.Length() >= DOFs()) {
+        ::Joints2Config(jnts.ValuesD(), rlf, robot_params.constData());
+    }
+    for (int i = 0; i < RDK_SIZE_MAX_CONFIG; i++) {
+        config[i] = (i < 3) ? rlf[i] : 0.0;
+    }
+}
+
+tJoints MockItem::SolveIK(const Mat &target, const tJoints *joints_close, const Mat *tool_pose, const Mat *reference_pose) {
+    rdk->Call("SolveIK");
+    Mat flange = target;
+    if (reference_pose != nullptr) {
+        flange = (*reference_pose) * flange;
+    }
+    if (tool_pose != nullptr) {
+        flange = flange * tool_pose->Inverted();
+    }
+    tJoints solution;
+    if (!solve_ik(flange, joints_close != nullptr ? *joints_close : joints, &solution)) {
+        return tJoints();
+    }
+    return solution;
+}
+
+QList<tJoints> MockItem::SolveIK_All(const Mat &target, const Mat *tool_pose, const Mat *reference_pose) {
+    rdk->Call("SolveIK_All");
+    Mat flange = target;
+    if (reference_pose != nullptr) {
+        flange = (*reference_pose) * flange;
+    }
+    if (tool_pose != nullptr) {
+        flange = flange * tool_pose->Inverted();
+    }
+    QList<tJoints> solutions;
+    tJoints solution;
+    if (solve_ik(flange, joints, &solution)) {
+        solutions.append(solution);
+    }
+    return solutions;
+}
+
+bool MockItem::Connect(const QString &robot_ip) {
+    rdk->Call("Connect");
+    Q_UNUSED(robot_ip)
+    return false;
+}
+
+bool MockItem::Disconnect() {
+    rdk->Call("Disconnect");
+    return true;
+}
+
+bool MockItem::MoveJ(const Item &itemtarget) {
+    rdk->Call("MoveJ");
+    MockItem *target = static_cast<MockItem*>(itemtarget);
+    if (target == nullptr) {
+        return false;
+    }
+    if (target->joint_target) {
+        return move_joints(target->joints);
+    }
+    tJoints solution;
+    return solve_ik(ChildrenPoseAbs().Inverted() * target->PoseAbs(), joints, &solution) && move_joints(solution);
+}
+
+bool MockItem::MoveJ(const tJoints &jnts) {
+    rdk->Call("MoveJ");
+    return move_joints(jnts);
+}
+
+bool MockItem::MoveJ(const Mat &target) {
+    rdk->Call("MoveJ");
+    tJoints solution;
+    return solve_ik(target, joints, &solution) && move_joints(solution);
+}
+
+bool MockItem::MoveL(const Item &itemtarget) {
+    rdk->Call("MoveL");
+    return MoveJ(itemtarget);
+}
+
+bool MockItem::MoveL(const tJoints &jnts) {
+    rdk->Call("MoveL");
+    return move_joints(jnts);
+}
+
+bool MockItem::MoveL(const Mat &target) {
+    rdk->Call("MoveL");
+    tJoints solution;
+    return solve_ik(target, joints, &solution) && move_joints(solution);
+}
+
+bool MockItem::MoveC(const Item &itemtarget1, const Item &itemtarget2) {
+    rdk->Call("MoveC");
+    Q_UNUSED(itemtarget1)
+    return MoveJ(itemtarget2);
+}
+
+bool MockItem::MoveC(const tJoints &joints1, const tJoints &joints2) {
+    rdk->Call("MoveC");
+    Q_UNUSED(joints1)
+    return move_joints(joints2);
+}
+
+bool MockItem::MoveC(const Mat &target1, const Mat &target2) {
+    rdk->Call("MoveC");
+    Q_UNUSED(target1)
+    tJoints solution;
+    return solve_ik(target2, joints, &solution) && move_joints(solution);
+}
+
+int MockItem::MoveJ_Test(const tJoints &j1, const tJoints &j2, double minstep_deg) {
+    rdk->Call("MoveJ_Test");
+    Q_UNUSED(j1)
+    Q_UNUSED(j2)
+    Q_UNUSED(minstep_deg)
+    return 0;
+}
+
+int MockItem::MoveL_Test(const tJoints &joints1, const Mat &pose2, double minstep_mm) {
+    rdk->Call("MoveL_Test");
+    Q_UNUSED(minstep_mm)
+    tJoints solution;
+    return solve_ik(pose2, joints1, &solution) ? 0 : -1;
+}
+
+void MockItem::setSpeed(double speed_linear, double accel_linear, double speed_joints, double accel_joints) {
+    rdk->Call("setSpeed");
+    Q_UNUSED(speed_linear)
+    Q_UNUSED(accel_linear)
+    Q_UNUSED(speed_joints)
+    Q_UNUSED(accel_joints)
+}
+
+void MockItem::setRounding(double zonedata) {
+    rdk->Call("setRounding");
+    Q_UNUSED(zonedata)
+}
+
+void MockItem::ShowSequence(tMatrix2D *sequence) {
+    rdk->Call("ShowSequence");
+    Q_UNUSED(sequence)
+}
+
+bool MockItem::Busy() {
+    rdk->Call("Busy");
+    return false;
+}
+
+void MockItem::Stop() {
+    rdk->Call("Stop");
+}
+
+bool MockItem::MakeProgram(const QString &filename) {
+    rdk->Call("MakeProgram");
+    Q_UNUSED(filename)
+    return false;
+}
+
+void MockItem::setRunType(int program_run_type) {
+    rdk->Call("setRunType");
+    Q_UNUSED(program_run_type)
+}
+
+bool MockItem::RunProgram(const QString &params_run) {
+    rdk->Call("Item::RunProgram");
+    Q_UNUSED(params_run)
+    MockItem *linked = robot();
+    if (linked != nullptr && !program_path.isEmpty()) {
+        linked->move_joints(program_path.last());
+    }
+    return true;
+}
+
+int MockItem::RunInstruction(const QString &code, int run_type) {
+    rdk->Call("RunInstruction");
+    Q_UNUSED(code)
+    Q_UNUSED(run_type)
+    return 0;
+}
+
+void MockItem::Pause(double time_ms) {
+    rdk->Call("Pause");
+    Q_UNUSED(time_ms)
+}
+
+void MockItem::setDO(const QString &io_var, const QString &io_value) {
+    rdk->Call("setDO");
+    params[io_var] = io_value;
+}
+
+void MockItem::waitDI(const QString &io_var, const QString &io_value, double timeout_ms) {
+    rdk->Call("waitDI");
+    Q_UNUSED(io_var)
+    Q_UNUSED(io_value)
+    Q_UNUSED(timeout_ms)
+}
+
+void MockItem::customInstruction(const QString &ins_name, const QString &path_run, const QString &path_icon, bool blocking, const QString &cmd_run_on_robot) {
+    rdk->Call("customInstruction");
+    Q_UNUSED(ins_name)
+    Q_UNUSED(path_run)
+    Q_UNUSED(path_icon)
+    Q_UNUSED(blocking)
+    Q_UNUSED(cmd_run_on_robot)
+}
+
+void MockItem::ShowInstructions(bool show) {
+    rdk->Call("ShowInstructions");
+    Q_UNUSED(show)
+}
+
+void MockItem::ShowTargets(bool show) {
+    rdk->Call("ShowTargets");
+    Q_UNUSED(show)
+}
+
+int MockItem::InstructionCount() {
+    rdk->Call("InstructionCount");
+    return program_path.size();
+}
+
+void MockItem::InstructionAt(int ins_id, QString &ins_name, int &instype, int &movetype, bool &isjointtarget, Mat &target, tJoints &jnts) {
+    rdk->Call("InstructionAt");
+    ins_name = QString("MoveJ %1").arg(ins_id + 1);
+    instype = IRoboDK::INS_TYPE_MOVE;
+    movetype = IRoboDK::MOVE_TYPE_JOINT;
+    isjointtarget = true;
+    jnts = program_path.value(ins_id);
+    MockItem *linked = robot();
+    target = (linked != nullptr && jnts.Length() > 0) ? linked->SolveFK(jnts) : Mat(false);
+}
+
+void MockItem::setInstruction(int ins_id, const QString &ins_name, int instype, int movetype, bool isjointtarget, const Mat &target, const tJoints &jnts) {
+    rdk->Call("setInstruction");
+    Q_UNUSED(ins_name)
+    Q_UNUSED(instype)
+    Q_UNUSED(movetype)
+    Q_UNUSED(isjointtarget)
+    Q_UNUSED(target)
+    if (ins_id >= 0 && ins_id < program_path.size()) {
+        program_path[ins_id] = jnts;
+    }
+}
+
+int MockItem::InstructionList(tMatrix2D *instructions) {
+    rdk->Call("InstructionList");
+    Q_UNUSED(instructions)
+    return -1;
+}
+
+double MockItem::Update(double out_nins_time_dist[4], int collision_check, double mm_step, double deg_step) {
+    rdk->Call("Update");
+    Q_UNUSED(collision_check)
+    Q_UNUSED(mm_step)
+    Q_UNUSED(deg_step)
+    out_nins_time_dist[0] = program_path.size();
+    out_nins_time_dist[1] = 0.0;
+    out_nins_time_dist[2] = 0.0;
+    out_nins_time_dist[3] = 0.0;
+    return 1.0;
+}
+
+Item MockItem::setMachiningParameters(const QString &ncfile, Item part_obj, const QString &options) {
+    rdk->Call("setMachiningParameters");
+    Q_UNUSED(ncfile)
+    Q_UNUSED(part_obj)
+    Q_UNUSED(options)
+    return nullptr;
+}
+
+int MockItem::ConnectedState(QString *msg) {
+    rdk->Call("ConnectedState");
+    if (msg != nullptr) {
+        *msg = "Not connected (mock)";
+    }
+    return -1;
+}
+
+bool MockItem::Selected() {
+    rdk->Call("Selected");
+    return false;
+}
+
+bool MockItem::Collided(int *id) {
+    rdk->Call("Collided");
+    if (id != nullptr) {
+        *id = 0;
+    }
+    return false;
+}
+
+bool MockItem::JointsValid(const tJoints &jnts) {
+    rdk->Call("JointsValid");
+    const int ndofs = DOFs();
+    if (ndofs == 0 || jnts.Length() < ndofs) {
+        return false;
+    }
+    for (int i = 0; i < ndofs; i++) {
+        if (jnts.ValuesD()[i] < lower_limits.ValuesD()[i] || jnts.ValuesD()[i] > upper_limits.ValuesD()[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int MockItem::RunType() {
+    rdk->Call("RunType");
+    return 0;
+}
+
+bool MockItem::Scale(const double scalexyz[3], const Mat *tr_pre_scale, const Mat *tr_post_scale) {
+    rdk->Call("Scale");
+    Q_UNUSED(scalexyz)
+    Q_UNUSED(tr_pre_scale)
+    Q_UNUSED(tr_post_scale)
+    return true;
+}
+
+Item MockItem::InstructionTargetAt(int ins_id) {
+    rdk->Call("InstructionTargetAt");
+    Q_UNUSED(ins_id)
+    return nullptr;
+}
+
+Item MockItem::AttachClosest() {
+    rdk->Call("AttachClosest");
+    return nullptr;
+}
+
+Item MockItem::DetachClosest(Item new_parent) {
+    rdk->Call("DetachClosest");
+    Q_UNUSED(new_parent)
+    return nullptr;
+}
+
+void MockItem::DetachAll(Item new_parent) {
+    rdk->Call("DetachAll");
+    Q_UNUSED(new_parent)
+}
+
+int MockItem::InstructionListJoints(QString &error_msg, tMatrix2D *matrix, double step_mm, double step_deg, int check_collisions, int flags, double time_step) {
+    rdk->Call("InstructionListJoints");
+    Q_UNUSED(step_mm)
+    Q_UNUSED(check_collisions)
+    Q_UNUSED(flags)
+    Q_UNUSED(time_step)
+
+    // Joint moves between the joint targets of the program, split by step_deg
+    MockItem *linked = robot();
+    if (linked == nullptr || program_path.isEmpty()) {
+        error_msg = "Program without robot or instructions";
+        return -1;
+    }
+    const int ndofs = linked->DOFs();
+    QList<tJoints> steps;
+    steps.append(program_path.first());
+    QList<int> move_ids;
+    move_ids.append(0);
+    for (int m = 1; m < program_path.size(); m++) {
+        const tJoints &from = program_path[m - 1];
+        const tJoints &to = program_path[m];
+        double distance = 0.0;
+        for (int i = 0; i < ndofs; i++) {
+            distance = qMax(distance, std::fabs(to.ValuesD()[i] - from.ValuesD()[i]));
+        }
+        const int nsteps = qMax(1, static_cast<int>(std::ceil(distance / qMax(1e-6, step_deg))));
+        for (int s = 1; s <= nsteps; s++) {
+            tJoints step(ndofs);
+            for (int i = 0; i < ndofs; i++) {
+                step.Data()[i] = from.ValuesD()[i] + (to.ValuesD()[i] - from.ValuesD()[i]) * s / nsteps;
+            }
+            steps.append(step);
+            move_ids.append(m);
+        }
+    }
+
+    // Columns: [J1..Jn, ERROR, MM_STEP, DEG_STEP, MOVE_ID]
+    Matrix2D_Set_Size(matrix, ndofs + 4, steps.size());
+    for (int col = 0; col < steps.size(); col++) {
+        for (int i = 0; i < ndofs; i++) {
+            Matrix2D_Set_ij(matrix, i, col, steps[col].ValuesD()[i]);
+        }
+        Matrix2D_Set_ij(matrix, ndofs, col, 0.0);
+        Matrix2D_Set_ij(matrix, ndofs + 1, col, 0.0);
+        Matrix2D_Set_ij(matrix, ndofs + 2, col, step_deg);
+        Matrix2D_Set_ij(matrix, ndofs + 3, col, move_ids[col]);
+    }
+    error_msg.clear();
+    return 0;
+}
+
+void MockItem::Copy() {
+    rdk->Call("Copy");
+}
+
+Item MockItem::Paste() {
+    rdk->Call("Paste");
+    return nullptr;
+}
+
+QString MockItem::setParam(const QString &param, const QString &value, QList<Item> *itemlist, double *values, tMatrix2D *matrix) {
+    rdk->Call("Item::setParam");
+    Q_UNUSED(itemlist)
+    Q_UNUSED(values)
+    Q_UNUSED(matrix)
+    if (value.isEmpty()) {
+        return params.value(param);
+    }
+    params[param] = value;
+    return "OK";
+}
+
+bool MockItem::setParam(const QString &param, const QByteArray &value) {
+    rdk->Call("Item::setParam");
+    params_bytes[param] = value;
+    return true;
+}
+
+bool MockItem::getParam(const QString &param, QByteArray &value) {
+    rdk->Call("Item::getParam");
+    if (!params_bytes.contains(param)) {
+        return false;
+    }
+    value = params_bytes.value(param);
+    return true;
+}
+
+void MockItem::setAccuracyActive(bool accurate) {
+    rdk->Call("setAccuracyActive");
+    Q_UNUSED(accurate)
+}
+
+tJoints MockItem::SimulatorJoints() {
+    rdk->Call("SimulatorJoints");
+    return joints;
+}
+
+int MockItem::InstructionSelect(int ins_id) {
+    rdk->Call("InstructionSelect");
+    return ins_id;
+}
+
+int MockItem::InstructionDelete(int ins_id) {
+    rdk->Call("InstructionDelete");
+    if (ins_id < 0 || ins_id >= program_path.size()) {
+        return 0;
+    }
+    program_path.removeAt(ins_id);
+    return 1;
+}
+
+void MockItem::setAO(const QString &io_var, const QString &io_value) {
+    rdk->Call("setAO");
+    params[io_var] = io_value;
+}
+
+QString MockItem::getDI(const QString &io_var) {
+    rdk->Call("getDI");
+    return params.value(io_var);
+}
+
+void MockItem::ConnectionParams(QString &robotIP, int &port, QString &remote_path, QString &FTP_user, QString &FTP_pass) {
+    rdk->Call("ConnectionParams");
+    robotIP = "127.0.0.1";
+    port = 2000;
+    remote_path = "/";
+    FTP_user.clear();
+    FTP_pass.clear();
+}
+
+void MockItem::setConnectionParams(const QString &robotIP, const int &port, const QString &remote_path, const QString &FTP_user, const QString &FTP_pass) {
+    rdk->Call("setConnectionParams");
+    Q_UNUSED(robotIP)
+    Q_UNUSED(port)
+    Q_UNUSED(remote_path)
+    Q_UNUSED(FTP_user)
+    Q_UNUSED(FTP_pass)
+}
+
+void MockItem::Color(tColor &clr_out) {
+    rdk->Call("Color");
+    clr_out = color;
+}
+
+void MockItem::SelectedFeature(bool &is_selected, int feature_type, int &feature_id) {
+    rdk->Call("SelectedFeature");
+    Q_UNUSED(feature_type)
+    is_selected = false;
+    feature_id = -1;
+}
+
+QList<Mat> MockItem::JointPoses(const tJoints &jnts) {
+    rdk->Call("JointPoses");
+    QList<Mat> poses;
+    Mat flange;
+    const tJoints &values = jnts.Length() >= DOFs() ? jnts : joints;
+    if (DOFs() > 0) {
+        flange_pose(values.ValuesD(), &flange, &poses);
+    }
+    return poses;
+}
@@ -0,0 +1,211 @@
+#ifndef MOCKITEM_H
+#define MOCKITEM_H
+
+#include "iitem.h"
+
+#include <QMap>
+#include <QVector>
+#include <QByteArray>
+
+
+class MockRoboDK;
+
+
+///
+/// \brief The MockItem class implements IItem in memory for the benchmark host.
+/// Items keep their pose with respect to the parent, their joints and their parameters. Robots compute the forward
+/// kinematics with the DH model of the samplekinematics robot extension and solve the inverse kinematics numerically.
+/// Each call is counted and delayed by the latency configured in MockRoboDK.
+///
+class MockItem : public IItem
+{
+    friend class MockRoboDK;
+
+public:
+    MockItem(MockRoboDK *rdk, int type, const QString &name, MockItem *parent);
+    ~MockItem() override;
+
+    //------------------------------- Mock state ------------------------------
+
+    /// Set the kinematics of a robot or mechanism: one row per joint [alpha (deg), a (mm), theta (deg), d (mm)]
+    void setKinematics(const QVector<QVector<double>> &dh, const QVector<bool> &prismatic);
+
+    /// Number of joints of a robot or mechanism (0 for other items)
+    int DOFs() const;
+
+    /// Radius of the collision sphere centered on the item (0 disables collisions)
+    double collision_radius = 0.0;
+
+    /// Pose of the item where its children are attached (the flange for robots), with respect to the station
+    Mat ChildrenPoseAbs();
+
+    /// Item is still in the station tree
+    bool alive = true;
+
+    /// Station of the item
+    MockItem *Station();
+
+    /// Robot is a mechanism of external axes (listed with ITEM_TYPE_ROBOT_AXES instead of ITEM_TYPE_ROBOT_ARM)
+    bool robot_axes = false;
+
+    /// Set the joint targets of a program (one MoveJ instruction per target)
+    void setProgramPath(const QList<tJoints> &path);
+
+    //------------------------------- IItem ------------------------------
+
+    int Type() override;
+    bool Save(const QString &filename) override;
+    void Delete() override;
+    void setParent(Item parent) override;
+    void setParentStatic(Item parent) override;
+    Item Parent() override;
+    QList<Item> Childs() override;
+    bool Visible() override;
+    void setVisible(bool visible, int visible_frame = -1) override;
+    QString Name() override;
+    void setName(const QString &name) override;
+    QString Command(const QString &cmd, const QString &value="") override;
+    bool setPose(const Mat pose) override;
+    Mat Pose() override;
+    void setGeometryPose(Mat pose, bool apply_transf=false) override;
+    Mat GeometryPose() override;
+    Mat PoseTool() override;
+    Mat PoseFrame() override;
+    void setPoseFrame(const Mat frame_pose) override;
+    void setPoseFrame(const Item frame_item) override;
+    void setPoseTool(const Mat tool_pose) override;
+    void setPoseTool(const Item tool_item) override;
+    void setPoseAbs(const Mat pose) override;
+    Mat PoseAbs() override;
+    void setColor(const tColor &clr) override;
+    void Scale(double scale) override;
+    void Scale(double scale_xyz[3]) override;
+    void setAsCartesianTarget() override;
+    void setAsJointTarget() override;
+    bool isJointTarget() override;
+    tJoints Joints() override;
+    tJoints JointsHome() override;
+    void setJointsHome(const tJoints &jnts) override;
+    Item ObjectLink(int link_id = 0) override;
+    Item getLink(int type_linked = ITEM_TYPE_ROBOT) override;
+    void setJoints(const tJoints &jnts) override;
+    int JointLimits(tJoints *lower_limits, tJoints *upper_limits) override;
+    int setJointLimits(const tJoints &lower_limits, const tJoints &upper_limits) override;
+    void setRobot(const Item &robot) override;
+    Item AddTool(const Mat &tool_pose, const QString &tool_name = "New TCP") override;
+    Mat SolveFK(const tJoints &joints, const Mat *tool_pose=nullptr, const Mat *reference_pose=nullptr) override;
+    void JointsConfig(const tJoints &joints, tConfig config) override;
+    tJoints SolveIK(const Mat &pose, const tJoints *joints_close=nullptr, const Mat *tool_pose=nullptr, const Mat *reference_pose=nullptr) override;
+    QList<tJoints> SolveIK_All(const Mat &pose, const Mat *tool_pose=nullptr, const Mat *reference_pose=nullptr) override;
+    bool Connect(const QString &robot_ip = "") override;
+    bool Disconnect() override;
+    bool MoveJ(const Item &itemtarget) override;
+    bool MoveJ(const tJoints &joints) override;
+    bool MoveJ(const Mat &target) override;
+    bool MoveL(const Item &itemtarget) override;
+    bool MoveL(const tJoints &joints) override;
+    bool MoveL(const Mat &target) override;
+    bool MoveC(const Item &itemtarget1, const Item &itemtarget2) override;
+    bool MoveC(const tJoints &joints1, const tJoints &joints2) override;
+    bool MoveC(const Mat &target1, const Mat &target2) override;
+    int MoveJ_Test(const tJoints &j1, const tJoints &j2, double minstep_deg = -1) override;
+    int MoveL_Test(const tJoints &joints1, const Mat &pose2, double minstep_mm = -1) override;
+    void setSpeed(double speed_linear, double accel_linear = -1, double speed_joints = -1, double accel_joints = -1) override;
+    void setRounding(double zonedata) override;
+    void ShowSequence(tMatrix2D *sequence) override;
+    bool Busy() override;
+    void Stop() override;
+    bool MakeProgram(const QString &filename) override;
+    void setRunType(int program_run_type) override;
+    bool RunProgram(const QString &params = "") override;
+    int RunInstruction(const QString &code, int run_type = RoboDK::INSTRUCTION_CALL_PROGRAM) override;
+    void Pause(double time_ms = -1) override;
+    void setDO(const QString &io_var, const QString &io_value) override;
+    void waitDI(const QString &io_var, const QString &io_value, double timeout_ms = -1) override;
+    void customInstruction(const QString &name, const QString &path_run, const QString &path_icon = "", bool blocking = true, const QString &cmd_run_on_robot = "") override;
+    void ShowInstructions(bool visible=true) override;
+    void ShowTargets(bool visible=true) override;
+    int InstructionCount() override;
+    void InstructionAt(int ins_id, QString &name, int &instype, int &movetype, bool &isjointtarget, Mat &target, tJoints &joints) override;
+    void setInstruction(int ins_id, const QString &name, int instype, int movetype, bool isjointtarget, const Mat &target, const tJoints &joints) override;
+    int InstructionList(tMatrix2D *instructions) override;
+    double Update(double out_nins_time_dist[4], int collision_check = RoboDK::COLLISION_OFF, double mm_step = -1, double deg_step = -1) override;
+    Item setMachiningParameters(const QString &ncfile="", Item part_obj=nullptr, const QString &options="") override;
+    int ConnectedState(QString *msg=nullptr) override;
+    bool Selected() override;
+    bool Collided(int *id=nullptr) override;
+    bool JointsValid(const tJoints &jnts) override;
+    int RunType() override;
+    bool Scale(const double scalexyz[3], const Mat *tr_pre_scale, const Mat *tr_post_scale=nullptr) override;
+    Item InstructionTargetAt(int ins_id) override;
+    Item AttachClosest() override;
+    Item DetachClosest(Item parent=nullptr) override;
+    void DetachAll(Item parent=nullptr) override;
+    int InstructionListJoints(QString &error_msg, tMatrix2D *matrix, double step_mm=1, double step_deg=1, int check_collisions=IRoboDK::COLLISION_OFF, int flags=0, double time_step=0.1) override;
+    void Copy() override;
+    Item Paste() override;
+    QString setParam(const QString &param, const QString &value="", QList<Item> *itemlist=nullptr, double *values=nullptr, tMatrix2D *matrix=nullptr) override;
+    bool setParam(const QString &name, const QByteArray &value) override;
+    bool getParam(const QString &name, QByteArray &value) override;
+    void setAccuracyActive(bool accurate=true) override;
+    tJoints SimulatorJoints() override;
+    int InstructionSelect(int ins_id=-1) override;
+    int InstructionDelete(int ins_id=0) override;
+    void setAO(const QString &io_var, const QString &io_value) override;
+    QString getDI(const QString &io_var) override;
+    void ConnectionParams(QString &robotIP, int &port, QString &remote_path, QString &FTP_user, QString &FTP_pass) override;
+    void setConnectionParams(const QString &robotIP, const int &port=2000, const QString &remote_path="/", const QString &FTP_user="", const QString &FTP_pass="") override;
+    void Color(tColor &clr_out) override;
+    void SelectedFeature(bool &is_selected, int feature_type, int &feature_id) override;
+    QList<Mat> JointPoses(const tJoints &jnts) override;
+
+private:
+    /// Forward kinematics of the flange with respect to the robot base (without the latency of the API call)
+    bool flange_pose(const double *joints, Mat *pose, QList<Mat> *joint_poses = nullptr) const;
+
+    /// Numerical inverse kinematics (damped least squares) of the flange with respect to the robot base
+    bool solve_ik(const Mat &flange, const tJoints &seed, tJoints *result) const;
+
+    /// Move the robot linearly in the joint space (simulated instantly)
+    bool move_joints(const tJoints &joints);
+
+    /// Robot or mechanism this item belongs to (nullptr if none)
+    MockItem *robot();
+
+    /// Pose of the item with respect to the station (without the latency of the API call)
+    Mat pose_abs();
+
+private:
+    MockRoboDK *rdk;
+    int type;
+    QString name;
+    MockItem *parent;
+    QList<Item> children;
+
+    Mat pose;
+    Mat pose_tool;
+    Mat pose_frame;
+    Mat geometry_pose;
+    bool visible = true;
+    bool joint_target = false;
+    tColor color {0.5f, 0.5f, 0.5f, 1.0f};
+
+    tJoints joints;
+    tJoints joints_home;
+    tJoints lower_limits;
+    tJoints upper_limits;
+
+    /// Robot parameters in the layout expected by samplekinematics (SolveFK, SolveFK_CAD and Joints2Config)
+    QVector<double> robot_params;
+
+    /// Links to other items (tool, frame or robot), by item type
+    QMap<int, Item> links;
+
+    /// Joint targets of a program
+    QList<tJoints> program_path;
+
+    QMap<QString, QString> params;
+    QMap<QString, QByteArray> params_bytes;
+};
+
+#endif // MOCKITEM_H
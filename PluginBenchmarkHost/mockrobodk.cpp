@@ -0,0 +1,961 @@
+#include "mockrobodk.h"
+#include "mockitem.h"
+
+#include <QElapsedTimer>
+#include <QImage>
+
+
+#if (QT_VERSION < QT_VERSION_CHECK(5, 14, 0))
+static const QString::SplitBehavior SKIP_EMPTY_PARTS = QString::SkipEmptyParts;
+#else
+static const Qt::SplitBehavior SKIP_EMPTY_PARTS = Qt::SkipEmptyParts;
+#endif
+
+
+// Parse a list of numbers separated by commas
+static bool parse_values(const QString &text, QVector<double> *values) {
+    values->clear();
+    for (const QString &value : text.split(',', SKIP_EMPTY_PARTS)) {
+        bool ok = false;
+        values->append(value.trimmed().toDouble(&ok));
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Parse a list of joints separated by semicolons (for example: 0,0,0,0,0,0;10,20,30,0,0,0)
+static bool parse_joints_list(const QString &text, QList<tJoints> *list) {
+    list->clear();
+    for (const QString &joints_text : text.split(';', SKIP_EMPTY_PARTS)) {
+        QVector<double> values;
+        if (!parse_values(joints_text, &values) || values.isEmpty()) {
+            return false;
+        }
+        list->append(tJoints(values.constData(), values.size()));
+    }
+    return true;
+}
+
+// Parse a pose given as XYZRPW (mm and deg)
+static bool parse_pose(const QString &text, Mat *pose) {
+    QVector<double> values;
+    if (!parse_values(text, &values) || values.size() != 6) {
+        return false;
+    }
+    *pose = Mat::XYZRPW_2_Mat(values.constData());
+    return true;
+}
+
+
+MockRoboDK::MockRoboDK() {
+}
+
+MockRoboDK::~MockRoboDK() {
+    qDeleteAll(items);
+}
+
+QStringList MockRoboDK::SplitWords(const QString &line) {
+    QStringList words;
+    QString word;
+    bool quoted = false;
+    bool has_word = false;
+    for (const QChar &c : line) {
+        if (c == '"') {
+            quoted = !quoted;
+            has_word = true;
+        } else if (c.isSpace() && !quoted) {
+            if (has_word) {
+                words.append(word);
+                word.clear();
+                has_word = false;
+            }
+        } else {
+            word.append(c);
+            has_word = true;
+        }
+    }
+    if (has_word) {
+        words.append(word);
+    }
+    return words;
+}
+
+bool MockRoboDK::LoadStation(const QStringList &lines, QString *error) {
+    static const QMap<QString, int> item_types = {
+        {"station", IItem::ITEM_TYPE_STATION},
+        {"frame", IItem::ITEM_TYPE_FRAME},
+        {"object", IItem::ITEM_TYPE_OBJECT},
+        {"target", IItem::ITEM_TYPE_TARGET},
+        {"program", IItem::ITEM_TYPE_PROGRAM},
+        {"robot", IItem::ITEM_TYPE_ROBOT},
+        {"axes", IItem::ITEM_TYPE_ROBOT},
+        {"tool", IItem::ITEM_TYPE_TOOL}
+    };
+
+    auto fail = [&](int line_id, const QString &message) {
+        if (error != nullptr) {
+            *error = QString("Line %1: %2").arg(line_id + 1).arg(message);
+        }
+        return false;
+    };
+
+    MockItem *station = nullptr;
+    for (int line_id = 0; line_id < lines.size(); line_id++) {
+        QString line = lines[line_id].trimmed();
+        if (line.isEmpty() || line.startsWith('#')) {
+            continue;
+        }
+        QStringList words = SplitWords(line);
+        const QString kind = words.takeFirst().toLower();
+        if (!item_types.contains(kind) || words.isEmpty()) {
+            return fail(line_id, "Unknown item or missing name: " + line);
+        }
+        const QString name = words.takeFirst();
+
+        QMap<QString, QString> options;
+        for (const QString &word : words) {
+            int equal = word.indexOf('=');
+            if (equal <= 0) {
+                return fail(line_id, "Expected key=value: " + word);
+            }
+            options[word.left(equal).toLower()] = word.mid(equal + 1);
+        }
+
+        if (kind == "station") {
+            station = AddItem(IItem::ITEM_TYPE_STATION, name, nullptr);
+            continue;
+        }
+        if (station == nullptr) {
+            station = AddItem(IItem::ITEM_TYPE_STATION, "Station", nullptr);
+        }
+
+        MockItem *parent = station;
+        if (options.contains("parent")) {
+            parent = static_cast<MockItem*>(getItem(options["parent"]));
+            if (parent == nullptr) {
+                return fail(line_id, "Parent not found: " + options["parent"]);
+            }
+        }
+        const int type = item_types[kind];
+        if (type == IItem::ITEM_TYPE_TOOL && parent->DOFs() == 0) {
+            return fail(line_id, "The parent of a tool must be a robot");
+        }
+
+        MockItem *item = AddItem(type, name, parent);
+        if (options.contains("pose") && !parse_pose(options["pose"], &item->pose)) {
+            return fail(line_id, "Invalid pose: " + options["pose"]);
+        }
+        if (options.contains("radius")) {
+            item->collision_radius = options["radius"].toDouble();
+        }
+
+        if (type == IItem::ITEM_TYPE_ROBOT) {
+            QVector<QVector<double>> dh;
+            for (const QString &row_text : options["dh"].split(';', SKIP_EMPTY_PARTS)) {
+                QVector<double> row;
+                if (!parse_values(row_text, &row) || row.size() != 4) {
+                    return fail(line_id, "Invalid DH row: " + row_text);
+                }
+                dh.append(row);
+            }
+            if (dh.isEmpty()) {
+                return fail(line_id, "A robot requires its DH parameters (dh=alpha,a,theta,d;...)");
+            }
+            QVector<double> flags;
+            parse_values(options.value("prismatic"), &flags);
+            QVector<bool> prismatic;
+            for (double flag : flags) {
+                prismatic.append(flag != 0.0);
+            }
+            item->setKinematics(dh, prismatic);
+            item->robot_axes = (kind == "axes");
+
+            QVector<double> values;
+            if (options.contains("lower") && options.contains("upper")) {
+                QVector<double> upper;
+                if (!parse_values(options["lower"], &values) || !parse_values(options["upper"], &upper)
+                        || values.size() != item->DOFs() || upper.size() != item->DOFs()) {
+                    return fail(line_id, "Invalid joint limits");
+                }
+                item->setJointLimits(tJoints(values.constData(), values.size()), tJoints(upper.constData(), upper.size()));
+            }
+            if (options.contains("joints")) {
+                if (!parse_values(options["joints"], &values) || values.size() != item->DOFs()) {
+                    return fail(line_id, "Invalid joints: " + options["joints"]);
+                }
+                item->joints = tJoints(values.constData(), values.size());
+                item->joints_home = item->joints;
+            }
+        } else if (type == IItem::ITEM_TYPE_TOOL) {
+            if (options.contains("tcp") && !parse_pose(options["tcp"], &item->pose_tool)) {
+                return fail(line_id, "Invalid TCP: " + options["tcp"]);
+            }
+            item->pose = item->pose_tool;
+            parent->links[IItem::ITEM_TYPE_TOOL] = item;
+        } else if (type == IItem::ITEM_TYPE_TARGET) {
+            if (options.contains("joints")) {
+                QVector<double> values;
+                if (!parse_values(options["joints"], &values)) {
+                    return fail(line_id, "Invalid joints: " + options["joints"]);
+                }
+                item->joints = tJoints(values.constData(), values.size());
+                item->joint_target = true;
+            }
+        } else if (type == IItem::ITEM_TYPE_PROGRAM) {
+            if (options.contains("robot")) {
+                MockItem *robot = static_cast<MockItem*>(getItem(options["robot"], IItem::ITEM_TYPE_ROBOT));
+                if (robot == nullptr) {
+                    return fail(line_id, "Robot not found: " + options["robot"]);
+                }
+                item->links[IItem::ITEM_TYPE_ROBOT] = robot;
+            }
+            QList<tJoints> path;
+            if (options.contains("path") && !parse_joints_list(options["path"], &path)) {
+                return fail(line_id, "Invalid path: " + options["path"]);
+            }
+            item->setProgramPath(path);
+        }
+    }
+    return true;
+}
+
+MockItem *MockRoboDK::AddItem(int type, const QString &name, MockItem *parent) {
+    MockItem *item = new MockItem(this, type, name, parent);
+    items.append(item);
+    items_alive.insert(item);
+    if (type == IItem::ITEM_TYPE_STATION) {
+        stations.append(item);
+        station_active = item;
+    }
+    return item;
+}
+
+void MockRoboDK::RemoveItem(MockItem *item) {
+    if (item == nullptr || !item->alive) {
+        return;
+    }
+    const QList<Item> children = item->children;
+    for (Item child : children) {
+        RemoveItem(static_cast<MockItem*>(child));
+    }
+    item->alive = false;
+    items_alive.remove(item);
+    selection.removeAll(item);
+    if (item->parent != nullptr) {
+        item->parent->children.removeAll(item);
+    }
+    if (item->type == IItem::ITEM_TYPE_STATION) {
+        stations.removeAll(item);
+        if (station_active == item) {
+            station_active = stations.isEmpty() ? nullptr : static_cast<MockItem*>(stations.last());
+        }
+    }
+}
+
+void MockRoboDK::SetLatency(const QString &method, double latency_us) {
+    const qint64 latency = static_cast<qint64>(latency_us * 1000.0);
+    if (method == "*") {
+        latency_all_ns = latency;
+    } else {
+        latency_ns[method.toUtf8()] = latency;
+    }
+}
+
+void MockRoboDK::Call(const char *method) {
+    // The key only wraps the method name: a copy is made the first time a method is called
+    const QByteArray key = QByteArray::fromRawData(method, static_cast<int>(qstrlen(method)));
+    auto it = calls.find(key);
+    if (it == calls.end()) {
+        calls.insert(QByteArray(method), 1);
+    } else {
+        ++it.value();
+    }
+    const qint64 latency = latency_ns.value(key, latency_all_ns);
+    if (latency <= 0) {
+        return;
+    }
+    // Busy wait: sleeping is too coarse for latencies in the order of microseconds
+    QElapsedTimer timer;
+    timer.start();
+    while (timer.nsecsElapsed() < latency) {
+    }
+}
+
+QMap<QString, quint64> MockRoboDK::Calls() const {
+    QMap<QString, quint64> result;
+    for (auto it = calls.constBegin(); it != calls.constEnd(); ++it) {
+        result[QString::fromUtf8(it.key())] = it.value();
+    }
+    return result;
+}
+
+void MockRoboDK::ResetCalls() {
+    calls.clear();
+}
+
+void MockRoboDK::collect_items(MockItem *parent, int filter, QList<Item> *list) const {
+    for (Item child : parent->children) {
+        MockItem *item = static_cast<MockItem*>(child);
+        bool match = false;
+        if (filter < 0) {
+            match = true;
+        } else if (filter == IItem::ITEM_TYPE_ROBOT_ARM) {
+            match = (item->type == IItem::ITEM_TYPE_ROBOT && !item->robot_axes);
+        } else if (filter == IItem::ITEM_TYPE_ROBOT_AXES) {
+            match = (item->type == IItem::ITEM_TYPE_ROBOT && item->robot_axes);
+        } else {
+            match = (item->type == filter);
+        }
+        if (match) {
+            list->append(item);
+        }
+        collect_items(item, filter, list);
+    }
+}
+
+bool MockRoboDK::collision_candidate(MockItem *item) {
+    return item->visible && item->collision_radius > 0.0;
+}
+
+bool MockRoboDK::spheres_collide(MockItem *item1, MockItem *item2) {
+    if (item1->parent == item2 || item2->parent == item1) {
+        return false;
+    }
+    Mat pose1 = item1->ChildrenPoseAbs();
+    Mat pose2 = item2->ChildrenPoseAbs();
+    double distance2 = 0.0;
+    for (int i = 0; i < 3; i++) {
+        double delta = pose1.Get(i, 3) - pose2.Get(i, 3);
+        distance2 += delta * delta;
+    }
+    double radius = item1->collision_radius + item2->collision_radius;
+    return distance2 < radius * radius;
+}
+
+
+//------------------------------- IRoboDK ------------------------------
+
+Item MockRoboDK::getItem(const QString &name, int itemtype) {
+    Call("getItem");
+    if (station_active == nullptr) {
+        return nullptr;
+    }
+    QList<Item> list;
+    collect_items(station_active, itemtype, &list);
+    for (Item item : list) {
+        if (static_cast<MockItem*>(item)->name == name) {
+            return item;
+        }
+    }
+    return nullptr;
+}
+
+QStringList MockRoboDK::getItemListNames(int filter) {
+    Call("getItemListNames");
+    QStringList names;
+    if (station_active != nullptr) {
+        QList<Item> list;
+        collect_items(station_active, filter, &list);
+        for (Item item : list) {
+            names.append(static_cast<MockItem*>(item)->name);
+        }
+    }
+    return names;
+}
+
+QList<Item> MockRoboDK::getItemList(int filter) {
+    Call("getItemList");
+    QList<Item> list;
+    if (station_active != nullptr) {
+        collect_items(station_active, filter, &list);
+    }
+    return list;
+}
+
+bool MockRoboDK::Valid(const Item item_check) {
+    Call("Valid");
+    if (!items_alive.contains(item_check)) {
+        return false;
+    }
+    MockItem *item = static_cast<MockItem*>(item_check);
+    return item->type == IItem::ITEM_TYPE_STATION || item->Station() == station_active;
+}
+
+Item MockRoboDK::ItemUserPick(const QString &message, int itemtype) {
+    Call("ItemUserPick");
+    Q_UNUSED(message)
+    QList<Item> list;
+    if (station_active != nullptr) {
+        collect_items(station_active, itemtype, &list);
+    }
+    return list.isEmpty() ? nullptr : list.first();
+}
+
+Item MockRoboDK::ItemUserPick(const QString &message, const QList<Item> &list_choices, int id_selected) {
+    Call("ItemUserPick");
+    Q_UNUSED(message)
+    if (list_choices.isEmpty()) {
+        return nullptr;
+    }
+    return list_choices.value(id_selected, list_choices.first());
+}
+
+void MockRoboDK::ShowRoboDK() {
+    Call("ShowRoboDK");
+}
+
+void MockRoboDK::HideRoboDK() {
+    Call("HideRoboDK");
+}
+
+void MockRoboDK::CloseRoboDK() {
+    Call("CloseRoboDK");
+}
+
+QString MockRoboDK::Version() {
+    Call("Version");
+    return "5.9.0 (mock)";
+}
+
+void MockRoboDK::setWindowState(int windowstate) {
+    Call("setWindowState");
+    Q_UNUSED(windowstate)
+}
+
+void MockRoboDK::setFlagsRoboDK(int flags) {
+    Call("setFlagsRoboDK");
+    Q_UNUSED(flags)
+}
+
+void MockRoboDK::setFlagsItem(int flags, Item item) {
+    Call("setFlagsItem");
+    Q_UNUSED(flags)
+    Q_UNUSED(item)
+}
+
+int MockRoboDK::getFlagsItem(Item item) {
+    Call("getFlagsItem");
+    Q_UNUSED(item)
+    return FLAG_ITEM_ALL;
+}
+
+void MockRoboDK::ShowMessage(const QString &message, bool popup) {
+    Call("ShowMessage");
+    Q_UNUSED(message)
+    Q_UNUSED(popup)
+}
+
+Item MockRoboDK::AddFile(const QString &filename, const Item parent) {
+    Call("AddFile");
+    Q_UNUSED(filename)
+    Q_UNUSED(parent)
+    return nullptr;
+}
+
+void MockRoboDK::Save(const QString &filename, const Item itemsave) {
+    Call("Save");
+    Q_UNUSED(filename)
+    Q_UNUSED(itemsave)
+}
+
+Item MockRoboDK::AddShape(const tMatrix2D *trianglePoints, Item addTo, bool shapeOverride, tColor *color) {
+    Call("AddShape");
+    Q_UNUSED(trianglePoints)
+    Q_UNUSED(shapeOverride)
+    Q_UNUSED(color)
+    MockItem *parent = static_cast<MockItem*>(addTo);
+    if (parent != nullptr) {
+        return parent;
+    }
+    return station_active != nullptr ? AddItem(IItem::ITEM_TYPE_OBJECT, "Shape", station_active) : nullptr;
+}
+
+Item MockRoboDK::AddCurve(const tMatrix2D *curvePoints, Item referenceObject, bool addToRef, int ProjectionType) {
+    Call("AddCurve");
+    Q_UNUSED(curvePoints)
+    Q_UNUSED(addToRef)
+    Q_UNUSED(ProjectionType)
+    if (referenceObject != nullptr && addToRef) {
+        return referenceObject;
+    }
+    return station_active != nullptr ? AddItem(IItem::ITEM_TYPE_OBJECT, "Curve", station_active) : nullptr;
+}
+
+Item MockRoboDK::AddPoints(const tMatrix2D *points, Item referenceObject, bool addToRef, int ProjectionType) {
+    Call("AddPoints");
+    Q_UNUSED(points)
+    Q_UNUSED(addToRef)
+    Q_UNUSED(ProjectionType)
+    if (referenceObject != nullptr && addToRef) {
+        return referenceObject;
+    }
+    return station_active != nullptr ? AddItem(IItem::ITEM_TYPE_OBJECT, "Points", station_active) : nullptr;
+}
+
+bool MockRoboDK::ProjectPoints(tMatrix2D *points, Item objectProject, int ProjectionType) {
+    Call("ProjectPoints");
+    Q_UNUSED(points)
+    Q_UNUSED(objectProject)
+    Q_UNUSED(ProjectionType)
+    return false;
+}
+
+void MockRoboDK::CloseStation() {
+    Call("CloseStation");
+    RemoveItem(station_active);
+}
+
+Item MockRoboDK::AddTarget(const QString &name, Item itemparent, Item itemrobot) {
+    Call("AddTarget");
+    MockItem *parent = itemparent != nullptr ? static_cast<MockItem*>(itemparent) : station_active;
+    if (parent == nullptr) {
+        return nullptr;
+    }
+    MockItem *target = AddItem(IItem::ITEM_TYPE_TARGET, name, parent);
+    if (itemrobot != nullptr) {
+        target->links[IItem::ITEM_TYPE_ROBOT] = itemrobot;
+    }
+    return target;
+}
+
+Item MockRoboDK::AddFrame(const QString &name, Item itemparent) {
+    Call("AddFrame");
+    MockItem *parent = itemparent != nullptr ? static_cast<MockItem*>(itemparent) : station_active;
+    return parent != nullptr ? AddItem(IItem::ITEM_TYPE_FRAME, name, parent) : nullptr;
+}
+
+Item MockRoboDK::AddProgram(const QString &name, Item itemrobot) {
+    Call("AddProgram");
+    if (station_active == nullptr) {
+        return nullptr;
+    }
+    MockItem *program = AddItem(IItem::ITEM_TYPE_PROGRAM, name, station_active);
+    if (itemrobot != nullptr) {
+        program->links[IItem::ITEM_TYPE_ROBOT] = itemrobot;
+    }
+    return program;
+}
+
+Item MockRoboDK::AddStation(QString name) {
+    Call("AddStation");
+    return AddItem(IItem::ITEM_TYPE_STATION, name, nullptr);
+}
+
+Item MockRoboDK::AddMachiningProject(QString name, Item itemrobot) {
+    Call("AddMachiningProject");
+    if (station_active == nullptr) {
+        return nullptr;
+    }
+    MockItem *project = AddItem(IItem::ITEM_TYPE_MACHINING, name, station_active);
+    if (itemrobot != nullptr) {
+        project->links[IItem::ITEM_TYPE_ROBOT] = itemrobot;
+    }
+    return project;
+}
+
+QList<Item> MockRoboDK::getOpenStations() {
+    Call("getOpenStations");
+    return stations;
+}
+
+void MockRoboDK::setActiveStation(Item stn) {
+    Call("setActiveStation");
+    if (stations.contains(stn)) {
+        station_active = static_cast<MockItem*>(stn);
+    }
+}
+
+Item MockRoboDK::getActiveStation() {
+    Call("getActiveStation");
+    return station_active;
+}
+
+int MockRoboDK::RunProgram(const QString &function_w_params) {
+    Call("RunProgram");
+    Q_UNUSED(function_w_params)
+    return 0;
+}
+
+int MockRoboDK::RunCode(const QString &code, bool code_is_fcn_call) {
+    Call("RunCode");
+    Q_UNUSED(code)
+    Q_UNUSED(code_is_fcn_call)
+    return 0;
+}
+
+void MockRoboDK::RunMessage(const QString &message, bool message_is_comment) {
+    Call("RunMessage");
+    Q_UNUSED(message)
+    Q_UNUSED(message_is_comment)
+}
+
+void MockRoboDK::Render(int flags) {
+    // Rendering is not emulated: the latency of the call can be set with SetLatency("Render", us)
+    Call("Render");
+    Q_UNUSED(flags)
+}
+
+bool MockRoboDK::IsInside(Item object_inside, Item object_parent) {
+    Call("IsInside");
+    MockItem *inside = static_cast<MockItem*>(object_inside);
+    MockItem *parent = static_cast<MockItem*>(object_parent);
+    if (inside == nullptr || parent == nullptr || parent->collision_radius <= 0.0) {
+        return false;
+    }
+    Mat pose1 = inside->ChildrenPoseAbs();
+    Mat pose2 = parent->ChildrenPoseAbs();
+    double distance2 = 0.0;
+    for (int i = 0; i < 3; i++) {
+        double delta = pose1.Get(i, 3) - pose2.Get(i, 3);
+        distance2 += delta * delta;
+    }
+    return distance2 < parent->collision_radius * parent->collision_radius;
+}
+
+int MockRoboDK::setCollisionActive(int check_state) {
+    Call("setCollisionActive");
+    collision_active = check_state;
+    return 0;
+}
+
+bool MockRoboDK::setCollisionActivePair(int check_state, Item item1, Item item2, int id1, int id2) {
+    Call("setCollisionActivePair");
+    Q_UNUSED(check_state)
+    Q_UNUSED(item1)
+    Q_UNUSED(item2)
+    Q_UNUSED(id1)
+    Q_UNUSED(id2)
+    return true;
+}
+
+int MockRoboDK::Collisions() {
+    Call("Collisions");
+    if (station_active == nullptr) {
+        return 0;
+    }
+    QList<Item> list;
+    collect_items(station_active, -1, &list);
+    QList<MockItem*> candidates;
+    for (Item item : list) {
+        if (collision_candidate(static_cast<MockItem*>(item))) {
+            candidates.append(static_cast<MockItem*>(item));
+        }
+    }
+    int ncollisions = 0;
+    for (int i = 0; i < candidates.size(); i++) {
+        for (int j = i + 1; j < candidates.size(); j++) {
+            if (spheres_collide(candidates[i], candidates[j])) {
+                ncollisions++;
+            }
+        }
+    }
+    return ncollisions;
+}
+
+int MockRoboDK::Collision(Item item1, Item item2) {
+    Call("Collision");
+    MockItem *mock1 = static_cast<MockItem*>(item1);
+    MockItem *mock2 = static_cast<MockItem*>(item2);
+    if (mock1 == nullptr || mock2 == nullptr || !collision_candidate(mock1) || !collision_candidate(mock2)) {
+        return 0;
+    }
+    return spheres_collide(mock1, mock2) ? 1 : 0;
+}
+
+QList<Item> MockRoboDK::getCollisionItems(QList<int> *link_id_list) {
+    Call("getCollisionItems");
+    QList<Item> collided;
+    if (station_active == nullptr) {
+        return collided;
+    }
+    QList<Item> list;
+    collect_items(station_active, -1, &list);
+    for (int i = 0; i < list.size(); i++) {
+        MockItem *item1 = static_cast<MockItem*>(list[i]);
+        if (!collision_candidate(item1)) {
+            continue;
+        }
+        for (int j = 0; j < list.size(); j++) {
+            MockItem *item2 = static_cast<MockItem*>(list[j]);
+            if (i != j && collision_candidate(item2) && spheres_collide(item1, item2)) {
+                collided.append(item1);
+                if (link_id_list != nullptr) {
+                    link_id_list->append(0);
+                }
+                break;
+            }
+        }
+    }
+    return collided;
+}
+
+void MockRoboDK::setSimulationSpeed(double speed) {
+    Call("setSimulationSpeed");
+    simulation_speed = speed;
+}
+
+double MockRoboDK::SimulationSpeed() {
+    Call("SimulationSpeed");
+    return simulation_speed;
+}
+
+void MockRoboDK::setRunMode(int mode) {
+    Call("setRunMode");
+    run_mode = mode;
+}
+
+int MockRoboDK::RunMode() {
+    Call("RunMode");
+    return run_mode;
+}
+
+QList<QPair<QString, QString> > MockRoboDK::getParams() {
+    Call("getParams");
+    QList<QPair<QString, QString> > list;
+    for (auto it = params.constBegin(); it != params.constEnd(); ++it) {
+        list.append(qMakePair(it.key(), it.value()));
+    }
+    return list;
+}
+
+QString MockRoboDK::getParam(const QString &param) {
+    Call("getParam");
+    return params.value(param);
+}
+
+void MockRoboDK::setParam(const QString &param, const QString &value) {
+    Call("setParam");
+    params[param] = value;
+}
+
+QString MockRoboDK::Command(const QString &cmd, const QString &value) {
+    Call("Command");
+    if (value.isEmpty()) {
+        return params.value(cmd);
+    }
+    params[cmd] = value;
+    return "OK";
+}
+
+bool MockRoboDK::LaserTrackerMeasure(tXYZ xyz, const tXYZ estimate, bool search) {
+    Call("LaserTrackerMeasure");
+    Q_UNUSED(search)
+    for (int i = 0; i < 3; i++) {
+        xyz[i] = estimate[i];
+    }
+    return false;
+}
+
+bool MockRoboDK::MeasurePose(Mat *pose, double data[10], int target, int time_avg_ms, const tXYZ tool_tip) {
+    Call("MeasurePose");
+    Q_UNUSED(pose)
+    Q_UNUSED(data)
+    Q_UNUSED(target)
+    Q_UNUSED(time_avg_ms)
+    Q_UNUSED(tool_tip)
+    return false;
+}
+
+bool MockRoboDK::CollisionLine(const tXYZ p1, const tXYZ p2) {
+    Call("CollisionLine");
+    Q_UNUSED(p1)
+    Q_UNUSED(p2)
+    return false;
+}
+
+void MockRoboDK::CalibrateTool(const tMatrix2D *poses_joints, tXYZ tcp_xyz, int format, int algorithm, Item robot, double *error_stats) {
+    Call("CalibrateTool");
+    Q_UNUSED(poses_joints)
+    Q_UNUSED(format)
+    Q_UNUSED(algorithm)
+    Q_UNUSED(robot)
+    Q_UNUSED(error_stats)
+    tcp_xyz[0] = tcp_xyz[1] = tcp_xyz[2] = 0.0;
+}
+
+Mat MockRoboDK::CalibrateReference(const tMatrix2D *poses_joints, int method, bool use_joints, Item robot) {
+    Call("CalibrateReference");
+    Q_UNUSED(poses_joints)
+    Q_UNUSED(method)
+    Q_UNUSED(use_joints)
+    Q_UNUSED(robot)
+    return Mat(false);
+}
+
+bool MockRoboDK::ProgramStart(const QString &progname, const QString &defaultfolder, const QString &postprocessor, Item robot) {
+    Call("ProgramStart");
+    Q_UNUSED(progname)
+    Q_UNUSED(defaultfolder)
+    Q_UNUSED(postprocessor)
+    Q_UNUSED(robot)
+    return false;
+}
+
+void MockRoboDK::setViewPose(const Mat &pose) {
+    Call("setViewPose");
+    view_pose = pose;
+}
+
+Mat MockRoboDK::ViewPose() {
+    Call("ViewPose");
+    return view_pose;
+}
+
+bool MockRoboDK::SetRobotParams(Item robot, tMatrix2D dhm, Mat poseBase, Mat poseTool) {
+    Call("SetRobotParams");
+    Q_UNUSED(robot)
+    Q_UNUSED(dhm)
+    Q_UNUSED(poseBase)
+    Q_UNUSED(poseTool)
+    return false;
+}
+
+Item MockRoboDK::getCursorXYZ(int x, int y, tXYZ xyzStation) {
+    Call("getCursorXYZ");
+    Q_UNUSED(x)
+    Q_UNUSED(y)
+    Q_UNUSED(xyzStation)
+    return nullptr;
+}
+
+QString MockRoboDK::License() {
+    Call("License");
+    return "Mock";
+}
+
+QList<Item> MockRoboDK::Selection() {
+    Call("Selection");
+    return selection;
+}
+
+Item MockRoboDK::Popup_ISO9283_CubeProgram(Item robot, tXYZ center, double side) {
+    Call("Popup_ISO9283_CubeProgram");
+    Q_UNUSED(robot)
+    Q_UNUSED(center)
+    Q_UNUSED(side)
+    return nullptr;
+}
+
+QByteArray MockRoboDK::getData(const QString &param) {
+    Call("getData");
+    return data.value(param);
+}
+
+void MockRoboDK::setData(const QString &param, const QByteArray &value) {
+    Call("setData");
+    data[param] = value;
+}
+
+int MockRoboDK::CollisionActive() {
+    Call("CollisionActive");
+    return collision_active;
+}
+
+bool MockRoboDK::DrawGeometry(int drawtype, float *vtx_pointer, int vtx_size, float color[4], float geo_size, float *vtx_normals) {
+    Call("DrawGeometry");
+    Q_UNUSED(drawtype)
+    Q_UNUSED(vtx_pointer)
+    Q_UNUSED(vtx_size)
+    Q_UNUSED(color)
+    Q_UNUSED(geo_size)
+    Q_UNUSED(vtx_normals)
+    return true;
+}
+
+bool MockRoboDK::DrawTexture(const QImage *image, const float *vtx_pointer, const float *texture_coords, int num_triangles, float *vtx_normals) {
+    Call("DrawTexture");
+    Q_UNUSED(image)
+    Q_UNUSED(vtx_pointer)
+    Q_UNUSED(texture_coords)
+    Q_UNUSED(num_triangles)
+    Q_UNUSED(vtx_normals)
+    return true;
+}
+
+void MockRoboDK::setSelection(const QList<Item> &listitems) {
+    Call("setSelection");
+    selection = listitems;
+}
+
+void MockRoboDK::setInteractiveMode(int mode_type, int default_ref_flags, const QList<Item> *custom_object, int custom_ref_flags) {
+    Call("setInteractiveMode");
+    Q_UNUSED(mode_type)
+    Q_UNUSED(default_ref_flags)
+    Q_UNUSED(custom_object)
+    Q_UNUSED(custom_ref_flags)
+}
+
+void MockRoboDK::PluginLoad(const QString &plugin_name, int load) {
+    Call("PluginLoad");
+    Q_UNUSED(plugin_name)
+    Q_UNUSED(load)
+}
+
+QString MockRoboDK::PluginCommand(const QString &plugin_name, const QString &plugin_command, const QString &value) {
+    Call("PluginCommand");
+    if (!on_plugin_command) {
+        return QString();
+    }
+    return on_plugin_command(plugin_name, plugin_command, value);
+}
+
+QByteArray MockRoboDK::getParamBytes(const QString &param) {
+    Call("getParamBytes");
+    return data.value(param);
+}
+
+void MockRoboDK::setParamBytes(const QString &param, const QByteArray &value) {
+    Call("setParamBytes");
+    data[param] = value;
+}
+
+int MockRoboDK::StereoCamera_Measure(Mat pose1, Mat pose2, int &npoints1, int &npoints2, double *values, float time_avg, const tXYZ tip_xyz) {
+    Call("StereoCamera_Measure");
+    Q_UNUSED(pose1)
+    Q_UNUSED(pose2)
+    Q_UNUSED(values)
+    Q_UNUSED(time_avg)
+    Q_UNUSED(tip_xyz)
+    npoints1 = 0;
+    npoints2 = 0;
+    return -1;
+}
+
+Item MockRoboDK::BuildMechanism(int type, const QList<Item> &list_obj, const double *parameters, const tJoints &joints_build, const tJoints &joints_home, const tJoints &joints_senses, const tJoints &joints_lim_low, const tJoints &joints_lim_high, const Mat base, const Mat tool, const QString &name, Item robot) {
+    Call("BuildMechanism");
+    Q_UNUSED(type)
+    Q_UNUSED(list_obj)
+    Q_UNUSED(parameters)
+    Q_UNUSED(joints_build)
+    Q_UNUSED(joints_home)
+    Q_UNUSED(joints_senses)
+    Q_UNUSED(joints_lim_low)
+    Q_UNUSED(joints_lim_high)
+    Q_UNUSED(base)
+    Q_UNUSED(tool)
+    Q_UNUSED(name)
+    Q_UNUSED(robot)
+    return nullptr;
+}
+
+Item MockRoboDK::Cam2D_Add(const Item attach_to, const QString &cam_params) {
+    Call("Cam2D_Add");
+    Q_UNUSED(cam_params)
+    MockItem *parent = attach_to != nullptr ? static_cast<MockItem*>(attach_to) : station_active;
+    return parent != nullptr ? AddItem(IItem::ITEM_TYPE_CAMERA, "Camera", parent) : nullptr;
+}
+
+QImage MockRoboDK::Cam2D_Snapshot(const QString &file, const Item camera, const QString &cam_params) {
+    Call("Cam2D_Snapshot");
+    Q_UNUSED(file)
+    Q_UNUSED(camera)
+    Q_UNUSED(cam_params)
+    return QImage();
+}
+
+Item MockRoboDK::MergeItems(const QList<Item> &listitems) {
+    Call("MergeItems");
+    return listitems.isEmpty() ? nullptr : listitems.first();
+}
@@ -0,0 +1,186 @@
+#ifndef MOCKROBODK_H
+#define MOCKROBODK_H
+
+#include "irobodk.h"
+
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QStringList>
+
+#include <functional>
+
+
+class MockItem;
+
+
+///
+/// \brief The MockRoboDK class implements IRoboDK in memory so that plugins can run without RoboDK.
+/// The station tree is built from a script (see \ref LoadStation). Every API call (including the calls to the items)
+/// is counted and can be delayed by a configurable latency, which emulates the cost of the real RoboDK calls.
+/// Collisions are computed with one sphere per item (see MockItem::collision_radius).
+///
+class MockRoboDK : public IRoboDK
+{
+public:
+    MockRoboDK();
+    ~MockRoboDK() override;
+
+    //------------------------------- Mock station ------------------------------
+
+    ///
+    /// \brief Add the items of a station script to a new station. One item per line:
+    ///     station NAME
+    ///     frame|object|target|program NAME [parent=NAME] [pose=x,y,z,r,p,w] [radius=mm]
+    ///     robot|axes NAME [parent=NAME] [pose=...] dh=alpha,a,theta,d;... [prismatic=0,1,...] [joints=...] [lower=...] [upper=...]
+    ///     tool NAME parent=ROBOT [tcp=x,y,z,r,p,w] [radius=mm]
+    /// Poses are in mm and deg (XYZRPW), names with spaces must be quoted.
+    /// \return false if a line could not be parsed (\a error describes the problem)
+    ///
+    bool LoadStation(const QStringList &lines, QString *error);
+
+    /// Add a new item to the station tree
+    MockItem *AddItem(int type, const QString &name, MockItem *parent);
+
+    /// Remove an item (and its children) from the station tree. The item remains allocated until the host is deleted.
+    void RemoveItem(MockItem *item);
+
+    ///
+    /// \brief Set the latency of an API call (busy wait)
+    /// \param method name of the method (for example "SolveIK" or "Render"), or "*" for all methods
+    /// \param latency_us latency in microseconds
+    ///
+    void SetLatency(const QString &method, double latency_us);
+
+    /// Count an API call and apply its latency. Called by every method of MockRoboDK and MockItem.
+    void Call(const char *method);
+
+    /// Number of calls of each API method since the last \ref ResetCalls
+    QMap<QString, quint64> Calls() const;
+
+    /// Reset the call counters
+    void ResetCalls();
+
+    /// Split a script line in words separated by spaces. Words with spaces must be quoted.
+    static QStringList SplitWords(const QString &line);
+
+    /// Callback used by IRoboDK::PluginCommand (set by the host)
+    std::function<QString(const QString&, const QString&, const QString&)> on_plugin_command;
+
+    //------------------------------- IRoboDK ------------------------------
+
+    Item getItem(const QString &name, int itemtype = -1) override;
+    QStringList getItemListNames(int filter = -1) override;
+    QList<Item> getItemList(int filter = -1) override;
+    bool Valid(const Item item_check) override;
+    Item ItemUserPick(const QString &message = "Pick one item", int itemtype = -1) override;
+    Item ItemUserPick(const QString &message, const QList<Item> &list_choices, int id_selected=-1) override;
+    void ShowRoboDK() override;
+    void HideRoboDK() override;
+    void CloseRoboDK() override;
+    QString Version() override;
+    void setWindowState(int windowstate = WINDOWSTATE_NORMAL) override;
+    void setFlagsRoboDK(int flags = FLAG_ROBODK_ALL) override;
+    void setFlagsItem(int flags = FLAG_ITEM_ALL, Item item=nullptr) override;
+    int getFlagsItem(Item item) override;
+    void ShowMessage(const QString &message, bool popup = true) override;
+    Item AddFile(const QString &filename, const Item parent=nullptr) override;
+    void Save(const QString &filename, const Item itemsave=nullptr) override;
+    Item AddShape(const tMatrix2D *trianglePoints, Item addTo = nullptr, bool shapeOverride = false, tColor *color = nullptr) override;
+    Item AddCurve(const tMatrix2D *curvePoints, Item referenceObject = nullptr,bool addToRef = false,int ProjectionType = PROJECTION_ALONG_NORMAL_RECALC) override;
+    Item AddPoints(const tMatrix2D *points, Item referenceObject = nullptr, bool addToRef = false, int ProjectionType =  PROJECTION_ALONG_NORMAL_RECALC) override;
+    bool ProjectPoints(tMatrix2D *points, Item objectProject, int ProjectionType = PROJECTION_ALONG_NORMAL_RECALC) override;
+    void CloseStation() override;
+    Item AddTarget(const QString &name, Item itemparent = nullptr, Item itemrobot = nullptr) override;
+    Item AddFrame(const QString &name, Item itemparent = nullptr) override;
+    Item AddProgram(const QString &name, Item itemrobot = nullptr) override;
+    Item AddStation(QString name) override;
+    Item AddMachiningProject(QString name = "Curve follow settings", Item itemrobot = nullptr) override;
+    QList<Item> getOpenStations() override;
+    void setActiveStation(Item stn) override;
+    Item getActiveStation() override;
+    int RunProgram(const QString &function_w_params) override;
+    int RunCode(const QString &code, bool code_is_fcn_call = false) override;
+    void RunMessage(const QString &message, bool message_is_comment = false) override;
+    void Render(int flags=RenderComplete) override;
+    bool IsInside(Item object_inside, Item object_parent) override;
+    int setCollisionActive(int check_state = COLLISION_ON) override;
+    bool setCollisionActivePair(int check_state, Item item1, Item item2, int id1 = 0, int id2 = 0) override;
+    int Collisions() override;
+    int Collision(Item item1, Item item2) override;
+    QList<Item> getCollisionItems(QList<int> *link_id_list=nullptr) override;
+    void setSimulationSpeed(double speed) override;
+    double SimulationSpeed() override;
+    void setRunMode(int run_mode = 1) override;
+    int RunMode() override;
+    QList<QPair<QString, QString> > getParams() override;
+    QString getParam(const QString &param) override;
+    void setParam(const QString &param, const QString &value) override;
+    QString Command(const QString &cmd, const QString &value="") override;
+    bool LaserTrackerMeasure(tXYZ xyz, const tXYZ estimate, bool search = false) override;
+    bool MeasurePose(Mat *pose, double data[10], int target=-1, int time_avg_ms=0, const tXYZ tool_tip=nullptr) override;
+    bool CollisionLine(const tXYZ p1, const tXYZ p2) override;
+    void CalibrateTool(const tMatrix2D *poses_joints, tXYZ tcp_xyz, int format=EULER_RX_RY_RZ, int algorithm=CALIBRATE_TCP_BY_POINT, Item robot=nullptr, double *error_stats=nullptr) override;
+    Mat CalibrateReference(const tMatrix2D *poses_joints, int method = CALIBRATE_FRAME_3P_P1_ON_X, bool use_joints = false, Item robot = nullptr) override;
+    bool ProgramStart(const QString &progname, const QString &defaultfolder = "", const QString &postprocessor = "", Item robot = nullptr) override;
+    void setViewPose(const Mat &pose) override;
+    Mat ViewPose() override;
+    bool SetRobotParams(Item robot,tMatrix2D dhm, Mat poseBase, Mat poseTool) override;
+    Item getCursorXYZ(int x = -1, int y = -1, tXYZ xyzStation = nullptr) override;
+    QString License() override;
+    QList<Item> Selection() override;
+    Item Popup_ISO9283_CubeProgram(Item robot=nullptr, tXYZ center=nullptr, double side=-1) override;
+    QByteArray getData(const QString &param) override;
+    void setData(const QString &param, const QByteArray &value) override;
+    int CollisionActive() override;
+    bool DrawGeometry(int drawtype, float *vtx_pointer, int vtx_size, float color[4], float geo_size=2.0, float *vtx_normals=nullptr) override;
+    bool DrawTexture(const QImage *image, const float *vtx_pointer, const float *texture_coords, int num_triangles, float *vtx_normals=nullptr) override;
+    void setSelection(const QList<Item> &listitems) override;
+    void setInteractiveMode(int mode_type, int default_ref_flags, const QList<Item> *custom_object=nullptr, int custom_ref_flags=0) override;
+    void PluginLoad(const QString &plugin_name="", int load=1) override;
+    QString PluginCommand(const QString &plugin_name="", const QString &plugin_command="", const QString &value="") override;
+    QByteArray getParamBytes(const QString &param) override;
+    void setParamBytes(const QString &param, const QByteArray &value) override;
+    int StereoCamera_Measure(Mat pose1, Mat pose2, int &npoints1, int &npoints2, double *data=nullptr, float time_avg=0, const tXYZ tip_xyz=nullptr) override;
+    Item BuildMechanism(int type, const QList<Item> &list_obj, const double *parameters, const tJoints &joints_build, const tJoints &joints_home, const tJoints &joints_senses, const tJoints &joints_lim_low, const tJoints &joints_lim_high, const Mat base, const Mat tool, const QString &name, Item robot=nullptr) override;
+    Item Cam2D_Add(const Item attach_to, const QString &params="") override;
+    QImage Cam2D_Snapshot(const QString &file, const Item camera=nullptr, const QString &params="") override;
+    Item MergeItems(const QList<Item> &listitems) override;
+
+private:
+    /// Items of a station (depth first, excluding the station item), optionally filtered by type
+    void collect_items(MockItem *parent, int filter, QList<Item> *list) const;
+
+    /// Returns true if the collision spheres of 2 items overlap
+    bool spheres_collide(MockItem *item1, MockItem *item2);
+
+    /// Returns true if an item can collide (visible, with a collision radius)
+    static bool collision_candidate(MockItem *item);
+
+private:
+    /// All items ever created (owned)
+    QList<MockItem*> items;
+
+    /// Items in the station tree, for fast validation of item pointers
+    QSet<Item> items_alive;
+
+    QList<Item> stations;
+    MockItem *station_active = nullptr;
+
+    QMap<QString, QString> params;
+    QMap<QString, QByteArray> data;
+    QList<Item> selection;
+    Mat view_pose;
+    int collision_active = COLLISION_OFF;
+    double simulation_speed = 5.0;
+    int run_mode = RUNMODE_SIMULATE;
+
+    /// Latency of each method in nanoseconds (latency_all applies to the methods not in the table)
+    QHash<QByteArray, qint64> latency_ns;
+    qint64 latency_all_ns = 0;
+
+    /// Number of calls of each method
+    QHash<QByteArray, quint64> calls;
+};
+
+#endif // MOCKROBODK_H
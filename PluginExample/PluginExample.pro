@@ -91,10 +91,14 @@ CONFIG(release, debug|release) {
 # This can be modified manually or automatically by Qt Creator
 HEADERS += \
     pluginexample.h \
+    pluginbenchmark.h \
+    collisionsweep.h \
     formrobotpilot.h
 
 SOURCES += \
     pluginexample.cpp \
+    pluginbenchmark.cpp \
+    collisionsweep.cpp \
     formrobotpilot.cpp
 
 FORMS += \
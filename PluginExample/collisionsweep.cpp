@@ -0,0 +1,102 @@
+#include "collisionsweep.h"
+
+#include <QPair>
+#include <QStringList>
+
+
+CollisionSweep::Result CollisionSweep::Exhaustive(int nsteps, const CollisionCheck &collides) {
+    Result result;
+    result.steps = nsteps;
+    result.states.resize(nsteps);
+    for (int i = 0; i < nsteps; i++) {
+        result.states[i] = collides(i);
+    }
+    result.evaluations = nsteps;
+    result.intervals = Intervals(result.states);
+    return result;
+}
+
+CollisionSweep::Result CollisionSweep::Adaptive(int nsteps, int coarse_step, const CollisionCheck &collides, const JointDistance &distance, double max_jump) {
+    Result result;
+    result.steps = nsteps;
+    if (nsteps <= 0) {
+        return result;
+    }
+    coarse_step = qMax(1, coarse_step);
+
+    // -1: not evaluated, 0: free, 1: collision
+    QVector<qint8> known(nsteps, -1);
+    auto evaluate = [&](int step) -> qint8 {
+        if (known[step] < 0) {
+            known[step] = collides(step) ? 1 : 0;
+            result.evaluations++;
+        }
+        return known[step];
+    };
+
+    // Coarse pass: both ends of the path are always evaluated
+    QVector<QPair<int, int>> segments;
+    int previous = 0;
+    evaluate(0);
+    for (int step = coarse_step; previous < nsteps - 1; step += coarse_step) {
+        int next = qMin(step, nsteps - 1);
+        evaluate(next);
+        segments.append(qMakePair(previous, next));
+        previous = next;
+    }
+
+    // Bisect the segments that may hide a change of state, down to consecutive steps
+    while (!segments.isEmpty()) {
+        QPair<int, int> segment = segments.takeLast();
+        const int first = segment.first;
+        const int last = segment.second;
+        if (last - first <= 1) {
+            continue;
+        }
+        if (known[first] == known[last] && distance(first, last) <= max_jump) {
+            continue;
+        }
+        int middle = (first + last) / 2;
+        evaluate(middle);
+        segments.append(qMakePair(first, middle));
+        segments.append(qMakePair(middle, last));
+    }
+
+    // Steps that were not evaluated lie in a segment with the same state at both ends
+    result.states.resize(nsteps);
+    qint8 state = known[0];
+    for (int i = 0; i < nsteps; i++) {
+        if (known[i] >= 0) {
+            state = known[i];
+        }
+        result.states[i] = (state == 1);
+    }
+    result.intervals = Intervals(result.states);
+    return result;
+}
+
+QVector<CollisionInterval> CollisionSweep::Intervals(const QVector<bool> &states) {
+    QVector<CollisionInterval> intervals;
+    for (int i = 0; i < states.size(); i++) {
+        if (!states[i]) {
+            continue;
+        }
+        if (!intervals.isEmpty() && intervals.last().last == i - 1) {
+            intervals.last().last = i;
+        } else {
+            CollisionInterval interval;
+            interval.first = i;
+            interval.last = i;
+            intervals.append(interval);
+        }
+    }
+    return intervals;
+}
+
+QString CollisionSweep::IntervalsToString(const QVector<CollisionInterval> &intervals) {
+    QStringList list;
+    for (const CollisionInterval &interval : intervals) {
+        list.append(interval.first == interval.last ? QString::number(interval.first) : QString("%1-%2").arg(interval.first).arg(interval.last));
+    }
+    return list.isEmpty() ? QString("none") : list.join(", ");
+}
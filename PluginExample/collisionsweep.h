@@ -0,0 +1,73 @@
+#ifndef COLLISIONSWEEP_H
+#define COLLISIONSWEEP_H
+
+#include <QString>
+#include <QVector>
+
+#include <functional>
+
+
+/// Range of consecutive steps of a path in collision (inclusive)
+struct CollisionInterval {
+    int first = 0;
+    int last = 0;
+
+    bool operator==(const CollisionInterval &other) const {
+        return first == other.first && last == other.last;
+    }
+};
+
+
+///
+/// \brief The CollisionSweep class finds the collision intervals along a path of joint steps.
+/// The exhaustive sweep evaluates every step. The adaptive sweep evaluates the path at a coarse step first and
+/// bisects only the segments whose ends have a different collision state or whose joints move more than a given
+/// distance, down to single steps. Segments that are skipped take the collision state of both ends.
+///
+class CollisionSweep {
+public:
+    /// Returns true if the robot collides at a step of the path
+    typedef std::function<bool(int step)> CollisionCheck;
+
+    /// Returns the largest joint difference between two steps of the path (deg or mm)
+    typedef std::function<double(int step1, int step2)> JointDistance;
+
+    /// Result of a sweep
+    struct Result {
+        /// Number of steps of the path
+        int steps = 0;
+
+        /// Number of steps evaluated (collision checks)
+        int evaluations = 0;
+
+        /// Collision state of each step (evaluated or deduced)
+        QVector<bool> states;
+
+        /// Ranges of consecutive steps in collision
+        QVector<CollisionInterval> intervals;
+
+        /// Number of collision checks saved compared to the exhaustive sweep
+        int Saved() const { return steps - evaluations; }
+    };
+
+    /// Evaluate every step of the path
+    static Result Exhaustive(int nsteps, const CollisionCheck &collides);
+
+    ///
+    /// \brief Evaluate the path at a coarse step and bisect the segments around collision state changes and large joint jumps.
+    /// \param nsteps number of steps of the path
+    /// \param coarse_step number of steps between evaluations of the first pass
+    /// \param collides collision check of one step
+    /// \param distance joint distance between two steps
+    /// \param max_jump segments whose joints move more than this distance are always bisected (deg or mm)
+    ///
+    static Result Adaptive(int nsteps, int coarse_step, const CollisionCheck &collides, const JointDistance &distance, double max_jump);
+
+    /// Ranges of consecutive steps in collision
+    static QVector<CollisionInterval> Intervals(const QVector<bool> &states);
+
+    /// List of intervals as text, for example "12-40, 120-122"
+    static QString IntervalsToString(const QVector<CollisionInterval> &intervals);
+};
+
+#endif // COLLISIONSWEEP_H
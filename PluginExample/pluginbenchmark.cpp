@@ -0,0 +1,158 @@
+#include "pluginbenchmark.h"
+
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QStringList>
+
+#include <algorithm>
+#include <cmath>
+
+
+// Nearest-rank percentile of a sorted list of samples
+static qint64 Percentile(const QVector<qint64> &sorted, double percent) {
+    int rank = static_cast<int>(std::ceil(percent / 100.0 * sorted.size())) - 1;
+    return sorted[qBound(0, rank, sorted.size() - 1)];
+}
+
+QJsonObject BenchmarkResult::toJson() const {
+    QJsonObject obj;
+    obj["name"] = name;
+    obj["samples"] = samples;
+    obj["batch"] = batch;
+    obj["mean_us"] = mean_us;
+    obj["stddev_us"] = stddev_us;
+    obj["cv"] = cv;
+    obj["min_us"] = min_us;
+    obj["p50_us"] = p50_us;
+    obj["p95_us"] = p95_us;
+    obj["p99_us"] = p99_us;
+    obj["max_us"] = max_us;
+    if (allocations >= 0.0) {
+        obj["allocations"] = allocations;
+    }
+    return obj;
+}
+
+BenchmarkResult BenchmarkResult::fromJson(const QJsonObject &obj) {
+    BenchmarkResult result;
+    result.name = obj["name"].toString();
+    result.samples = obj["samples"].toInt();
+    result.batch = obj["batch"].toInt(1);
+    result.mean_us = obj["mean_us"].toDouble();
+    result.stddev_us = obj["stddev_us"].toDouble();
+    result.cv = obj["cv"].toDouble();
+    result.min_us = obj["min_us"].toDouble();
+    result.p50_us = obj["p50_us"].toDouble();
+    result.p95_us = obj["p95_us"].toDouble();
+    result.p99_us = obj["p99_us"].toDouble();
+    result.max_us = obj["max_us"].toDouble();
+    result.allocations = obj["allocations"].toDouble(-1.0);
+    return result;
+}
+
+const BenchmarkResult &BenchmarkSuite::Run(const QString &name, int warmup, int samples, int batch, const std::function<void()> &operation) {
+    batch = qMax(1, batch);
+
+    // Warm up caches, lazy initializations and the CPU frequency before measuring
+    for (int i = 0; i < warmup; i++) {
+        operation();
+    }
+
+    QVector<qint64> samples_ns;
+    samples_ns.reserve(samples);
+    QElapsedTimer timer;
+    for (int i = 0; i < samples; i++) {
+        timer.start();
+        for (int j = 0; j < batch; j++) {
+            operation();
+        }
+        samples_ns.append(timer.nsecsElapsed());
+    }
+    return Add(name, samples_ns, batch);
+}
+
+const BenchmarkResult &BenchmarkSuite::Add(const QString &name, QVector<qint64> samples_ns, int batch, double allocations) {
+    BenchmarkResult result;
+    result.name = name;
+    result.samples = samples_ns.size();
+    result.batch = qMax(1, batch);
+    result.allocations = allocations;
+    if (!samples_ns.isEmpty()) {
+        std::sort(samples_ns.begin(), samples_ns.end());
+        const double scale = 1e-3 / result.batch; // ns per sample to us per call
+
+        double sum = 0.0;
+        for (qint64 value : samples_ns) {
+            sum += value;
+        }
+        double mean = sum / samples_ns.size();
+        double sum_sq = 0.0;
+        for (qint64 value : samples_ns) {
+            sum_sq += (value - mean) * (value - mean);
+        }
+        double stddev = samples_ns.size() > 1 ? std::sqrt(sum_sq / (samples_ns.size() - 1)) : 0.0;
+
+        result.mean_us = mean * scale;
+        result.stddev_us = stddev * scale;
+        result.cv = mean > 0.0 ? stddev / mean : 0.0;
+        result.min_us = samples_ns.first() * scale;
+        result.p50_us = Percentile(samples_ns, 50) * scale;
+        result.p95_us = Percentile(samples_ns, 95) * scale;
+        result.p99_us = Percentile(samples_ns, 99) * scale;
+        result.max_us = samples_ns.last() * scale;
+    }
+    results.append(result);
+    return results.last();
+}
+
+void BenchmarkSuite::Clear() {
+    results.clear();
+}
+
+const QVector<BenchmarkResult> &BenchmarkSuite::Results() const {
+    return results;
+}
+
+QJsonObject BenchmarkSuite::ToJson(const QJsonObject &environment) const {
+    QJsonArray list;
+    for (const BenchmarkResult &result : results) {
+        list.append(result.toJson());
+    }
+    QJsonObject report;
+    report["version"] = FormatVersion;
+    report["environment"] = environment;
+    report["results"] = list;
+    return report;
+}
+
+BenchmarkComparison BenchmarkSuite::Compare(const QJsonObject &current, const QJsonObject &baseline, double threshold) {
+    BenchmarkComparison comparison;
+    const QJsonArray baseline_list = baseline["results"].toArray();
+    for (const QJsonValue &value : current["results"].toArray()) {
+        BenchmarkResult result = BenchmarkResult::fromJson(value.toObject());
+        for (const QJsonValue &base_value : baseline_list) {
+            BenchmarkResult base = BenchmarkResult::fromJson(base_value.toObject());
+            if (base.name != result.name || base.p50_us <= 0.0) {
+                continue;
+            }
+
+            double change = result.p50_us / base.p50_us - 1.0;
+            double limit = qMax(threshold, qMax(result.cv, base.cv));
+            bool regression = change > limit;
+            QString line = QString("%1: p50 %2 us -> %3 us (%4%5%)").arg(result.name)
+                    .arg(base.p50_us, 0, 'f', 3).arg(result.p50_us, 0, 'f', 3)
+                    .arg(QString(change >= 0 ? "+" : "")).arg(100.0 * change, 0, 'f', 1);
+            if (regression) {
+                line += QString(" REGRESSION (limit +%1%)").arg(100.0 * limit, 0, 'f', 1);
+                comparison.regressions.append(result.name);
+            } else if (result.allocations >= 0.0 && base.allocations >= 0.0 && result.allocations > base.allocations + 0.01) {
+                // Allocations are deterministic: any increase is a regression
+                line += QString(" REGRESSION (allocations %1 -> %2 per call)").arg(base.allocations, 0, 'f', 2).arg(result.allocations, 0, 'f', 2);
+                comparison.regressions.append(result.name);
+            }
+            comparison.lines.append(line);
+            break;
+        }
+    }
+    return comparison;
+}
@@ -0,0 +1,101 @@
+#ifndef PLUGINBENCHMARK_H
+#define PLUGINBENCHMARK_H
+
+#include <QString>
+#include <QVector>
+#include <QJsonObject>
+
+#include <functional>
+
+
+///
+/// \brief Statistics of one benchmarked operation. All times are in microseconds per call.
+///
+struct BenchmarkResult {
+    /// Name of the operation (also used as the key to compare with a baseline)
+    QString name;
+
+    /// Number of timed samples
+    int samples = 0;
+
+    /// Number of calls timed together in each sample (fast operations are batched to hide the timer overhead)
+    int batch = 1;
+
+    double mean_us = 0.0;
+    double stddev_us = 0.0;
+
+    /// Coefficient of variation (standard deviation / mean): values above ~0.1 mean the measurement is noisy
+    double cv = 0.0;
+
+    double min_us = 0.0;
+    double p50_us = 0.0;
+    double p95_us = 0.0;
+    double p99_us = 0.0;
+    double max_us = 0.0;
+
+    /// Heap allocations per call (negative if allocations were not counted)
+    double allocations = -1.0;
+
+    QJsonObject toJson() const;
+    static BenchmarkResult fromJson(const QJsonObject &obj);
+};
+
+
+///
+/// \brief Result of comparing a benchmark run with a baseline run.
+///
+struct BenchmarkComparison {
+    /// One line per operation found in both runs
+    QStringList lines;
+
+    /// Operations slower than the baseline by more than the threshold
+    QStringList regressions;
+};
+
+
+///
+/// \brief The BenchmarkSuite class times operations with a warm-up phase and collects robust statistics.
+/// The results can be exported to JSON and compared with a previous run (baseline) to detect regressions.
+///
+class BenchmarkSuite {
+public:
+    /// JSON format version, written to the "version" field
+    static const int FormatVersion = 1;
+
+    ///
+    /// \brief Time an operation.
+    /// \param name name of the operation
+    /// \param warmup number of calls executed before measuring (not timed)
+    /// \param samples number of timed samples
+    /// \param batch number of calls per sample
+    /// \param operation operation to benchmark
+    /// \return statistics of the operation (also stored in the suite)
+    ///
+    const BenchmarkResult &Run(const QString &name, int warmup, int samples, int batch, const std::function<void()> &operation);
+
+    /// Compute the statistics of a list of samples (in nanoseconds per sample) and add them to the suite.
+    /// \a allocations is the number of heap allocations per call, if they were counted.
+    const BenchmarkResult &Add(const QString &name, QVector<qint64> samples_ns, int batch = 1, double allocations = -1.0);
+
+    /// Remove all results
+    void Clear();
+
+    /// Results, in the order they were measured
+    const QVector<BenchmarkResult> &Results() const;
+
+    /// Complete report: version, environment (free form) and the list of results
+    QJsonObject ToJson(const QJsonObject &environment) const;
+
+    ///
+    /// \brief Compare a report with a baseline report (both as returned by \ref ToJson).
+    /// An operation is flagged as a regression if its median (p50) is slower than the baseline by more than
+    /// \a threshold (relative). Noisy measurements raise the threshold to the largest coefficient of variation of both runs.
+    /// Operations that make more heap allocations per call than the baseline are also flagged (when both runs counted them).
+    ///
+    static BenchmarkComparison Compare(const QJsonObject &current, const QJsonObject &baseline, double threshold = 0.10);
+
+private:
+    QVector<BenchmarkResult> results;
+};
+
+#endif // PLUGINBENCHMARK_H
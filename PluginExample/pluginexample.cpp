@@ -4,6 +4,8 @@
 #include "iitem.h"
 
 #include "formrobotpilot.h"
+#include "pluginbenchmark.h"
+#include "collisionsweep.h"
 
 #include <QMainWindow>
 #include <QToolBar>
@@ -21,6 +23,9 @@
 #include <QSysInfo>
 #include <QThread>
 #include <QVector>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonArray>
 
 // Platform-specific headers used only to read the CPU model/frequency and total RAM
 // (Qt does not expose this information through a cross-platform API)
@@ -30,10 +35,15 @@
 #elif defined(Q_OS_MACOS)
 #include <sys/sysctl.h>
 #elif defined(Q_OS_LINUX)
-#include <QFile>
 #include <unistd.h>
 #endif
 
+// Number of program steps between the collision checks of the first pass of the adaptive sweep
+static const int SWEEP_COARSE_STEP = 16;
+
+// Segments of the adaptive sweep where a joint moves more than this (deg or mm) are always bisected
+static const double SWEEP_MAX_JUMP = 10.0;
+
 //------------------------------- RoboDK Plug-in commands ------------------------------
 
 
@@ -152,6 +162,24 @@ QString PluginExample::PluginCommand(const QString &command, const QString &valu
     } else if (command.compare("RobotPilot", Qt::CaseInsensitive) == 0) {
         callback_robotpilot();
         return "Done";
+    } else if (command.compare("CollisionSweep", Qt::CaseInsensitive) == 0) {
+        // Adaptive collision sweep of a program: "progname", "progname,coarse_step" or "progname,coarse_step,max_jump"
+        int coarse_step = value.section(',', 1, 1).toInt();
+        double max_jump = value.section(',', 2, 2).toDouble();
+        return collision_sweep(value.section(',', 0, 0).trimmed(), coarse_step > 0 ? coarse_step : SWEEP_COARSE_STEP, max_jump > 0.0 ? max_jump : SWEEP_MAX_JUMP);
+    } else if (command.compare("BenchmarkJson", Qt::CaseInsensitive) == 0) {
+        // Report of the last benchmark as JSON, optionally saved to the file given as value
+        QByteArray json = QJsonDocument(benchmark_report).toJson(QJsonDocument::Compact);
+        if (!value.isEmpty()) {
+            QFile file(value);
+            if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(benchmark_report).toJson()) < 0) {
+                return tr("Unable to write %1").arg(value);
+            }
+        }
+        return QString::fromUtf8(json);
+    } else if (command.compare("BenchmarkCompare", Qt::CaseInsensitive) == 0) {
+        // Compare the last benchmark with a baseline report: "baseline.json" or "baseline.json,threshold" (relative, defaults to 0.1)
+        return benchmark_compare(value.section(',', 0, 0).trimmed(), value.section(',', 1, 1).toDouble());
     }
 
     return "";
@@ -437,6 +465,13 @@ static QVector<BenchmarkRow> HardwareInfoRows() {
     return rows;
 }
 
+// Formats the statistics of one benchmarked operation as a table row (all values in microseconds per call)
+static BenchmarkRow BenchmarkResultRow(const BenchmarkResult &result) {
+    return {result.name, QString("%1 | %2 | %3 | %4 | %5 | %6%")
+                .arg(result.mean_us, 0, 'f', 2).arg(result.p50_us, 0, 'f', 2).arg(result.p95_us, 0, 'f', 2)
+                .arg(result.p99_us, 0, 'f', 2).arg(result.max_us, 0, 'f', 2).arg(100.0 * result.cv, 0, 'f', 1)};
+}
+
 // Formats a full-width section header row inside the benchmark table (keeps everything in one
 // table so both columns stay the same width instead of each table sizing itself independently)
 static QString BenchmarkSectionRowHtml(const QString &title) {
@@ -472,6 +507,26 @@ static QString BenchmarkTableText(const QVector<BenchmarkRow> &rows) {
     return text;
 }
 
+// Moves the robot to one step of a program joint list and returns true if it collides
+// Each column of the matrix holds one step: [J1..Jn, ERROR, MM_STEP, DEG_STEP, MOVE_ID]
+static bool ProgramStepCollides(RoboDK *rdk, Item robot, const tMatrix2D *list_joints, int col, int ndofs) {
+    tJoints step_joints(list_joints, col, ndofs);
+    robot->setJoints(step_joints);
+    rdk->Render(IRoboDK::RenderUpdateOnly);
+    return rdk->Collisions() > 0;
+}
+
+// Largest joint difference between two steps of a program joint list
+static double ProgramStepDistance(const tMatrix2D *list_joints, int col1, int col2, int ndofs) {
+    const double *joints1 = Matrix2D_Get_col(list_joints, col1);
+    const double *joints2 = Matrix2D_Get_col(list_joints, col2);
+    double distance = 0.0;
+    for (int i = 0; i < ndofs; i++) {
+        distance = qMax(distance, qAbs(joints2[i] - joints1[i]));
+    }
+    return distance;
+}
+
 void PluginExample::callback_benchmarkInfo(const QString &progname) {
     static QDockWidget *dockedInfo = nullptr;
     if (dockedInfo != nullptr) {
@@ -499,63 +554,91 @@ void PluginExample::callback_benchmarkInfo(const QString &progname) {
     // available afterwards to print the plain-text console report
     QVector<BenchmarkRow> benchmark_rows;
 
-    const int ntests = 10000;
+    // Number of warm-up calls, timed samples and calls per sample of the fast (kinematic) operations
+    const int nwarmup = 1000;
+    const int nsamples = 1000;
+    const int nbatch = 10;
+
+    BenchmarkSuite suite;
+    QJsonObject environment;
+    environment["date"] = QDateTime::currentDateTime().toString(Qt::ISODate);
+
     Item robot = RDK->ItemUserPick("Select a robot arm", IItem::ITEM_TYPE_ROBOT_ARM);
     if (ItemValid(robot)) {
-        Mat pose_fk;
+        const tJoints joints_start = robot->Joints();
+        const Mat pose_fk = robot->SolveFK(joints_start);
+        Mat pose_abs;
         tJoints joints_ik;
         QList<tJoints> joints_ik_all;
-        QElapsedTimer timer;
+        QList<Mat> joint_poses;
 
         benchmark_rows.append({"Robot", robot->Name()});
         benchmark_rows += HardwareInfoRows();
-
-        // Test Forward Kinematics (QElapsedTimer gives nanosecond resolution, unlike QDateTime's millisecond ticks)
-        timer.start();
-        for (int i = 0; i < ntests; i++) {
-            pose_fk = robot->SolveFK(robot->Joints());
+        environment["robot"] = robot->Name();
+        for (const BenchmarkRow &row : benchmark_rows) {
+            if (row.metric != "Robot") {
+                environment[row.metric.toLower()] = row.value;
+            }
         }
-        benchmark_rows.append({"Forward Kinematics", QString("%1 microseconds").arg((1e-3 * timer.nsecsElapsed()) / ntests, 0, 'f', 2)});
+        benchmark_rows.append({tr("Timing in microseconds per call: mean | p50 | p95 | p99 | max | CV"), QString(), true});
 
-        // Test Inverse Kinematics
-        timer.start();
-        for (int i = 0; i < ntests; i++) {
+        // Each operation is warmed up first, then timed in batches (QElapsedTimer gives nanosecond resolution)
+        benchmark_rows.append(BenchmarkResultRow(suite.Run("Forward Kinematics", nwarmup, nsamples, nbatch, [&]() {
+            pose_abs = robot->SolveFK(joints_start);
+        })));
+        benchmark_rows.append(BenchmarkResultRow(suite.Run("Inverse Kinematics", nwarmup, nsamples, nbatch, [&]() {
             joints_ik = robot->SolveIK(pose_fk);
-        }
-        benchmark_rows.append({"Inverse Kinematics", QString("%1 microseconds").arg((1e-3 * timer.nsecsElapsed()) / ntests, 0, 'f', 2)});
-
-        // Test Inverse Kinematics (all solutions)
-        timer.start();
-        for (int i = 0; i < ntests; i++) {
+        })));
+        benchmark_rows.append(BenchmarkResultRow(suite.Run("Inverse Kinematics (all solutions)", nwarmup, nsamples, nbatch, [&]() {
             joints_ik_all = robot->SolveIK_All(pose_fk);
-        }
-        benchmark_rows.append({"Inverse Kinematics (all solutions)", QString("%1 microseconds").arg((1e-3 * timer.nsecsElapsed()) / ntests, 0, 'f', 2)});
+        })));
+        benchmark_rows.append(BenchmarkResultRow(suite.Run("Joint poses", nwarmup, nsamples, nbatch, [&]() {
+            joint_poses = robot->JointPoses(joints_start);
+        })));
+        benchmark_rows.append(BenchmarkResultRow(suite.Run("Absolute pose", nwarmup, nsamples, nbatch, [&]() {
+            pose_abs = robot->PoseAbs();
+        })));
+        benchmark_rows.append(BenchmarkResultRow(suite.Run("Set joints", nwarmup, nsamples, nbatch, [&]() {
+            robot->setJoints(joints_start);
+        })));
+        benchmark_rows.append(BenchmarkResultRow(suite.Run("Render (update only)", 10, 200, 1, [&]() {
+            RDK->Render(IRoboDK::RenderUpdateOnly);
+        })));
 
-        // Test collisions for each inverse kinematics solution: fewer samples, but a more accurate timer (nanosecond accuracy)
-        RDK->Collisions(); // Run once first: the first call needs extra bookkeeping for all loaded objects if collision checking was not already on
-        timer.start();
+        // Test collisions for each inverse kinematics solution: fewer samples, timed one by one
+        // The warm-up runs once: the first call needs extra bookkeeping for all loaded objects if collision checking was not already on
         int nJoints = joints_ik_all.length();
         int nWithCollisions = 0;
         int nWithoutCollisions = 0;
-        for (int i = 0; i < nJoints; i++) {
-            robot->setJoints(joints_ik_all.at(i));
-            RDK->Render(IRoboDK::RenderUpdateOnly);
-            int nCollisions = RDK->Collisions();
-            if (nCollisions > 0) {
-                nWithCollisions++;
-            } else {
-                nWithoutCollisions++;
-            }
+        if (nJoints > 0) {
+            const int ncollision_samples = qMax(nJoints, 50);
+            int sample = 0;
+            RDK->Collisions();
+            const BenchmarkResult &collisions = suite.Run("Collision check", 0, ncollision_samples, 1, [&]() {
+                robot->setJoints(joints_ik_all.at(sample % nJoints));
+                RDK->Render(IRoboDK::RenderUpdateOnly);
+                int nCollisions = RDK->Collisions();
+                if (sample < nJoints) {
+                    if (nCollisions > 0) {
+                        nWithCollisions++;
+                    } else {
+                        nWithoutCollisions++;
+                    }
+                }
+                sample++;
+            });
+            double ms_collisions = 1e-3 * collisions.mean_us;
+            double samples_x_sec = 1000.0 / ms_collisions;
+            qDebug() << "ms per collision: " << ms_collisions;
+            qDebug() << "Collision samples per second: " << samples_x_sec;
+
+            benchmark_rows.append(BenchmarkResultRow(collisions));
+            benchmark_rows.append({QString("Collision check (%1 samples)").arg(ncollision_samples), QString("%1 ms/sample").arg(ms_collisions, 0, 'f', 2)});
+            benchmark_rows.append({"Collision check rate", QString("%1 samples/sec").arg(samples_x_sec, 0, 'f', 2)});
         }
-        double ms_collisions = (1e-6 * timer.nsecsElapsed()) / nJoints;
-        double samples_x_sec = 1000.0 / ms_collisions;
-        qDebug() << "ms per collision: " << ms_collisions;
-        qDebug() << "Collision samples per second: " << samples_x_sec;
-
-        benchmark_rows.append({QString("Collision check (%1 samples)").arg(nJoints), QString("%1 ms/sample").arg(ms_collisions, 0, 'f', 2)});
-        benchmark_rows.append({"Collision check rate", QString("%1 samples/sec").arg(samples_x_sec, 0, 'f', 2)});
         benchmark_rows.append({"Points with collisions", QString::number(nWithCollisions)});
         benchmark_rows.append({"Points without collisions", QString::number(nWithoutCollisions)});
+        robot->setJoints(joints_start);
 
         // Show the table now: the program collision check below can take a while for long programs
         text_message_html = header_html + BenchmarkTableHtml(benchmark_rows);
@@ -571,6 +654,7 @@ void PluginExample::callback_benchmarkInfo(const QString &progname) {
         if (ItemValid(program)) {
             // Section header row for the program results, added to the same table so both columns stay the same width
             benchmark_rows.append({QString("Program Collision Check: %1").arg(program->Name()), QString(), true});
+            environment["program"] = program->Name();
 
             RDK->ShowMessage("Calculating collisions for program: " + program->Name() + " ...", false);
             tMatrix2D *list_joints = Matrix2D_Create();
@@ -583,14 +667,17 @@ void PluginExample::callback_benchmarkInfo(const QString &progname) {
                 int nProgWithCollisions = 0;
                 int nProgWithoutCollisions = 0;
 
-                timer.start();
+                // Each step is timed separately so the distribution (and not only the mean) is reported
+                QVector<qint64> step_ns;
+                step_ns.reserve(nSteps);
+                QVector<bool> step_collisions(nSteps, false);
+                QElapsedTimer timer;
                 for (int col = 0; col < nSteps; col++) {
-                    // Each column of the matrix holds one step: [J1..Jn, ERROR, MM_STEP, DEG_STEP, MOVE_ID]
-                    tJoints step_joints(list_joints, col, nDOFs);
-                    robot->setJoints(step_joints);
-                    RDK->Render(IRoboDK::RenderUpdateOnly);
-                    int nCollisions = RDK->Collisions();
-                    if (nCollisions > 0) {
+                    timer.start();
+                    bool collision = ProgramStepCollides(RDK, robot, list_joints, col, nDOFs);
+                    step_ns.append(timer.nsecsElapsed());
+                    step_collisions[col] = collision;
+                    if (collision) {
                         nProgWithCollisions++;
                     } else {
                         nProgWithoutCollisions++;
@@ -601,13 +688,37 @@ void PluginExample::callback_benchmarkInfo(const QString &progname) {
                     }
                 }
                 RDK->Command("ProgressBar", "-1");
-                double ms_prog_collisions = (1e-6 * timer.nsecsElapsed()) / nSteps;
+                robot->setJoints(joints_start);
+
+                const BenchmarkResult &prog_collisions = suite.Add("Program collision check", step_ns);
+                double ms_prog_collisions = 1e-3 * prog_collisions.mean_us;
                 double prog_samples_x_sec = 1000.0 / ms_prog_collisions;
 
+                benchmark_rows.append(BenchmarkResultRow(prog_collisions));
                 benchmark_rows.append({QString("Collision check (%1 steps)").arg(nSteps), QString("%1 ms/step").arg(ms_prog_collisions, 0, 'f', 2)});
                 benchmark_rows.append({"Collision check rate", QString("%1 samples/sec").arg(prog_samples_x_sec, 0, 'f', 2)});
                 benchmark_rows.append({"Points with collisions", QString::number(nProgWithCollisions)});
                 benchmark_rows.append({"Points without collisions", QString::number(nProgWithoutCollisions)});
+
+                // Adaptive sweep of the same path: it must find the same collision intervals with fewer checks
+                QVector<CollisionInterval> intervals = CollisionSweep::Intervals(step_collisions);
+                timer.start();
+                CollisionSweep::Result adaptive = CollisionSweep::Adaptive(nSteps, SWEEP_COARSE_STEP, [&](int col) {
+                    return ProgramStepCollides(RDK, robot, list_joints, col, nDOFs);
+                }, [&](int col1, int col2) {
+                    return ProgramStepDistance(list_joints, col1, col2, nDOFs);
+                }, SWEEP_MAX_JUMP);
+                double ms_adaptive = 1e-6 * timer.nsecsElapsed();
+                double ms_exhaustive = 1e-3 * prog_collisions.mean_us * nSteps;
+                robot->setJoints(joints_start);
+
+                benchmark_rows.append({"Collision intervals", QString("%1 (steps %2)").arg(intervals.size()).arg(CollisionSweep::IntervalsToString(intervals))});
+                benchmark_rows.append({QString("Adaptive sweep (coarse step %1)").arg(SWEEP_COARSE_STEP), QString("%1 checks, %2 saved (%3%)")
+                                       .arg(adaptive.evaluations).arg(adaptive.Saved()).arg(100.0 * adaptive.Saved() / qMax(1, nSteps), 0, 'f', 1)});
+                benchmark_rows.append({"Adaptive sweep time", QString("%1 ms (%2 ms exhaustive, %3x faster)")
+                                       .arg(ms_adaptive, 0, 'f', 1).arg(ms_exhaustive, 0, 'f', 1).arg(ms_exhaustive / qMax(1e-6, ms_adaptive), 0, 'f', 1)});
+                benchmark_rows.append({"Adaptive sweep intervals", adaptive.intervals == intervals ? QString("Same as exhaustive sweep")
+                                       : QString("DIFFERENT: %1").arg(CollisionSweep::IntervalsToString(adaptive.intervals))});
             } else {
                 qDebug() << "InstructionListJoints failed: " << err_msg;
                 benchmark_rows.append({"Collision check", tr("Failed: %1").arg(err_msg)});
@@ -625,6 +736,9 @@ void PluginExample::callback_benchmarkInfo(const QString &progname) {
         text_editor->setHtml(text_message_html);
     }
 
+    // Keep the machine readable report of this run (see PluginCommand BenchmarkJson and BenchmarkCompare)
+    benchmark_report = suite.ToJson(environment);
+
     // Print the same results as an aligned, human-readable plain-text table in the console
     if (!benchmark_rows.isEmpty()) {
         qDebug().noquote() << "\n" + BenchmarkTableText(benchmark_rows);
@@ -657,3 +771,66 @@ void PluginExample::callback_robotpilot_closed() {
 void PluginExample::callback_help() {
     QDesktopServices::openUrl(QUrl("https://robodk.com/CreatePlugin"));
 }
+
+QString PluginExample::benchmark_compare(const QString &baseline_file, double threshold) {
+    if (benchmark_report.value("results").toArray().isEmpty()) {
+        return tr("No benchmark results: run BenchmarkInfo first");
+    }
+
+    QFile file(baseline_file);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return tr("Unable to read %1").arg(baseline_file);
+    }
+    QJsonParseError error;
+    QJsonDocument baseline = QJsonDocument::fromJson(file.readAll(), &error);
+    if (error.error != QJsonParseError::NoError || !baseline.isObject()) {
+        return tr("Invalid benchmark report %1: %2").arg(baseline_file, error.errorString());
+    }
+
+    BenchmarkComparison comparison = BenchmarkSuite::Compare(benchmark_report, baseline.object(), threshold > 0.0 ? threshold : 0.10);
+    QString report = comparison.lines.join("\n");
+    if (comparison.regressions.isEmpty()) {
+        report += "\nNo regressions";
+    } else {
+        report += QString("\n%1 regressions: %2").arg(comparison.regressions.size()).arg(comparison.regressions.join(", "));
+    }
+    qDebug().noquote() << "\nBenchmark compared with " + baseline_file + ":\n" + report;
+    return report;
+}
+
+QString PluginExample::collision_sweep(const QString &progname, int coarse_step, double max_jump) {
+    Item program = RDK->getItem(progname, IItem::ITEM_TYPE_PROGRAM);
+    if (!ItemValid(program)) {
+        return tr("Program not found: %1").arg(progname);
+    }
+    Item robot = program->getLink(IItem::ITEM_TYPE_ROBOT);
+    if (!ItemValid(robot)) {
+        return tr("No robot linked to program %1").arg(progname);
+    }
+
+    tMatrix2D *list_joints = Matrix2D_Create();
+    QString err_msg;
+    QString report;
+    if (program->InstructionListJoints(err_msg, list_joints, 1, 1, IRoboDK::COLLISION_OFF) >= 0) {
+        const tJoints joints_start = robot->Joints();
+        const int nDOFs = joints_start.Length();
+        const int nSteps = Matrix2D_Get_ncols(list_joints);
+        QElapsedTimer timer;
+        timer.start();
+        CollisionSweep::Result sweep = CollisionSweep::Adaptive(nSteps, coarse_step, [&](int col) {
+            return ProgramStepCollides(RDK, robot, list_joints, col, nDOFs);
+        }, [&](int col1, int col2) {
+            return ProgramStepDistance(list_joints, col1, col2, nDOFs);
+        }, max_jump);
+        robot->setJoints(joints_start);
+
+        report = QString("Collision intervals (steps): %1\n%2 checks of %3 steps (%4 saved) in %5 ms")
+                .arg(CollisionSweep::IntervalsToString(sweep.intervals)).arg(sweep.evaluations).arg(nSteps)
+                .arg(sweep.Saved()).arg(1e-6 * timer.nsecsElapsed(), 0, 'f', 1);
+    } else {
+        report = tr("InstructionListJoints failed: %1").arg(err_msg);
+    }
+    ::Matrix2D_Delete(&list_joints);
+    qDebug().noquote() << report;
+    return report;
+}
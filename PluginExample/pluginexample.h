@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QtPlugin>
 #include <QDockWidget>
+#include <QJsonObject>
 #include "iapprobodk.h"
 #include "robodktypes.h"
 
@@ -66,6 +67,24 @@ public slots:
     /// Called when the user selects the button/action for help
     void callback_help();
 
+private:
+    ///
+    /// \brief Compare the results of the last benchmark with a baseline report saved with PluginCommand("BenchmarkJson", file)
+    /// \param baseline_file JSON report of a previous benchmark
+    /// \param threshold relative slowdown of the median flagged as a regression (0.1 = 10%)
+    /// \return one line per operation, followed by the list of regressions
+    ///
+    QString benchmark_compare(const QString &baseline_file, double threshold);
+
+    ///
+    /// \brief Adaptive collision sweep of a program (see CollisionSweep::Adaptive)
+    /// \param progname name of the program
+    /// \param coarse_step number of steps between the collision checks of the first pass
+    /// \param max_jump segments where a joint moves more than this distance are always bisected (deg or mm)
+    /// \return collision intervals and number of collision checks
+    ///
+    QString collision_sweep(const QString &progname, int coarse_step, double max_jump);
+
 // define your actions: usually, one action per button
 private:
     /// Pointer to the customized toolbar
@@ -88,6 +107,9 @@ private:
 
     /// Pointer to the robot pilot form.
     FormRobotPilot *form_robotpilot;
+
+    /// JSON report of the last benchmark (see BenchmarkSuite::ToJson)
+    QJsonObject benchmark_report;
 };
 //! [0]
 
@@ -9,14 +9,20 @@ This script:
   5. Triggers the plugin's "BenchmarkInfo" command for a given program.
   6. Prints the resulting benchmark report, which RoboDK streams to its own console/stdout
      (Robolink automatically relays it to this script's stdout).
+  7. Retrieves the machine readable report ("BenchmarkJson" command), optionally saves it and
+     compares it with a baseline report saved by a previous run.
 
 Usage:
-    python run_plugin_benchmark.py
+    python run_plugin_benchmark.py [--json results.json] [--baseline baseline.json] [--threshold 0.1]
+
+The script exits with an error if any operation is slower than the baseline (see compare_reports).
 """
 
 import os
 import sys
+import json
 import time
+import argparse
 import tempfile
 import urllib.request
 
@@ -74,6 +80,36 @@ def download_station(url: str) -> str:
     print("Saved to: %s" % filepath)
     return filepath
 
+def compare_reports(current, baseline, threshold):
+    """Compare two JSON reports. Returns the list of operations slower than the baseline.
+
+    Same rule as BenchmarkSuite::Compare: an operation regresses if its median (p50) is slower than the
+    baseline by more than the threshold, raised to the coefficient of variation of noisy measurements.
+    """
+    baseline_results = {result["name"]: result for result in baseline.get("results", [])}
+    regressions = []
+    for result in current.get("results", []):
+        base = baseline_results.get(result["name"])
+        if base is None or base["p50_us"] <= 0:
+            continue
+
+        change = result["p50_us"] / base["p50_us"] - 1.0
+        limit = max(threshold, result.get("cv", 0.0), base.get("cv", 0.0))
+        line = "%-40s p50 %10.3f us -> %10.3f us (%+.1f%%)" % (result["name"], base["p50_us"], result["p50_us"], 100.0 * change)
+        if change > limit:
+            line += " REGRESSION (limit +%.1f%%)" % (100.0 * limit)
+            regressions.append(result["name"])
+        print(line)
+    return regressions
+
+
+def print_results(report):
+    """Print the statistics of each operation of a JSON report (microseconds per call)."""
+    print("%-40s %10s %10s %10s %10s %10s %7s" % ("Operation", "mean", "p50", "p95", "p99", "max", "CV"))
+    for result in report.get("results", []):
+        print("%-40s %10.3f %10.3f %10.3f %10.3f %10.3f %6.1f%%" % (result["name"], result["mean_us"], result["p50_us"], result["p95_us"], result["p99_us"], result["max_us"], 100.0 * result["cv"]))
+
+
 def print_custom(txt):
     global do_print_stdout
     if do_print_stdout:
@@ -83,6 +119,17 @@ def main():
     global do_print_stdout
     do_print_stdout = False
 
+    parser = argparse.ArgumentParser(description="Run the PluginExample benchmark in a headless RoboDK instance")
+    parser.add_argument("--json", help="Save the JSON report to this file")
+    parser.add_argument("--baseline", help="Compare the results with a JSON report saved by a previous run")
+    parser.add_argument("--threshold", type=float, default=0.10, help="Relative slowdown of the median flagged as a regression (default: 0.10)")
+    args = parser.parse_args()
+
+    baseline = None
+    if args.baseline:
+        with open(args.baseline, "r") as f:
+            baseline = json.load(f)
+
     station_path = download_station(STATION_URL)
 
     # Start a new, headless RoboDK instance.
@@ -117,9 +164,24 @@ def main():
     time.sleep(1)
     do_print_stdout = False
 
+    report = json.loads(RDK.PluginCommand(PLUGIN_ID, "BenchmarkJson"))
+    print_results(report)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(report, f, indent=2)
+        print("Saved JSON report to: %s" % args.json)
+
     print("Closing RoboDK...")
     RDK.CloseRoboDK()
 
+    if baseline is not None:
+        print("=" * 70)
+        print("Comparing with baseline: %s" % args.baseline)
+        regressions = compare_reports(report, baseline, args.threshold)
+        if regressions:
+            sys.exit("%d regressions: %s" % (len(regressions), ", ".join(regressions)))
+        print("No regressions")
+
 
 if __name__ == "__main__":
     main()
@@ -3,6 +3,22 @@
 #include <QAction>
 #include <QStatusBar>
 #include <QMenuBar>
+#include <QElapsedTimer>
+
+#include <cmath>
+
+
+/// Index of the first external axis (the rail) of a synchronized robot
+static const int RAIL_AXIS_ID = 6;
+
+/// Initial search step of the rail optimizer (mm or deg)
+static const double RAIL_STEP_INITIAL = 100.0;
+
+/// The rail optimizer stops once the search step is smaller than this value (mm or deg)
+static const double RAIL_STEP_MIN = 0.1;
+
+/// Interval between two iterations of the rail optimizer (ms)
+static const int RAIL_OPTIMIZE_INTERVAL_MS = 20;
 
 
 //------------------------------- RoboDK Plug-in commands ------------------------------
@@ -30,8 +46,15 @@ QString PluginLockTCP::PluginLoad(QMainWindow *mw, QMenuBar *menubar, QStatusBar
     action_lock = new QAction(tr("Lock TCP"));
     action_lock->setCheckable(true);
 
+    action_optimize = new QAction(tr("Optimize Rail Position"));
+    action_optimize->setCheckable(true);
+
     // Make sure to connect the action to your callback (slot)
     connect(action_lock, SIGNAL(triggered(bool)), this, SLOT(callback_tcp_lock(bool)));
+    connect(action_optimize, SIGNAL(triggered(bool)), this, SLOT(callback_rail_optimize(bool)));
+
+    timer_optimize.setInterval(RAIL_OPTIMIZE_INTERVAL_MS);
+    connect(&timer_optimize, SIGNAL(timeout()), this, SLOT(callback_rail_optimize_step()));
 
     // return string is reserverd for future compatibility
     return "";
@@ -39,6 +62,9 @@ QString PluginLockTCP::PluginLoad(QMainWindow *mw, QMenuBar *menubar, QStatusBar
 
 
 void PluginLockTCP::PluginUnload(){
+    timer_optimize.stop();
+    disconnect(&timer_optimize, SIGNAL(timeout()), this, SLOT(callback_rail_optimize_step()));
+
     last_clicked_item = nullptr;
     locked_items.clear();
 
@@ -48,6 +74,13 @@ void PluginLockTCP::PluginUnload(){
         delete action_lock;
         action_lock = nullptr;
     }
+
+    if (nullptr != action_optimize)
+    {
+        disconnect(action_optimize, SIGNAL(triggered(bool)), this, SLOT(callback_rail_optimize(bool)));
+        delete action_optimize;
+        action_optimize = nullptr;
+    }
 }
 
 
@@ -59,9 +92,11 @@ bool PluginLockTCP::PluginItemClick(Item item, QMenu *menu, TypeClick click_type
     if (process_item(item)){
         // Find the current state of this item
         bool locked = false;
+        bool optimized = false;
         for (const auto& locked_item : locked_items){
             if (locked_item.robot == last_clicked_item){
                 locked = locked_item.locked;
+                optimized = locked_item.locked && locked_item.optimizer.active;
                 break;
             }
         }
@@ -73,6 +108,11 @@ bool PluginLockTCP::PluginItemClick(Item item, QMenu *menu, TypeClick click_type
         action_lock->blockSignals(false);
         menu->addAction(action_lock);
 
+        action_optimize->blockSignals(true);
+        action_optimize->setChecked(optimized);
+        action_optimize->blockSignals(false);
+        menu->addAction(action_optimize);
+
         return false;
     }
 
@@ -80,6 +120,35 @@ bool PluginLockTCP::PluginItemClick(Item item, QMenu *menu, TypeClick click_type
 }
 
 QString PluginLockTCP::PluginCommand(const QString &command, const QString &item_name){
+    // Rail optimizer settings (the value is not an item name)
+    if (command.compare("OptimizeBudget", Qt::CaseInsensitive) == 0){
+        bool ok = false;
+        double budget_ms = item_name.toDouble(&ok);
+        if (!ok || budget_ms <= 0.0){
+            return "INVALID VALUE";
+        }
+        optimize_budget_ms = budget_ms;
+        return "OK";
+    } else if (command.compare("OptimizeCost", Qt::CaseInsensitive) == 0){
+        if (item_name.compare("Limits", Qt::CaseInsensitive) == 0){
+            optimize_cost = RailCostJointLimits;
+        } else if (item_name.compare("Wrist", Qt::CaseInsensitive) == 0){
+            optimize_cost = RailCostWristSingularity;
+        } else if (item_name.compare("Combined", Qt::CaseInsensitive) == 0){
+            optimize_cost = RailCostCombined;
+        } else {
+            return "INVALID VALUE";
+        }
+
+        // Start again with the new cost function
+        for (auto& locked_item : locked_items){
+            if (locked_item.locked && locked_item.optimizer.active){
+                reset_rail_optimizer(&locked_item);
+            }
+        }
+        return "OK";
+    }
+
     Item item = RDK->getItem(item_name);
     if (item == nullptr){
         qDebug() << "Item not found";
@@ -91,6 +160,22 @@ QString PluginLockTCP::PluginCommand(const QString &command, const QString &item
          return "ITEM INVALID";
      }
 
+    if (command.compare("Optimize", Qt::CaseInsensitive) == 0){
+        callback_rail_optimize(true);
+        qDebug() << "Optimizing rail position of " << item->Name();
+        return "OK";
+    } else if (command.compare("OptimizeStatus", Qt::CaseInsensitive) == 0){
+        for (const auto& locked_item : locked_items){
+            if (locked_item.robot == last_clicked_item){
+                const rail_optimizer_t &optimizer = locked_item.optimizer;
+                return QString("active=%1 converged=%2 cost=%3 step=%4 solves=%5")
+                        .arg(locked_item.locked && optimizer.active).arg(optimizer.converged)
+                        .arg(optimizer.cost).arg(optimizer.step).arg(optimizer.ik_solves);
+            }
+        }
+        return "NOT LOCKED";
+    }
+
     callback_tcp_lock(command.compare("Lock", Qt::CaseInsensitive) == 0);
     qDebug() << "Locked/Unlocked " << item->Name();
     return "OK";
@@ -99,6 +184,11 @@ QString PluginLockTCP::PluginCommand(const QString &command, const QString &item
 void PluginLockTCP::PluginEvent(TypeEvent event_type){
     switch (event_type){
     case EventChanged:{
+        // The tree may have changed: resolve the rail chains again on the next move
+        for (auto& locked_item : locked_items){
+            locked_item.chain.valid = false;
+        }
+
         // Check if any locked TCPs were removed
         for (auto it = locked_items.begin(); it != locked_items.end(); it++){
             locked_item_t l_item = *it;
@@ -113,6 +203,7 @@ void PluginLockTCP::PluginEvent(TypeEvent event_type){
     }
     case EventAbout2ChangeStation:
     case EventAbout2CloseStation:
+        timer_optimize.stop();
         last_clicked_item = nullptr;
         locked_items.clear();
         break;
@@ -176,9 +267,19 @@ void PluginLockTCP::update_tcp_pose(){
     for (auto& locked_item : locked_items){
         if (locked_item.locked){
             // There is not guarrantee that the robot parent is the rail.. find it!
-            Mat pose = retrieve_pose_to_rail(locked_item.robot);
+            if (!locked_item.chain.valid){
+                build_rail_chain(locked_item.robot, &locked_item.chain);
+            }
+            Mat pose = rail_chain_pose(locked_item.chain);
             Mat robot_pose = pose.inv() * locked_item.pose;
-            tJoints jnew = locked_item.robot->SolveIK(robot_pose);
+
+            // Seed the solver with the last accepted robot axes to stay in the same configuration.
+            // The solver keeps the external axes of the seed, so they must be the current ones (the rail may have moved).
+            tJoints jseed = locked_item.robot->Joints();
+            for (int i = 0; i < RAIL_AXIS_ID && i < jseed.Length() && i < locked_item.last_jnts.Length(); ++i){
+                jseed.Data()[i] = locked_item.last_jnts.Values()[i];
+            }
+            tJoints jnew = locked_item.robot->SolveIK(robot_pose, &jseed);
 
             // Out of reach, fully extended
             if (jnew.Length() == 0){
@@ -194,14 +295,12 @@ void PluginLockTCP::update_tcp_pose(){
                 continue;
             }
 
-            // Joints config changed
+            // Joints config changed (the configuration of the last joints is cached)
             tConfig new_config;
             locked_item.robot->JointsConfig(jnew, new_config);
-            tConfig prev_config;
-            locked_item.robot->JointsConfig(locked_item.last_jnts, prev_config);
             bool joints_changed = false;
             for (int i = 0; i < RDK_SIZE_MAX_CONFIG; ++i){
-                if (static_cast<short>(new_config[i]) !=  static_cast<short>(prev_config[i])){
+                if (static_cast<short>(new_config[i]) !=  static_cast<short>(locked_item.last_config[i])){
                     joints_changed = true;
                     break;
                 }
@@ -217,8 +316,13 @@ void PluginLockTCP::update_tcp_pose(){
             // New valid pose
             locked_item.robot->setJoints(jnew);
             locked_item.robot->setPoseAbs(locked_item.pose);
-            locked_item.last_jnts = locked_item.robot->Joints();
+            set_last_joints(&locked_item, locked_item.robot->Joints(), new_config);
             renderUpdate = true;
+
+            // The rail was moved by the user: look for a better position again
+            if (locked_item.optimizer.active){
+                reset_rail_optimizer(&locked_item);
+            }
         }
     }
 
@@ -235,32 +339,256 @@ void PluginLockTCP::callback_tcp_lock(bool lock){
     for (auto& locked_item : locked_items){
         if (locked_item.robot == last_clicked_item){
             // There is not guarrantee that the robot parent is the rail.. find it!
-            Mat pose = retrieve_pose_to_rail(locked_item.robot);
+            build_rail_chain(locked_item.robot, &locked_item.chain);
+            Mat pose = rail_chain_pose(locked_item.chain);
             locked_item.pose = pose * locked_item.robot->SolveFK(locked_item.robot->Joints());
-            locked_item.last_jnts = locked_item.robot->Joints();
+            set_last_joints(&locked_item, locked_item.robot->Joints());
             locked_item.locked = lock;
+
+            if (!lock){
+                locked_item.optimizer.active = false;
+            } else if (locked_item.optimizer.active){
+                reset_rail_optimizer(&locked_item);
+            }
+        }
+    }
+}
+
+void PluginLockTCP::callback_rail_optimize(bool optimize){
+    if (last_clicked_item == nullptr){
+        return;
+    }
+
+    for (auto& locked_item : locked_items){
+        if (locked_item.robot == last_clicked_item){
+            if (!optimize){
+                locked_item.optimizer.active = false;
+                break;
+            }
+
+            // The rail can only be optimized while the TCP is locked
+            if (!locked_item.locked){
+                callback_tcp_lock(true);
+            }
+            locked_item.optimizer.active = true;
+            reset_rail_optimizer(&locked_item);
+            break;
+        }
+    }
+}
+
+void PluginLockTCP::callback_rail_optimize_step(){
+    QElapsedTimer timer;
+    timer.start();
+
+    const qint64 budget_ns = static_cast<qint64>(optimize_budget_ms * 1e6);
+    bool pending = false;
+    bool renderUpdate = false;
+    for (auto& locked_item : locked_items){
+        if (!locked_item.locked || !locked_item.optimizer.active || locked_item.optimizer.converged){
+            continue;
+        }
+
+        // All the rail optimizers share the time budget of the frame
+        qint64 remaining_ns = budget_ns - timer.nsecsElapsed();
+        if (remaining_ns <= 0){
+            pending = true;
+            break;
+        }
+
+        if (optimize_rail(&locked_item, remaining_ns)){
+            renderUpdate = true;
+        }
+        if (!locked_item.optimizer.converged){
+            pending = true;
         }
     }
+
+    if (!pending){
+        timer_optimize.stop();
+    }
+
+    if (renderUpdate){
+        RDK->Render(RoboDK::RenderUpdateOnly);
+    }
+}
+
+void PluginLockTCP::reset_rail_optimizer(locked_item_t *locked_item){
+    rail_optimizer_t &optimizer = locked_item->optimizer;
+    locked_item->robot->JointLimits(&optimizer.lower_limits, &optimizer.upper_limits);
+    optimizer.converged = false;
+    optimizer.step = RAIL_STEP_INITIAL;
+    optimizer.cost = rail_cost(optimizer, locked_item->last_jnts);
+
+    if (!timer_optimize.isActive()){
+        timer_optimize.start();
+    }
+}
+
+bool PluginLockTCP::optimize_rail(locked_item_t *locked_item, qint64 budget_ns){
+    QElapsedTimer timer;
+    timer.start();
+
+    rail_optimizer_t &optimizer = locked_item->optimizer;
+    Item robot = locked_item->robot;
+    if (locked_item->last_jnts.Length() <= RAIL_AXIS_ID || optimizer.lower_limits.Length() <= RAIL_AXIS_ID){
+        qDebug() << robot->Name() << " has no external axis to optimize";
+        optimizer.converged = true;
+        return false;
+    }
+
+    if (!locked_item->chain.valid){
+        build_rail_chain(robot, &locked_item->chain);
+    }
+    Mat robot_pose = rail_chain_pose(locked_item->chain).inv() * locked_item->pose;
+
+    const double rail_min = optimizer.lower_limits.Values()[RAIL_AXIS_ID];
+    const double rail_max = optimizer.upper_limits.Values()[RAIL_AXIS_ID];
+
+    tJoints jbest = locked_item->last_jnts;
+    tConfig config_best;
+    bool moved = false;
+
+    // Local search over the rail axis: try one step on each side of the current position,
+    // keep the best candidate and halve the step when no candidate improves the cost.
+    while (optimizer.step >= RAIL_STEP_MIN && timer.nsecsElapsed() < budget_ns){
+        bool improved = false;
+        tJoints jround = jbest;
+        for (double direction : {1.0, -1.0}){
+            double rail = jround.Values()[RAIL_AXIS_ID] + direction * optimizer.step;
+            if (rail < rail_min || rail > rail_max){
+                continue;
+            }
+
+            // Warm start from the best solution so far: the synchronized external axes of joints_close are kept by the solver
+            tJoints jseed = jround;
+            jseed.Data()[RAIL_AXIS_ID] = rail;
+            tJoints jcandidate = robot->SolveIK(robot_pose, &jseed);
+            optimizer.ik_solves++;
+
+            // Out of reach, or the solver did not keep the requested rail position
+            if (jcandidate.Length() <= RAIL_AXIS_ID || qAbs(jcandidate.Values()[RAIL_AXIS_ID] - rail) > 1e-6){
+                continue;
+            }
+
+            if (!robot->JointsValid(jcandidate)){
+                continue;
+            }
+
+            // Never cross a singularity to reach a better rail position
+            tConfig config;
+            robot->JointsConfig(jcandidate, config);
+            bool config_changed = false;
+            for (int i = 0; i < RDK_SIZE_MAX_CONFIG; ++i){
+                if (static_cast<short>(config[i]) != static_cast<short>(locked_item->last_config[i])){
+                    config_changed = true;
+                    break;
+                }
+            }
+            if (config_changed){
+                continue;
+            }
+
+            double cost = rail_cost(optimizer, jcandidate);
+            if (cost < optimizer.cost - 1e-9){
+                optimizer.cost = cost;
+                jbest = jcandidate;
+                for (int i = 0; i < RDK_SIZE_MAX_CONFIG; ++i){
+                    config_best[i] = config[i];
+                }
+                improved = true;
+            }
+        }
+
+        if (improved){
+            moved = true;
+        } else {
+            optimizer.step *= 0.5;
+        }
+    }
+
+    if (optimizer.step < RAIL_STEP_MIN){
+        optimizer.converged = true;
+        qDebug() << robot->Name() << " rail position optimized. Cost: " << optimizer.cost << ". IK solves: " << optimizer.ik_solves;
+    }
+
+    if (!moved){
+        return false;
+    }
+
+    // Apply the best solution of this frame only once
+    robot->setJoints(jbest);
+    set_last_joints(locked_item, jbest, config_best);
+    return true;
+}
+
+double PluginLockTCP::rail_cost(const rail_optimizer_t &optimizer, const tJoints &jnts) const{
+    const int n_arm = qMin(qMin(jnts.Length(), RAIL_AXIS_ID), qMin(optimizer.lower_limits.Length(), optimizer.upper_limits.Length()));
+    double cost = 0.0;
+
+    if (optimize_cost != RailCostWristSingularity){
+        // Squared distance of each axis to the center of its range, normalized to [0, 1]
+        for (int i = 0; i < n_arm; ++i){
+            double lower = optimizer.lower_limits.Values()[i];
+            double upper = optimizer.upper_limits.Values()[i];
+            double range = upper - lower;
+            if (range <= 0.0){
+                continue;
+            }
+            double d = (2.0 * jnts.Values()[i] - lower - upper) / range;
+            cost += d * d;
+        }
+    }
+
+    if (optimize_cost != RailCostJointLimits && n_arm >= 5){
+        // Grows quickly as axis 5 gets close to 0 deg (wrist singularity)
+        double s = std::sin(jnts.Values()[4] * M_PI / 180.0);
+        cost += 0.1 / (s * s + 1e-3);
+    }
+
+    return cost;
+}
+
+void PluginLockTCP::set_last_joints(locked_item_t *locked_item, const tJoints &jnts, const tConfig config){
+    locked_item->last_jnts = jnts;
+    if (config != nullptr){
+        for (int i = 0; i < RDK_SIZE_MAX_CONFIG; ++i){
+            locked_item->last_config[i] = config[i];
+        }
+    } else {
+        locked_item->robot->JointsConfig(jnts, locked_item->last_config);
+    }
 }
 
-Mat PluginLockTCP::retrieve_pose_to_rail(Item item){
+void PluginLockTCP::build_rail_chain(Item item, rail_chain_t *chain){
     IItem* parent = item;
-    Mat pose = Mat();
-    bool found = false;
+    chain->frames.clear();
+    chain->on_rail = false;
     while (parent != nullptr && parent->Type() != IItem::ITEM_TYPE_STATION && parent->Type() != IItem::ITEM_TYPE_ANY) {
         parent = parent->Parent();
         if (parent->Type() == IItem::ITEM_TYPE_ROBOT){
-            found = true;
-            pose *= parent->PoseAbs();
+            chain->on_rail = true;
+            chain->rail = parent;
             break;
         }
-        pose *= parent->Pose();
+        chain->frames.append(parent);
+    }
+
+    if (!chain->on_rail){
+        chain->rail = item->Parent(); // robot not attached to a rail
     }
+    chain->valid = true;
+}
 
-    if (!found){
-        pose = item->Parent()->PoseAbs(); // robot not attached to a rail
+Mat PluginLockTCP::rail_chain_pose(const rail_chain_t &chain){
+    if (!chain.on_rail){
+        return chain.rail->PoseAbs();
     }
 
+    Mat pose;
+    for (Item frame : chain.frames){
+        pose *= frame->Pose();
+    }
+    pose *= chain.rail->PoseAbs();
     return pose;
 }
-
@@ -4,6 +4,8 @@
 
 #include "iapprobodk.h"
 
+#include <QTimer>
+
 class QAction;
 
 ///
@@ -84,6 +86,12 @@ public slots:
     /// Called when the lock tcp button/action is selected
     void callback_tcp_lock(bool lock);
 
+    /// Called when the optimize rail button/action is selected. Optimizing the rail also locks the TCP.
+    void callback_rail_optimize(bool optimize);
+
+    /// Called periodically while a rail position is being optimized
+    void callback_rail_optimize_step();
+
 public:
     /// Process an item. Returns true if it succeeds, else false.
     bool process_item(Item item);
@@ -91,16 +99,63 @@ public:
     /// Update the tcp pose with the locked pose
     void update_tcp_pose();
 
-    /// Retrieve the absolute pose of to the item mounted on a rail. Handle intermediary frames.
-    /// \param item item to start with, usually the robot
-    /// \return The absolute pose
-    Mat retrieve_pose_to_rail(Item item);
+    /// Cost function minimized when the plugin chooses the rail position
+    enum RailCost {
+        /// Keep the robot axes away from their joint limits
+        RailCostJointLimits = 0,
+
+        /// Keep the robot away from the wrist singularity (axis 5 close to 0)
+        RailCostWristSingularity,
+
+        /// Combination of both costs
+        RailCostCombined
+    };
 
 private:
 
+    /// Resolved chain of items between a robot and its rail (or its parent if it is not mounted on a rail)
+    struct rail_chain_t
+    {
+        bool valid { false }; // False if the chain must be resolved again (station tree changed)
+        bool on_rail { false }; // True if a rail (robot) was found in the parents
+        Item rail { nullptr }; // Rail robot, or direct parent of the robot if it is not mounted on a rail
+        QVector<Item> frames; // Intermediary frames between the robot and the rail (their poses may change with EventMoved)
+    };
+
+    /// Walk the parents of the item and resolve the rail chain
+    void build_rail_chain(Item item, rail_chain_t *chain);
+
+    /// Absolute pose of the rail chain, with the current poses of the intermediary frames
+    Mat rail_chain_pose(const rail_chain_t &chain);
+
+
     /// Lock/unlock action. callback_tcp_lock is triggered with this action.  Actions are required to populate toolbars and menus and allows getting callbacks.
     QAction *action_lock;
 
+    /// Optimize rail action. callback_rail_optimize is triggered with this action.
+    QAction *action_optimize { nullptr };
+
+    /// Timer that runs the rail optimizer while there is a rail position to optimize
+    QTimer timer_optimize;
+
+    /// Time budget given to the rail optimizer on every timer tick (in ms)
+    double optimize_budget_ms { 5.0 };
+
+    /// Cost function used by the rail optimizer
+    RailCost optimize_cost { RailCostCombined };
+
+    /// State of the rail optimizer of a locked item
+    struct rail_optimizer_t
+    {
+        bool active { false }; // True if the plugin chooses the rail position
+        bool converged { false }; // True if no better rail position can be found for the current lock
+        double step { 0.0 }; // Current search step of the rail axis (mm or deg)
+        double cost { 0.0 }; // Cost of the last accepted joints
+        tJoints lower_limits; // Joint limits, retrieved when the optimizer is started
+        tJoints upper_limits;
+        qint64 ik_solves { 0 }; // Number of calls to SolveIK made by the optimizer
+    };
+
     /// Data structure of a locked item
     struct locked_item_t
     {
@@ -108,8 +163,23 @@ private:
         Item robot { nullptr };
         Mat pose; // initial TCP pose when locked
         tJoints last_jnts; // last accepted joints
+        tConfig last_config {}; // configuration of last_jnts
+        rail_chain_t chain; // cached chain to the rail, rebuilt on EventChanged
+        rail_optimizer_t optimizer; // rail optimizer state
     };
 
+    /// Restart the rail optimizer of a locked item (the lock or the limits changed)
+    void reset_rail_optimizer(locked_item_t *locked_item);
+
+    /// Run the rail optimizer of a locked item for a limited amount of time. Returns true if the robot moved.
+    bool optimize_rail(locked_item_t *locked_item, qint64 budget_ns);
+
+    /// Cost of a joint solution for the rail optimizer (lower is better)
+    double rail_cost(const rail_optimizer_t &optimizer, const tJoints &jnts) const;
+
+    /// Store the accepted joints and their configuration
+    void set_last_joints(locked_item_t *locked_item, const tJoints &jnts, const tConfig config = nullptr);
+
     /// Vector of all available locked items
     QVector<locked_item_t> locked_items;
 
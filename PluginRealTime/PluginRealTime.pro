@@ -91,11 +91,20 @@ CONFIG(release, debug|release) {
 # This can be modified manually or automatically by Qt Creator
 HEADERS += \
     pluginexample.h \
-    formrobotpilot.h
+    formrobotpilot.h \
+    realtimescheduler.h \
+    jointframering.h \
+    jointstreamudp.h \
+    jointlog.h \
+    stageprofiler.h
 
 SOURCES += \
     pluginexample.cpp \
-    formrobotpilot.cpp
+    formrobotpilot.cpp \
+    realtimescheduler.cpp \
+    jointstreamudp.cpp \
+    jointlog.cpp \
+    stageprofiler.cpp
 
 FORMS += \
     formrobotpilot.ui
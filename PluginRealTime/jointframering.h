@@ -0,0 +1,95 @@
+#ifndef JOINTFRAMERING_H
+#define JOINTFRAMERING_H
+
+#include <QtGlobal>
+
+#include <atomic>
+#include <cstddef>
+
+#include "robodktypes.h"
+
+
+///
+/// \brief Joint setpoint of one robot. The size is fixed so frames can be copied without allocating memory.
+///
+struct JointFrame
+{
+    /// Index of the robot (position in the list of robots of the station)
+    int robot_index;
+
+    /// Number of joint values
+    int ndofs;
+
+    /// Sequence number assigned by the producer
+    quint32 sequence;
+
+    /// Time when the frame was produced (steady clock, in nanoseconds)
+    qint64 timestamp_ns;
+
+    /// Joint values (deg or mm)
+    double joints[RDK_SIZE_JOINTS_MAX];
+};
+
+
+///
+/// \brief Lock-free single-producer/single-consumer ring buffer with a fixed capacity.
+/// Push must only be called from one thread (the producer) and Pop from another one (the consumer).
+/// No memory is allocated after construction.
+/// \tparam T trivially copyable element type
+/// \tparam Capacity number of elements, must be a power of 2
+///
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "The capacity of the ring must be a power of 2");
+
+public:
+    SpscRing() : head(0), tail(0) {}
+
+    /// Add an element (producer thread). Returns false if the ring is full: the element is dropped.
+    bool Push(const T &item){
+        const size_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= Capacity){
+            return false;
+        }
+        buffer[h & (Capacity - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Retrieve the oldest element (consumer thread). Returns false if the ring is empty.
+    bool Pop(T *item){
+        const size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)){
+            return false;
+        }
+        *item = buffer[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Number of elements in the ring (approximate if called while the other thread is working)
+    size_t Size() const{
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    /// Maximum number of elements
+    static size_t MaxSize(){
+        return Capacity;
+    }
+
+private:
+    // Producer and consumer indexes live on different cache lines to avoid false sharing
+    std::atomic<size_t> head;
+    char padding_head[64 - sizeof(std::atomic<size_t>)];
+    std::atomic<size_t> tail;
+    char padding_tail[64 - sizeof(std::atomic<size_t>)];
+    T buffer[Capacity];
+};
+
+
+/// Ring of joint frames between a producer thread and the GUI thread
+typedef SpscRing<JointFrame, 1024> JointFrameRing;
+
+
+#endif // JOINTFRAMERING_H
@@ -0,0 +1,301 @@
+#include "jointlog.h"
+
+#include <QtEndian>
+#include <QDebug>
+
+#include <cmath>
+#include <cstring>
+
+
+/// Size of the fixed part of the header
+static const int JOINT_LOG_HEADER_SIZE = 24;
+
+/// Offset of the number of records in the header
+static const int JOINT_LOG_RECORDS_OFFSET = 16;
+
+/// The memory map of the recorder grows by this amount of bytes
+static const qint64 JOINT_LOG_CHUNK_SIZE = 4 * 1024 * 1024;
+
+
+//------------------------------- Variable length integers ------------------------------
+
+static inline int write_varint(uchar *out, quint64 value){
+    int n = 0;
+    while (value >= 0x80){
+        out[n++] = static_cast<uchar>(value | 0x80);
+        value >>= 7;
+    }
+    out[n++] = static_cast<uchar>(value);
+    return n;
+}
+
+static inline bool read_varint(const uchar *in, qint64 size, qint64 *position, quint64 *value){
+    quint64 result = 0;
+    int shift = 0;
+    while (*position < size && shift < 64){
+        uchar byte = in[(*position)++];
+        result |= static_cast<quint64>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0){
+            *value = result;
+            return true;
+        }
+        shift += 7;
+    }
+    return false;
+}
+
+static inline quint64 zigzag_encode(qint64 value){
+    return (static_cast<quint64>(value) << 1) ^ static_cast<quint64>(value >> 63);
+}
+
+static inline qint64 zigzag_decode(quint64 value){
+    return static_cast<qint64>(value >> 1) ^ -static_cast<qint64>(value & 1);
+}
+
+
+//------------------------------- Recorder ------------------------------
+
+JointRecorder::JointRecorder(){
+}
+
+JointRecorder::~JointRecorder(){
+    Close();
+}
+
+bool JointRecorder::Open(const QString &filename, const QVector<int> &robot_ndofs, double log_resolution){
+    Close();
+    if (robot_ndofs.isEmpty() || robot_ndofs.size() > 0xFFFF || log_resolution <= 0.0){
+        return false;
+    }
+
+    file.setFileName(filename);
+    if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate)){
+        qDebug() << "Unable to create joint log" << filename << ":" << file.errorString();
+        return false;
+    }
+    opened = true;
+
+    resolution = log_resolution;
+    int njoints = 0;
+    for (int n : robot_ndofs){
+        njoints += n;
+    }
+    last_units.fill(0, njoints);
+    last_time_us = 0;
+    records = 0;
+    position = 0;
+
+    if (!reserve(JOINT_LOG_HEADER_SIZE + robot_ndofs.size())){
+        Close();
+        return false;
+    }
+
+    quint64 resolution_bits;
+    std::memcpy(&resolution_bits, &resolution, sizeof(resolution_bits));
+    qToLittleEndian<quint32>(JOINT_LOG_MAGIC, map);
+    qToLittleEndian<quint16>(JOINT_LOG_VERSION, map + 4);
+    qToLittleEndian<quint16>(static_cast<quint16>(robot_ndofs.size()), map + 6);
+    qToLittleEndian<quint64>(resolution_bits, map + 8);
+    qToLittleEndian<quint64>(0, map + JOINT_LOG_RECORDS_OFFSET);
+    position = JOINT_LOG_HEADER_SIZE;
+    for (int n : robot_ndofs){
+        map[position++] = static_cast<uchar>(n);
+    }
+    return true;
+}
+
+bool JointRecorder::Record(qint64 time_us, const double *joints){
+    // The map is released if the file could not grow: the log stays open until Close() finalizes it
+    if (!opened || map == nullptr){
+        return false;
+    }
+
+    // Worst case: 10 bytes per value
+    const int njoints = last_units.size();
+    if (!reserve(10 * (njoints + 1))){
+        return false;
+    }
+
+    position += write_varint(map + position, static_cast<quint64>(qMax<qint64>(0, time_us - last_time_us)));
+    last_time_us = qMax(last_time_us, time_us);
+
+    qint64 *last = last_units.data();
+    for (int i = 0; i < njoints; i++){
+        qint64 units = std::llround(joints[i] / resolution);
+        position += write_varint(map + position, zigzag_encode(units - last[i]));
+        last[i] = units;
+    }
+    records++;
+
+    // Keep the number of records of the header up to date: the log can be replayed even if the process stops without closing it
+    qToLittleEndian<quint64>(records, map + JOINT_LOG_RECORDS_OFFSET);
+    return true;
+}
+
+void JointRecorder::Close(){
+    if (!opened){
+        return;
+    }
+
+    // The number of records of the header is written by Record (also when the file could not grow and is no longer mapped)
+    if (map != nullptr){
+        file.unmap(map);
+        map = nullptr;
+    }
+    file.resize(position);
+    file.close();
+    map_size = 0;
+    opened = false;
+}
+
+bool JointRecorder::IsOpen() const{
+    return opened;
+}
+
+int JointRecorder::JointCount() const{
+    return last_units.size();
+}
+
+quint64 JointRecorder::Records() const{
+    return records;
+}
+
+qint64 JointRecorder::Bytes() const{
+    return position;
+}
+
+bool JointRecorder::reserve(qint64 size){
+    if (map != nullptr && position + size <= map_size){
+        return true;
+    }
+
+    // Grow the file by one chunk and map it again
+    if (map != nullptr){
+        file.unmap(map);
+        map = nullptr;
+    }
+    map_size = qMax(map_size + JOINT_LOG_CHUNK_SIZE, position + size);
+    if (!file.resize(map_size)){
+        qDebug() << "Unable to grow joint log:" << file.errorString();
+        return false;
+    }
+    map = file.map(0, map_size);
+    if (map == nullptr){
+        qDebug() << "Unable to map joint log:" << file.errorString();
+        return false;
+    }
+    return true;
+}
+
+
+//------------------------------- Replayer ------------------------------
+
+JointReplayer::JointReplayer(){
+}
+
+JointReplayer::~JointReplayer(){
+    Close();
+}
+
+bool JointReplayer::Open(const QString &filename){
+    Close();
+    file.setFileName(filename);
+    if (!file.open(QIODevice::ReadOnly)){
+        qDebug() << "Unable to open joint log" << filename << ":" << file.errorString();
+        return false;
+    }
+
+    map_size = file.size();
+    if (map_size < JOINT_LOG_HEADER_SIZE){
+        Close();
+        return false;
+    }
+    map = file.map(0, map_size);
+    if (map == nullptr || qFromLittleEndian<quint32>(map) != JOINT_LOG_MAGIC || qFromLittleEndian<quint16>(map + 4) != JOINT_LOG_VERSION){
+        qDebug() << "Not a valid joint log:" << filename;
+        Close();
+        return false;
+    }
+
+    int nrobots = qFromLittleEndian<quint16>(map + 6);
+    quint64 resolution_bits = qFromLittleEndian<quint64>(map + 8);
+    std::memcpy(&resolution, &resolution_bits, sizeof(resolution));
+    records = qFromLittleEndian<quint64>(map + JOINT_LOG_RECORDS_OFFSET);
+    if (JOINT_LOG_HEADER_SIZE + nrobots > map_size){
+        Close();
+        return false;
+    }
+
+    ndofs.resize(nrobots);
+    int njoints = 0;
+    for (int i = 0; i < nrobots; i++){
+        ndofs[i] = map[JOINT_LOG_HEADER_SIZE + i];
+        njoints += ndofs[i];
+    }
+    last_units.resize(njoints);
+    data_start = JOINT_LOG_HEADER_SIZE + nrobots;
+    Rewind();
+    return true;
+}
+
+void JointReplayer::Close(){
+    if (map != nullptr){
+        file.unmap(const_cast<uchar*>(map));
+        map = nullptr;
+    }
+    if (file.isOpen()){
+        file.close();
+    }
+    map_size = 0;
+    ndofs.clear();
+    last_units.clear();
+    records = 0;
+}
+
+bool JointReplayer::IsOpen() const{
+    return map != nullptr;
+}
+
+const QVector<int> &JointReplayer::Dofs() const{
+    return ndofs;
+}
+
+int JointReplayer::JointCount() const{
+    return last_units.size();
+}
+
+quint64 JointReplayer::Records() const{
+    return records;
+}
+
+void JointReplayer::Rewind(){
+    position = data_start;
+    decoded = 0;
+    last_time_us = 0;
+    last_units.fill(0);
+}
+
+bool JointReplayer::Next(qint64 *time_us, double *joints){
+    // Stop at the number of records of the header: the end of the file may be padding
+    if (map == nullptr || decoded >= records || position >= map_size){
+        return false;
+    }
+
+    quint64 value;
+    if (!read_varint(map, map_size, &position, &value)){
+        return false;
+    }
+    last_time_us += static_cast<qint64>(value);
+    *time_us = last_time_us;
+
+    qint64 *last = last_units.data();
+    for (int i = 0; i < last_units.size(); i++){
+        if (!read_varint(map, map_size, &position, &value)){
+            return false;
+        }
+        last[i] += zigzag_decode(value);
+        joints[i] = last[i] * resolution;
+    }
+    decoded++;
+    return true;
+}
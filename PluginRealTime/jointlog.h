@@ -0,0 +1,140 @@
+#ifndef JOINTLOG_H
+#define JOINTLOG_H
+
+#include <QFile>
+#include <QString>
+#include <QVector>
+
+
+///
+/// Joint log format (little endian):
+///   uint32 magic (JOINT_LOG_MAGIC)
+///   uint16 version (JOINT_LOG_VERSION)
+///   uint16 number of robots (R)
+///   double resolution: value of one unit of the encoded joints (deg or mm)
+///   uint64 number of records (updated after each record)
+///   uint8  number of joints of each robot [R]
+/// Followed by one record per cycle:
+///   varint time since the previous record (us)
+///   for each robot and each joint: zigzag varint of the difference with the previous record (in units of the resolution)
+///
+#define JOINT_LOG_MAGIC 0x4C4B4452 // "RDKL"
+#define JOINT_LOG_VERSION 1
+
+
+///
+/// \brief The JointRecorder class writes the joints of several robots to a compact binary log, one record per cycle.
+/// Joints are quantized and delta encoded with variable length integers, which usually takes 1 or 2 bytes per joint.
+/// The file is written through a memory map that grows by chunks: recording a cycle never blocks on a write call.
+///
+class JointRecorder
+{
+public:
+    JointRecorder();
+    ~JointRecorder();
+
+    ///
+    /// \brief Create a new log
+    /// \param filename file to create (overwritten if it exists)
+    /// \param ndofs number of joints of each robot
+    /// \param resolution quantization step of the joints (deg or mm)
+    /// \return false if the file could not be created
+    ///
+    bool Open(const QString &filename, const QVector<int> &ndofs, double resolution = 1e-4);
+
+    ///
+    /// \brief Add a record
+    /// \param time_us time of the record (us). Must not decrease.
+    /// \param joints joints of all the robots, one after the other (see \ref JointCount)
+    /// \return false if the log is not open or the file could not grow
+    ///
+    bool Record(qint64 time_us, const double *joints);
+
+    /// Truncate the file to its actual size and close it
+    void Close();
+
+    /// Returns true if a log is open (until Close() is called, even if recording failed)
+    bool IsOpen() const;
+
+    /// Total number of joints of a record
+    int JointCount() const;
+
+    /// Number of records written
+    quint64 Records() const;
+
+    /// Size of the log, in bytes
+    qint64 Bytes() const;
+
+private:
+    /// Make sure there are at least \a size bytes available in the memory map
+    bool reserve(qint64 size);
+
+private:
+    QFile file;
+    bool opened { false };
+    uchar *map { nullptr };
+    qint64 map_size { 0 };
+    qint64 position { 0 };
+
+    double resolution { 1e-4 };
+    QVector<qint64> last_units;
+    qint64 last_time_us { 0 };
+    quint64 records { 0 };
+};
+
+
+///
+/// \brief The JointReplayer class reads a log written by \ref JointRecorder, one record at a time.
+/// The log is memory mapped: no memory is allocated while decoding.
+///
+class JointReplayer
+{
+public:
+    JointReplayer();
+    ~JointReplayer();
+
+    /// Open a log. Returns false if the file can't be read or is not a valid joint log.
+    bool Open(const QString &filename);
+
+    /// Close the log
+    void Close();
+
+    /// Returns true if a log is open
+    bool IsOpen() const;
+
+    /// Number of joints of each robot
+    const QVector<int> &Dofs() const;
+
+    /// Total number of joints of a record
+    int JointCount() const;
+
+    /// Number of records in the log
+    quint64 Records() const;
+
+    /// Go back to the first record
+    void Rewind();
+
+    ///
+    /// \brief Decode the next record
+    /// \param time_us time of the record (us)
+    /// \param joints joints of all the robots, at least \ref JointCount values
+    /// \return false at the end of the log (or if the log is corrupted)
+    ///
+    bool Next(qint64 *time_us, double *joints);
+
+private:
+    QFile file;
+    const uchar *map { nullptr };
+    qint64 map_size { 0 };
+    qint64 data_start { 0 };
+    qint64 position { 0 };
+
+    QVector<int> ndofs;
+    double resolution { 1e-4 };
+    quint64 records { 0 };
+    quint64 decoded { 0 };
+    QVector<qint64> last_units;
+    qint64 last_time_us { 0 };
+};
+
+#endif // JOINTLOG_H
@@ -0,0 +1,244 @@
+#include "jointstreamudp.h"
+
+#include <QUdpSocket>
+#include <QtEndian>
+#include <QDebug>
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+
+//------------------------------- Frame format ------------------------------
+
+int EncodeJointFrame(const JointFrame &frame, char *buffer){
+    if (frame.robot_index < 0 || frame.robot_index > 0xFFFF || frame.ndofs <= 0 || frame.ndofs > RDK_SIZE_JOINTS_MAX){
+        return 0;
+    }
+
+    uchar *out = reinterpret_cast<uchar*>(buffer);
+    qToLittleEndian<quint32>(JOINT_STREAM_MAGIC, out);
+    qToLittleEndian<quint16>(static_cast<quint16>(frame.robot_index), out + 4);
+    qToLittleEndian<quint16>(static_cast<quint16>(frame.ndofs), out + 6);
+    qToLittleEndian<quint32>(frame.sequence, out + 8);
+    qToLittleEndian<qint64>(frame.timestamp_ns, out + 12);
+    for (int i = 0; i < frame.ndofs; i++){
+        quint64 bits;
+        std::memcpy(&bits, &frame.joints[i], sizeof(bits));
+        qToLittleEndian<quint64>(bits, out + JOINT_STREAM_HEADER_SIZE + 8 * i);
+    }
+    return JOINT_STREAM_HEADER_SIZE + 8 * frame.ndofs;
+}
+
+bool DecodeJointFrame(const char *data, int size, JointFrame *frame){
+    if (size < JOINT_STREAM_HEADER_SIZE){
+        return false;
+    }
+
+    const uchar *in = reinterpret_cast<const uchar*>(data);
+    if (qFromLittleEndian<quint32>(in) != JOINT_STREAM_MAGIC){
+        return false;
+    }
+
+    int ndofs = qFromLittleEndian<quint16>(in + 6);
+    if (ndofs <= 0 || ndofs > RDK_SIZE_JOINTS_MAX || size != JOINT_STREAM_HEADER_SIZE + 8 * ndofs){
+        return false;
+    }
+
+    frame->robot_index = qFromLittleEndian<quint16>(in + 4);
+    frame->ndofs = ndofs;
+    frame->sequence = qFromLittleEndian<quint32>(in + 8);
+    frame->timestamp_ns = qFromLittleEndian<qint64>(in + 12);
+    for (int i = 0; i < ndofs; i++){
+        quint64 bits = qFromLittleEndian<quint64>(in + JOINT_STREAM_HEADER_SIZE + 8 * i);
+        std::memcpy(&frame->joints[i], &bits, sizeof(bits));
+    }
+    return true;
+}
+
+qint64 JointStreamClockNs(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void JointStreamTestTrajectory(const QVector<JointFrame> &frames, double rate_hz, const std::atomic<bool> &running, const std::function<void(const JointFrame&)> &on_frame){
+    using clock = std::chrono::steady_clock;
+    const double amplitude_deg = 10.0;
+    const double frequency_hz = 0.2;
+    const std::chrono::nanoseconds period(static_cast<qint64>(1e9 / rate_hz));
+    const clock::time_point t0 = clock::now();
+    clock::time_point deadline = t0;
+    quint32 sequence = 0;
+    while (running.load()){
+        deadline += period;
+        std::this_thread::sleep_until(deadline);
+
+        const double t = std::chrono::duration<double>(clock::now() - t0).count();
+        const double offset = amplitude_deg * std::sin(2.0 * M_PI * frequency_hz * t);
+        sequence++;
+        for (const JointFrame &base : frames){
+            JointFrame frame = base;
+            frame.sequence = sequence;
+            for (int j = 0; j < frame.ndofs; j++){
+                frame.joints[j] += offset;
+            }
+            frame.timestamp_ns = JointStreamClockNs();
+            on_frame(frame);
+        }
+    }
+}
+
+
+//------------------------------- Receiver ------------------------------
+
+JointStreamReceiver::JointStreamReceiver(QObject *parent) : QThread(parent){
+    ResetStatistics();
+}
+
+JointStreamReceiver::~JointStreamReceiver(){
+    Stop();
+}
+
+void JointStreamReceiver::Listen(quint16 listen_port, std::function<bool(const JointFrame&)> frame_callback){
+    Stop();
+    port = listen_port;
+    on_frame = frame_callback;
+    for (int i = 0; i < MaxRobots; i++){
+        sequence_valid[i] = false;
+    }
+    running.store(true);
+    start(QThread::TimeCriticalPriority);
+}
+
+void JointStreamReceiver::Stop(){
+    running.store(false);
+    wait();
+}
+
+void JointStreamReceiver::ResetStatistics(){
+    received.store(0);
+    malformed.store(0);
+    lost.store(0);
+    late.store(0);
+    duplicated.store(0);
+    dropped.store(0);
+    hist_network.Reset();
+}
+
+QString JointStreamReceiver::StatisticsToString() const{
+    QString str = QString("UDP joint stream (port %1, %2): %3 frames received, %4 malformed, %5 lost, %6 late, %7 duplicated, %8 dropped (ring full)\n")
+            .arg(port).arg(isRunning() ? "listening" : "stopped")
+            .arg(received.load()).arg(malformed.load()).arg(lost.load()).arg(late.load()).arg(duplicated.load()).arg(dropped.load());
+    str += hist_network.ToString("Network latency (sender to receiver)");
+    return str;
+}
+
+bool JointStreamReceiver::check_sequence(const JointFrame &frame){
+    const int id = frame.robot_index;
+    if (!sequence_valid[id]){
+        sequence_valid[id] = true;
+        last_sequence[id] = frame.sequence;
+        return true;
+    }
+
+    // Signed difference handles the wrap around of the sequence number
+    qint32 diff = static_cast<qint32>(frame.sequence - last_sequence[id]);
+    if (diff == 0){
+        duplicated.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    if (diff < 0){
+        // This frame was counted as lost when a newer one arrived
+        late.fetch_add(1, std::memory_order_relaxed);
+        if (lost.load(std::memory_order_relaxed) > 0){
+            lost.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return false;
+    }
+    if (diff > 1){
+        lost.fetch_add(diff - 1, std::memory_order_relaxed);
+    }
+    last_sequence[id] = frame.sequence;
+    return true;
+}
+
+void JointStreamReceiver::run(){
+    // The socket is created and used in this thread only, with blocking calls (no event loop is required)
+    QUdpSocket socket;
+    if (!socket.bind(QHostAddress::Any, port)){
+        qDebug() << "Unable to listen to UDP port" << port << ":" << socket.errorString();
+        running.store(false);
+        return;
+    }
+    socket.setSocketOption(QAbstractSocket::ReceiveBufferSizeSocketOption, 1024 * 1024);
+    qDebug() << "Listening to joint frames on UDP port" << port;
+
+    char datagram[JOINT_STREAM_MAX_SIZE + 1];
+    JointFrame frame;
+    while (running.load()){
+        if (!socket.waitForReadyRead(100)){
+            continue;
+        }
+
+        while (socket.hasPendingDatagrams()){
+            qint64 size = socket.readDatagram(datagram, sizeof(datagram));
+            qint64 now_ns = JointStreamClockNs();
+            if (size < 0 || !DecodeJointFrame(datagram, static_cast<int>(size), &frame) || frame.robot_index >= MaxRobots){
+                malformed.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+
+            received.fetch_add(1, std::memory_order_relaxed);
+            if (!check_sequence(frame)){
+                continue;
+            }
+
+            hist_network.Add(now_ns - frame.timestamp_ns);
+            if (!on_frame(frame)){
+                dropped.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    qDebug() << "Stopped listening to UDP port" << port;
+}
+
+
+//------------------------------- Test sender ------------------------------
+
+JointStreamSender::JointStreamSender(QObject *parent) : QThread(parent){
+}
+
+JointStreamSender::~JointStreamSender(){
+    Stop();
+}
+
+void JointStreamSender::Send(const QVector<JointFrame> &initial_frames, quint16 send_port, double send_rate_hz){
+    Stop();
+    frames = initial_frames;
+    port = send_port;
+    rate_hz = send_rate_hz;
+    sent.store(0);
+    running.store(true);
+    start(QThread::HighPriority);
+}
+
+void JointStreamSender::Stop(){
+    running.store(false);
+    wait();
+}
+
+quint64 JointStreamSender::Sent() const{
+    return sent.load();
+}
+
+void JointStreamSender::run(){
+    QUdpSocket socket;
+    char datagram[JOINT_STREAM_MAX_SIZE];
+    qDebug() << "Sending joint frames of" << frames.size() << "robots to UDP port" << port << "at" << rate_hz << "Hz";
+    JointStreamTestTrajectory(frames, rate_hz, running, [&](const JointFrame &frame){
+        int size = EncodeJointFrame(frame, datagram);
+        if (size > 0 && socket.writeDatagram(datagram, size, QHostAddress::LocalHost, port) == size){
+            sent.fetch_add(1, std::memory_order_relaxed);
+        }
+    });
+}
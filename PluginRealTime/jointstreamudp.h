@@ -0,0 +1,161 @@
+#ifndef JOINTSTREAMUDP_H
+#define JOINTSTREAMUDP_H
+
+#include <QThread>
+#include <QString>
+#include <QVector>
+
+#include <atomic>
+#include <functional>
+
+#include "jointframering.h"
+#include "realtimescheduler.h"
+
+
+///
+/// UDP joint frame format (little endian, one frame per datagram):
+///   uint32 magic (JOINT_STREAM_MAGIC)
+///   uint16 robot index
+///   uint16 number of joints (N)
+///   uint32 sequence number (per robot)
+///   int64  timestamp of the sender (steady clock, in nanoseconds)
+///   double joints[N]
+///
+#define JOINT_STREAM_MAGIC 0x4A4B4452 // "RDKJ"
+
+/// Size of the header of a frame, in bytes
+#define JOINT_STREAM_HEADER_SIZE 20
+
+/// Largest datagram: header and RDK_SIZE_JOINTS_MAX joints
+#define JOINT_STREAM_MAX_SIZE (JOINT_STREAM_HEADER_SIZE + 8 * RDK_SIZE_JOINTS_MAX)
+
+
+///
+/// \brief Encode a joint frame
+/// \param frame frame to encode
+/// \param buffer output buffer, at least JOINT_STREAM_MAX_SIZE bytes
+/// \return number of bytes written, or 0 if the frame is not valid
+///
+int EncodeJointFrame(const JointFrame &frame, char *buffer);
+
+///
+/// \brief Decode a joint frame
+/// \param data datagram
+/// \param size size of the datagram in bytes
+/// \param frame decoded frame
+/// \return false if the datagram is not a valid joint frame
+///
+bool DecodeJointFrame(const char *data, int size, JointFrame *frame);
+
+/// Current time of the steady clock, in nanoseconds (the same clock must be used by the sender to measure the latency)
+qint64 JointStreamClockNs();
+
+///
+/// \brief Produce the test trajectory at a fixed rate, until running is cleared: a sine (10 deg, 0.2 Hz) is added to all the joints.
+/// \param frames initial joints of each robot
+/// \param rate_hz frames per second produced for each robot
+/// \param running flag cleared by another thread to stop
+/// \param on_frame called for each frame, with the sequence number and the timestamp set
+///
+void JointStreamTestTrajectory(const QVector<JointFrame> &frames, double rate_hz, const std::atomic<bool> &running, const std::function<void(const JointFrame&)> &on_frame);
+
+
+///
+/// \brief The JointStreamReceiver class listens to joint frames over UDP on a background thread.
+/// Each valid frame is passed to the frame callback (the producer side of the joint frame ring).
+/// Lost, late and duplicated frames are detected with the sequence number of each robot.
+/// Frames that arrive after a newer one of the same robot are discarded.
+///
+class JointStreamReceiver : public QThread
+{
+    Q_OBJECT
+
+public:
+    /// Largest supported robot index
+    static const int MaxRobots = 256;
+
+    explicit JointStreamReceiver(QObject *parent = nullptr);
+    ~JointStreamReceiver();
+
+    ///
+    /// \brief Start listening
+    /// \param port UDP port
+    /// \param on_frame called from the receiver thread for each valid frame. Returns false if the frame was dropped.
+    ///
+    void Listen(quint16 port, std::function<bool(const JointFrame&)> on_frame);
+
+    /// Stop listening (blocks until the thread finishes)
+    void Stop();
+
+    /// Reset the counters and the network latency histogram
+    void ResetStatistics();
+
+    /// Summary of the counters and the network latency histogram
+    QString StatisticsToString() const;
+
+protected:
+    void run() override;
+
+private:
+    /// Check the sequence number of a frame. Returns false if the frame is late or duplicated.
+    bool check_sequence(const JointFrame &frame);
+
+private:
+    quint16 port { 0 };
+    std::function<bool(const JointFrame&)> on_frame;
+    std::atomic<bool> running { false };
+
+    // Sequence tracking (receiver thread only)
+    quint32 last_sequence[MaxRobots];
+    bool sequence_valid[MaxRobots];
+
+    std::atomic<quint64> received { 0 };
+    std::atomic<quint64> malformed { 0 };
+    std::atomic<quint64> lost { 0 };
+    std::atomic<quint64> late { 0 };
+    std::atomic<quint64> duplicated { 0 };
+    std::atomic<quint64> dropped { 0 };
+
+    /// Delay between the sender timestamp and the reception of the frame
+    RealTimeHistogram hist_network;
+};
+
+
+///
+/// \brief The JointStreamSender class sends a test trajectory over UDP at a fixed rate, using the joint frame format.
+/// It is meant to benchmark the complete UDP path (sender, receiver, ring and real time loop) on a single machine.
+///
+class JointStreamSender : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit JointStreamSender(QObject *parent = nullptr);
+    ~JointStreamSender();
+
+    ///
+    /// \brief Start sending
+    /// \param frames initial joints of each robot (a sine is added to all the joints)
+    /// \param port UDP port on the local host
+    /// \param rate_hz frames per second sent for each robot
+    ///
+    void Send(const QVector<JointFrame> &frames, quint16 port, double rate_hz);
+
+    /// Stop sending (blocks until the thread finishes)
+    void Stop();
+
+    /// Number of datagrams sent
+    quint64 Sent() const;
+
+protected:
+    void run() override;
+
+private:
+    QVector<JointFrame> frames;
+    quint16 port { 0 };
+    double rate_hz { 500.0 };
+    std::atomic<bool> running { false };
+    std::atomic<quint64> sent { 0 };
+};
+
+#endif // JOINTSTREAMUDP_H
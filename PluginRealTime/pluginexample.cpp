@@ -16,6 +16,9 @@
 #include <QIcon>
 #include <QDesktopServices>
 #include <QElapsedTimer>
+#include <QFontDatabase>
+
+#include <algorithm>
 
 //------------------------------- RoboDK Plug-in commands ------------------------------
 
@@ -45,15 +48,21 @@ QString PluginExample::PluginLoad(QMainWindow *mw, QMenuBar *menubar, QStatusBar
     action_help = new QAction(QIcon(":/resources/help.png"), tr("RoboDK Plugins - Help"));
     action_realtime = new QAction(QIcon(":/resources/red-button.png"), tr("Activate/deactivate Real Time loop"));
     action_realtime->setCheckable(true);
-    timer_realtime.setInterval(0);
+    action_realtime_stats = new QAction(QIcon(":/resources/information.png"), tr("Real Time Statistics"));
     //Robot = nullptr;
-    connect(&timer_realtime, SIGNAL(timeout()), this, SLOT(callback_realtime_process()));
+
+    // The scheduler emits the cycle signal from its own thread: the slot is queued to the GUI thread
+    scheduler_realtime.SetPeriodUs(RealTimeScheduler::PeriodMinUs);
+    connect(&scheduler_realtime, SIGNAL(cycle(quint64)), this, SLOT(callback_realtime_process()), Qt::QueuedConnection);
+    timer_realtime_stats.setInterval(500);
+    connect(&timer_realtime_stats, SIGNAL(timeout()), this, SLOT(callback_realtime_stats_update()));
 
     // Make sure to connect the action to your callback (slot)
     connect(action_information, SIGNAL(triggered()), this, SLOT(callback_information()), Qt::QueuedConnection);
     connect(action_robotpilot, SIGNAL(triggered()), this, SLOT(callback_robotpilot()), Qt::QueuedConnection);
     connect(action_help, SIGNAL(triggered()), this, SLOT(callback_help()), Qt::QueuedConnection);
     connect(action_realtime, SIGNAL(triggered(bool)), this, SLOT(callback_realtime(bool)), Qt::QueuedConnection);
+    connect(action_realtime_stats, SIGNAL(triggered()), this, SLOT(callback_realtime_stats()), Qt::QueuedConnection);
 
     // Here you can add one or more actions in the menu
     menu1 = menubar->addMenu("Real Time Plugin Example Menu");
@@ -62,10 +71,13 @@ QString PluginExample::PluginLoad(QMainWindow *mw, QMenuBar *menubar, QStatusBar
     menu1->addAction(action_robotpilot);
     menu1->addAction(action_help);
     menu1->addAction(action_realtime);
+    menu1->addAction(action_realtime_stats);
 
     // Important: reset the robot pilot dock/form pointer so that it is created the first time
     dock_robotpilot = nullptr;
     form_robotpilot = nullptr;
+    dock_realtime_stats = nullptr;
+    text_realtime_stats = nullptr;
 
     // If desired, trigger the real time operation here:
     action_realtime->setChecked(false);
@@ -80,6 +92,15 @@ void PluginExample::PluginUnload(){
     // Cleanup the plugin
     qDebug() << "Unloading plugin " << PluginName();
 
+    // stop the real time loop before anything else
+    record_stop();
+    replay_stop();
+    stream_udp_test_send(0, 0);
+    stream_udp_listen(0);
+    stream_test(0);
+    scheduler_realtime.Stop();
+    timer_realtime_stats.stop();
+
     // remove the menu
     menu1->deleteLater();
     menu1 = nullptr;
@@ -95,6 +116,12 @@ void PluginExample::PluginUnload(){
         form_robotpilot = nullptr;
     }
 
+    if (dock_realtime_stats != nullptr){
+        dock_realtime_stats->close();
+        dock_realtime_stats = nullptr;
+        text_realtime_stats = nullptr;
+    }
+
     // remove resources
     Q_CLEANUP_RESOURCE(resources1);
 }
@@ -121,6 +148,7 @@ void PluginExample::PluginLoadToolbar(QMainWindow *mw, int icon_size){
 
     // Add a new button to the toolbar
     toolbar2->addAction(action_realtime);
+    toolbar2->addAction(action_realtime_stats);
 }
 
 
@@ -152,6 +180,63 @@ QString PluginExample::PluginCommand(const QString &command, const QString &valu
     } else if (command.compare("ActivateRealtime", Qt::CaseInsensitive) == 0){
         callback_realtime(value.contains("true"));
         return "Done";
+    } else if (command.compare("RealtimeRate", Qt::CaseInsensitive) == 0){
+        // Cycle rate in Hz (250 to 1000 Hz)
+        bool ok = false;
+        double rate_hz = value.toDouble(&ok);
+        if (!ok || rate_hz <= 0.0 || !scheduler_realtime.SetPeriodUs(qRound(1e6 / rate_hz))){
+            return "Invalid rate";
+        }
+        return "Done";
+    } else if (command.compare("RealtimeStats", Qt::CaseInsensitive) == 0){
+        QString stats = realtime_statistics();
+        if (value.compare("reset", Qt::CaseInsensitive) == 0){
+            reset_realtime_statistics();
+        }
+        return stats;
+    } else if (command.compare("StageStats", Qt::CaseInsensitive) == 0){
+        // Per stage statistics. Use "reset" to clear them or a number of cycles to change the sliding window.
+        QString stats = stage_profiler.ToString();
+        bool ok = false;
+        int window = value.toInt(&ok);
+        if (ok && window > 0){
+            stage_profiler.SetWindow(window);
+        } else if (value.compare("reset", Qt::CaseInsensitive) == 0){
+            stage_profiler.Reset();
+        }
+        return stats;
+    } else if (command.compare("StreamTest", Qt::CaseInsensitive) == 0){
+        // Rate of the test producer in Hz, or "stop"
+        stream_test(value.toDouble());
+        return "Done";
+    } else if (command.compare("UdpListen", Qt::CaseInsensitive) == 0){
+        // UDP port, or "stop"
+        stream_udp_listen(value.toInt());
+        return "Done";
+    } else if (command.compare("UdpTestSend", Qt::CaseInsensitive) == 0){
+        // "port,rate_hz" (500 Hz by default), or "stop"
+        QStringList values = value.split(",");
+        double rate_hz = values.length() >= 2 ? values.at(1).toDouble() : 500.0;
+        stream_udp_test_send(values.at(0).toInt(), rate_hz);
+        return "Done";
+    } else if (command.compare("Record", Qt::CaseInsensitive) == 0){
+        // Joint log file name, or "stop"
+        if (value.compare("stop", Qt::CaseInsensitive) == 0){
+            record_stop();
+            return "Done";
+        }
+        return record_start(value) ? "Done" : "Invalid file";
+    } else if (command.compare("Replay", Qt::CaseInsensitive) == 0){
+        // "filename,speed" (speed 1 by default, 0 to replay as fast as possible), or "stop"
+        if (value.compare("stop", Qt::CaseInsensitive) == 0){
+            replay_stop();
+            return "Done";
+        }
+        int separator = value.lastIndexOf(",");
+        bool ok = false;
+        double speed = separator > 0 ? value.mid(separator + 1).toDouble(&ok) : 1.0;
+        QString filename = (separator > 0 && ok) ? value.left(separator) : value;
+        return replay_start(filename, ok ? speed : 1.0) ? "Done" : "Invalid file";
     } else if (command.startsWith("SetParam", Qt::CaseInsensitive)){
         QStringList command_param = command.split("-");
         if (command_param.length() >= 2){
@@ -168,7 +253,7 @@ QString PluginExample::PluginCommand(const QString &command, const QString &valu
 // Make sure to make this code as fast as possible to not provoke render lags
 void PluginExample::PluginEvent(TypeEvent event_type){
     switch (event_type) {
-    case EventChanged:        
+    case EventChanged: {
         //qDebug() << "An item has been added or deleted. Current station: " << RDK->getActiveStation()->Name();
         // Use: RDK->getActiveStation() to get the open station. This call always returns a valid pointer
         // Use: RDK->Valid(item ) to check if an item exists (it could have been deleted! Therefore, provoke a crash when using a method)
@@ -179,16 +264,28 @@ void PluginExample::PluginEvent(TypeEvent event_type){
         /*if (!RDK->Valid(Robot)) {
             Robot = nullptr;
         }*/
-        RobotList = RDK->getItemList(IItem::ITEM_TYPE_ROBOT);
+        QList<Item> robot_list = RDK->getItemList(IItem::ITEM_TYPE_ROBOT);
+        if (robot_list != RobotList){
+            // Logs and frames are indexed by robot: they are only valid for the list they were created with
+            record_stop();
+            replay_stop();
+            RobotList = robot_list;
+            reset_joint_frames();
+        }
 
         if (form_robotpilot != nullptr){
             form_robotpilot->SelectRobot();
         }
         break;
+    }
     case EventChangedStation:
     case EventAbout2ChangeStation:
     case EventAbout2CloseStation:
+        record_stop();
+        replay_stop();
+        stream_test(0);
         RobotList.clear();
+        reset_joint_frames();
         if (dock_robotpilot) {
             dock_robotpilot->close();
             dock_robotpilot = nullptr;
@@ -315,33 +412,111 @@ void PluginExample::callback_help(){
 void PluginExample::callback_realtime(bool realtime){
     qDebug() << "Running Real Time: " << realtime;
     if (realtime) {
-        timer_realtime.start();
+        reset_realtime_statistics();
+        scheduler_realtime.Start();
     } else {
-        timer_realtime.stop();
+        scheduler_realtime.Stop();
+    }
+}
+
+void PluginExample::callback_realtime_stats(){
+    if (dock_realtime_stats != nullptr){
+        // prevent opening more than 1 window
+        RDK->ShowMessage("Real time statistics are already open", false);
+        return;
     }
+
+    text_realtime_stats = new QTextEdit();
+    text_realtime_stats->setReadOnly(true);
+    text_realtime_stats->setLineWrapMode(QTextEdit::NoWrap);
+    text_realtime_stats->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    dock_realtime_stats = AddDockWidget(MainWindow, text_realtime_stats, "Real Time Statistics");
+    connect(text_realtime_stats, SIGNAL(destroyed()), this, SLOT(callback_realtime_stats_closed()));
+    callback_realtime_stats_update();
+    timer_realtime_stats.start();
+}
+
+void PluginExample::callback_realtime_stats_closed(){
+    timer_realtime_stats.stop();
+    dock_realtime_stats = nullptr;
+    text_realtime_stats = nullptr;
+}
+
+void PluginExample::callback_realtime_stats_update(){
+    if (text_realtime_stats == nullptr){
+        return;
+    }
+    text_realtime_stats->setPlainText(realtime_statistics());
 }
 
 void PluginExample::callback_realtime_process(){
-    static int time_last = QDateTime::currentMSecsSinceEpoch();
-    int time_now = QDateTime::currentMSecsSinceEpoch();
-    if (time_now - time_last < 1){
+    // Only the work that requires the RoboDK API is done here: timing is handled by the scheduler thread
+    scheduler_realtime.CycleBegin();
+    if (!scheduler_realtime.Running()){
+        scheduler_realtime.CycleEnd();
         return;
     }
-    time_last = time_now;
+
+    stage_profiler.BeginCycle();
+
+    // Apply the joint log being replayed and the setpoints sent by the producer thread (if any)
+    bool render = replay_step();
+    if (process_joint_frames()){
+        render = true;
+    }
 
     if (RobotList.length() == 0){
         qDebug() << "No robots selected or loaded";
+        stage_profiler.EndCycle();
+        scheduler_realtime.CycleEnd();
         return;
     }
 
+    int record_offset = 0;
     foreach (Item robot, RobotList){
-        tJoints joints(robot->Joints());
+        tJoints joints;
+        {
+            ScopedStageTimer timer(&stage_profiler, StageProfiler::StageJoints);
+            joints = robot->Joints();
+        }
+
+        Mat pose;
+        {
+            ScopedStageTimer timer(&stage_profiler, StageProfiler::StageSolveFK);
+            pose = robot->SolveFK(joints);
+        }
+
+        ScopedStageTimer timer(&stage_profiler, StageProfiler::StageUserLogic);
         qDebug() << "Robot: " << robot->Name();
         qDebug() << "    Current robot joints are: " << joints;
-        qDebug() << "    Calculated forward kinematcs: " << robot->SolveFK(joints);
+        qDebug() << "    Calculated forward kinematcs: " << pose;
 
+        if (joint_recorder.IsOpen() && record_offset + joints.Length() <= record_joints.size()){
+            std::copy(joints.ValuesD(), joints.ValuesD() + joints.Length(), record_joints.data() + record_offset);
+            record_offset += joints.Length();
+        }
     }
 
+    if (joint_recorder.IsOpen()){
+        ScopedStageTimer timer(&stage_profiler, StageProfiler::StageUserLogic);
+        if (record_offset != record_joints.size()){
+            qDebug() << "The number of joints of the robots changed, stopping the recording";
+            record_stop();
+        } else if (!joint_recorder.Record(record_timer.nsecsElapsed() / 1000, record_joints.constData())){
+            qDebug() << "Unable to write the joint log, stopping the recording";
+            record_stop();
+        }
+    }
+
+    // Render once per cycle, after all the robots have been updated
+    if (render){
+        ScopedStageTimer timer(&stage_profiler, StageProfiler::StageRender);
+        RDK->Render(RoboDK::RenderUpdateOnly);
+    }
+
+    stage_profiler.EndCycle();
+    scheduler_realtime.CycleEnd();
+
 
 
     // If you have one robot you can do:
@@ -363,7 +538,305 @@ void PluginExample::callback_realtime_process(){
 }
 
 
+//----------------------------------------------------------------------------------
+// Joint stream: a producer thread sends joint frames, the GUI thread applies them once per cycle
+
+bool PluginExample::PushJointFrame(const JointFrame &frame){
+    if (!joint_frames.Push(frame)){
+        joint_frames_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+void PluginExample::reset_joint_frames(){
+    // Discard the frames sent for the previous list of robots
+    JointFrame frame;
+    while (joint_frames.Pop(&frame)){
+    }
+
+    joint_frames_latest.resize(RobotList.size());
+    joint_frames_pending.fill(false, RobotList.size());
+
+    // Number of joints of each robot, to check the frames without calling the RoboDK API every cycle
+    joint_frames_ndofs.resize(RobotList.size());
+    for (int i = 0; i < RobotList.size(); i++){
+        joint_frames_ndofs[i] = RobotList[i]->Joints().Length();
+    }
+}
+
+void PluginExample::reset_realtime_statistics(){
+    scheduler_realtime.ResetStatistics();
+    stage_profiler.Reset();
+    stream_receiver.ResetStatistics();
+    joint_frames_dropped.store(0);
+    joint_frames_received = 0;
+    joint_frames_applied = 0;
+    joint_frames_superseded = 0;
+    joint_frames_invalid = 0;
+    joint_frames_overruns = 0;
+    joint_frames_latency.Reset();
+}
+
+bool PluginExample::process_joint_frames(){
+    if (joint_frames.Size() >= JointFrameRing::MaxSize()){
+        joint_frames_overruns++;
+    }
+
+    // Keep only the latest frame of each robot
+    JointFrame frame;
+    while (joint_frames.Pop(&frame)){
+        joint_frames_received++;
+        if (frame.robot_index < 0 || frame.robot_index >= joint_frames_latest.size() || frame.ndofs != joint_frames_ndofs[frame.robot_index]){
+            joint_frames_invalid++;
+            continue;
+        }
+        if (joint_frames_pending[frame.robot_index]){
+            joint_frames_superseded++;
+        }
+        joint_frames_latest[frame.robot_index] = frame;
+        joint_frames_pending[frame.robot_index] = true;
+    }
+
+    bool moved = false;
+    for (int i = 0; i < joint_frames_pending.size(); i++){
+        if (!joint_frames_pending[i]){
+            continue;
+        }
+        joint_frames_pending[i] = false;
+
+        const JointFrame &latest = joint_frames_latest[i];
+        {
+            ScopedStageTimer timer(&stage_profiler, StageProfiler::StageSetJoints);
+            RobotList[i]->setJoints(tJoints(latest.joints, latest.ndofs));
+        }
+        joint_frames_applied++;
+        moved = true;
+        if (latest.timestamp_ns > 0){
+            joint_frames_latency.Add(JointStreamClockNs() - latest.timestamp_ns);
+        }
+    }
+    return moved;
+}
+
+QString PluginExample::realtime_statistics(){
+    QString str = scheduler_realtime.StatisticsToString();
+    str += "\n" + stage_profiler.ToString();
+    str += QString("\nJoint stream: %1 frames received, %2 applied, %3 superseded, %4 invalid, %5 dropped (ring full), %6 cycles with the ring full\n")
+            .arg(joint_frames_received).arg(joint_frames_applied).arg(joint_frames_superseded)
+            .arg(joint_frames_invalid).arg(joint_frames_dropped.load()).arg(joint_frames_overruns);
+    str += joint_frames_latency.ToString("End to end latency (frame timestamp to setJoints)");
+    str += "\n" + stream_receiver.StatisticsToString();
+    if (stream_sender.isRunning()){
+        str += QString("UDP test sender: %1 frames sent\n").arg(stream_sender.Sent());
+    }
+    if (joint_recorder.IsOpen()){
+        str += QString("\nRecording: %1 records, %2 bytes (%3 bytes per record)\n")
+                .arg(joint_recorder.Records()).arg(joint_recorder.Bytes())
+                .arg(joint_recorder.Records() > 0 ? static_cast<double>(joint_recorder.Bytes()) / joint_recorder.Records() : 0.0, 0, 'f', 1);
+    }
+    if (joint_replayer.IsOpen()){
+        str += QString("\nReplaying: %1 of %2 records, %3 renders\n").arg(replay_records).arg(joint_replayer.Records()).arg(replay_renders);
+    } else if (!replay_summary.isEmpty()){
+        str += "\n" + replay_summary + "\n";
+    }
+    return str;
+}
+
+void PluginExample::stream_test(double rate_hz){
+    // Stop the running producer first
+    stream_test_running.store(false);
+    if (stream_test_thread.joinable()){
+        stream_test_thread.join();
+    }
+
+    if (rate_hz <= 0.0 || RobotList.isEmpty()){
+        return;
+    }
+
+    // Only one producer can use the ring
+    stream_udp_listen(0);
+
+    // The producer cannot use the RoboDK API: take a snapshot of the current joints here (GUI thread)
+    QVector<JointFrame> frames(RobotList.size());
+    for (int i = 0; i < RobotList.size(); i++){
+        tJoints joints = RobotList[i]->Joints();
+        frames[i].robot_index = i;
+        frames[i].ndofs = joints.GetValues(frames[i].joints);
+        frames[i].sequence = 0;
+        frames[i].timestamp_ns = 0;
+    }
+
+    qDebug() << "Streaming a test trajectory to" << frames.size() << "robots at" << rate_hz << "Hz";
+    stream_test_running.store(true);
+    stream_test_thread = std::thread([this, frames, rate_hz](){
+        JointStreamTestTrajectory(frames, rate_hz, stream_test_running, [this](const JointFrame &frame){
+            PushJointFrame(frame);
+        });
+    });
+}
+
+void PluginExample::stream_udp_listen(int port){
+    if (port <= 0 || port > 0xFFFF){
+        stream_receiver.Stop();
+        return;
+    }
+
+    // Only one producer can use the ring
+    stream_test(0);
+    stream_receiver.ResetStatistics();
+    joint_frames_latency.Reset();
+    stream_receiver.Listen(static_cast<quint16>(port), [this](const JointFrame &frame){
+        return PushJointFrame(frame);
+    });
+}
+
+void PluginExample::stream_udp_test_send(int port, double rate_hz){
+    if (port <= 0 || port > 0xFFFF || rate_hz <= 0.0 || RobotList.isEmpty()){
+        stream_sender.Stop();
+        return;
+    }
+
+    // The sender cannot use the RoboDK API: take a snapshot of the current joints here (GUI thread)
+    QVector<JointFrame> frames(RobotList.size());
+    for (int i = 0; i < RobotList.size(); i++){
+        tJoints joints = RobotList[i]->Joints();
+        frames[i].robot_index = i;
+        frames[i].ndofs = joints.GetValues(frames[i].joints);
+        frames[i].sequence = 0;
+        frames[i].timestamp_ns = 0;
+    }
+    stream_sender.Send(frames, static_cast<quint16>(port), rate_hz);
+}
 
 
+//----------------------------------------------------------------------------------
+// Record and replay the joints of all the robots
 
+bool PluginExample::record_start(const QString &filename){
+    record_stop();
+    if (RobotList.isEmpty()){
+        return false;
+    }
+
+    QVector<int> ndofs;
+    int njoints = 0;
+    foreach (Item robot, RobotList){
+        ndofs.append(robot->Joints().Length());
+        njoints += ndofs.last();
+    }
+    if (!joint_recorder.Open(filename, ndofs)){
+        return false;
+    }
 
+    record_joints.fill(0.0, njoints);
+    record_timer.start();
+    qDebug() << "Recording the joints of" << RobotList.size() << "robots to" << filename;
+    return true;
+}
+
+void PluginExample::record_stop(){
+    if (!joint_recorder.IsOpen()){
+        return;
+    }
+    qDebug() << "Recorded" << joint_recorder.Records() << "cycles (" << joint_recorder.Bytes() << "bytes)";
+    joint_recorder.Close();
+}
+
+bool PluginExample::replay_start(const QString &filename, double speed){
+    replay_stop();
+    if (!joint_replayer.Open(filename)){
+        return false;
+    }
+
+    // The log must match the robots of the station
+    const QVector<int> &ndofs = joint_replayer.Dofs();
+    bool valid = ndofs.size() <= RobotList.size();
+    for (int i = 0; valid && i < ndofs.size(); i++){
+        valid = (RobotList[i]->Joints().Length() == ndofs[i]);
+    }
+    if (!valid){
+        qDebug() << "The joint log" << filename << "does not match the robots of the station";
+        joint_replayer.Close();
+        return false;
+    }
+
+    replay_speed = qMax(0.0, speed);
+    replay_joints.fill(0.0, joint_replayer.JointCount());
+    replay_next_joints.fill(0.0, joint_replayer.JointCount());
+    replay_has_next = joint_replayer.Next(&replay_next_time_us, replay_next_joints.data());
+    replay_records = 0;
+    replay_renders = 0;
+    replay_summary.clear();
+    replay_timer.start();
+    qDebug() << "Replaying" << joint_replayer.Records() << "records from" << filename << "at speed" << replay_speed;
+    return true;
+}
+
+void PluginExample::replay_stop(){
+    if (!joint_replayer.IsOpen()){
+        return;
+    }
+
+    double elapsed_s = replay_timer.nsecsElapsed() / 1e9;
+    replay_summary = QString("Last replay: %1 records in %2 s (%3 records per second, %4 renders)")
+            .arg(replay_records).arg(elapsed_s, 0, 'f', 3)
+            .arg(elapsed_s > 0.0 ? replay_records / elapsed_s : 0.0, 0, 'f', 1).arg(replay_renders);
+    qDebug() << replay_summary;
+    joint_replayer.Close();
+}
+
+void PluginExample::replay_apply(const double *joints){
+    ScopedStageTimer timer(&stage_profiler, StageProfiler::StageSetJoints);
+    const QVector<int> &ndofs = joint_replayer.Dofs();
+    int offset = 0;
+    for (int i = 0; i < ndofs.size(); i++){
+        RobotList[i]->setJoints(tJoints(joints + offset, ndofs[i]));
+        offset += ndofs[i];
+    }
+}
+
+bool PluginExample::replay_step(){
+    if (!joint_replayer.IsOpen()){
+        return false;
+    }
+
+    bool render = false;
+    if (replay_speed > 0.0){
+        // Apply the latest record that is due: intermediate records are skipped if the replay is faster than the cycle
+        const qint64 target_us = static_cast<qint64>(replay_timer.nsecsElapsed() / 1000 * replay_speed);
+        bool due = false;
+        while (replay_has_next && replay_next_time_us <= target_us){
+            replay_joints.swap(replay_next_joints);
+            due = true;
+            replay_records++;
+            replay_has_next = joint_replayer.Next(&replay_next_time_us, replay_next_joints.data());
+        }
+        if (due){
+            replay_apply(replay_joints.constData());
+            replay_renders++;
+            render = true;
+        }
+    } else {
+        // As fast as possible: apply and render every record for the duration of one cycle
+        QElapsedTimer budget;
+        budget.start();
+        const qint64 budget_ns = static_cast<qint64>(scheduler_realtime.PeriodUs()) * 1000;
+        while (replay_has_next && budget.nsecsElapsed() < budget_ns){
+            replay_apply(replay_next_joints.constData());
+            {
+                ScopedStageTimer timer(&stage_profiler, StageProfiler::StageRender);
+                RDK->Render(RoboDK::RenderComplete);
+            }
+            replay_records++;
+            replay_renders++;
+            replay_has_next = joint_replayer.Next(&replay_next_time_us, replay_next_joints.data());
+        }
+    }
+
+    if (!replay_has_next){
+        replay_stop();
+        RDK->ShowMessage(replay_summary, false);
+    }
+    return render;
+}
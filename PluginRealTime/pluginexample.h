@@ -7,7 +7,17 @@
 #include <QDockWidget>
 #include "iapprobodk.h"
 #include "robodktypes.h"
+#include "realtimescheduler.h"
+#include "jointframering.h"
+#include "jointstreamudp.h"
+#include "jointlog.h"
+#include "stageprofiler.h"
 #include <QTimer>
+#include <QVector>
+#include <QElapsedTimer>
+
+#include <atomic>
+#include <thread>
 
 
 
@@ -17,6 +27,7 @@ class QAction;
 class IRoboDK;
 class IItem;
 class FormRobotPilot;
+class QTextEdit;
 
 
 class PluginExample : public QObject, IAppRoboDK
@@ -44,6 +55,15 @@ public:
     QStatusBar *StatusBar;    // Status bar
     RoboDK *RDK;              // Pointer to RoboDK API (fast API)
 
+public:
+    ///
+    /// \brief Queue a joint setpoint for the real time loop. It never blocks and never allocates memory.
+    /// Only one thread (the producer) may call this function. The frame is applied by the GUI thread on the next cycle.
+    /// \param frame joint setpoint (robot_index is the index of the robot in the list of robots of the station)
+    /// \return false if the ring is full and the frame was dropped
+    ///
+    bool PushJointFrame(const JointFrame &frame);
+
 public slots:
     // define button callbacks (or slots) here. They are triggered automatically when the button is selected.
 
@@ -70,8 +90,101 @@ public slots:
 
     void callback_realtime(bool realtime);
 
+    ///
+    /// \brief Called by the real time scheduler on every cycle (from the GUI thread)
+    ///
     void callback_realtime_process();
 
+    ///
+    /// \brief Called when the real time statistics button/action is selected
+    ///
+    void callback_realtime_stats();
+
+    ///
+    /// \brief Called when the real time statistics window is closed (event triggered by the dock window)
+    ///
+    void callback_realtime_stats_closed();
+
+    ///
+    /// \brief Refresh the real time statistics window
+    ///
+    void callback_realtime_stats_update();
+
+private:
+    ///
+    /// \brief Drain the joint frame ring and apply the latest frame of each robot (GUI thread, once per cycle)
+    /// \return true if at least one robot moved (a render is required)
+    ///
+    bool process_joint_frames();
+
+    ///
+    /// \brief Resize the per robot buffers of the joint stream (called when the list of robots changes)
+    ///
+    void reset_joint_frames();
+
+    /// Clear the statistics of the real time loop, the stages and the joint stream
+    void reset_realtime_statistics();
+
+    ///
+    /// \brief Summary of the real time statistics (scheduler and joint stream)
+    ///
+    QString realtime_statistics();
+
+    ///
+    /// \brief Start or stop a test producer that streams a sine trajectory to all the robots
+    /// \param rate_hz rate of the producer in Hz, stops the producer if 0
+    ///
+    void stream_test(double rate_hz);
+
+    ///
+    /// \brief Start or stop listening to joint frames over UDP
+    /// \param port UDP port, stops listening if 0
+    ///
+    void stream_udp_listen(int port);
+
+    ///
+    /// \brief Start or stop the local UDP test sender (sends a sine trajectory to all the robots)
+    /// \param port UDP port on the local host, stops the sender if 0
+    /// \param rate_hz frames per second sent for each robot
+    ///
+    void stream_udp_test_send(int port, double rate_hz);
+
+    ///
+    /// \brief Start recording the joints of all the robots, once per cycle
+    /// \param filename joint log to create
+    /// \return false if the log could not be created
+    ///
+    bool record_start(const QString &filename);
+
+    ///
+    /// \brief Stop recording and close the joint log
+    ///
+    void record_stop();
+
+    ///
+    /// \brief Start replaying a joint log on the robots of the station
+    /// \param filename joint log
+    /// \param speed replay speed (1 for real time), or 0 to replay as fast as possible
+    /// \return false if the log could not be opened or it does not match the robots of the station
+    ///
+    bool replay_start(const QString &filename, double speed);
+
+    ///
+    /// \brief Stop replaying the joint log
+    ///
+    void replay_stop();
+
+    ///
+    /// \brief Apply the records of the joint log that are due in this cycle (GUI thread, once per cycle)
+    /// \return true if the robots moved and a render is required
+    ///
+    bool replay_step();
+
+    ///
+    /// \brief Set the joints of all the robots from a record of the joint log (without rendering)
+    ///
+    void replay_apply(const double *joints);
+
 private:
     // define your actions: usually, one action per button
     QToolBar *toolbar1;
@@ -81,12 +194,99 @@ private:
     QAction *action_robotpilot;
     QAction *action_help;
     QAction *action_realtime;
+    QAction *action_realtime_stats;
     QDockWidget *dock_robotpilot;
     FormRobotPilot *form_robotpilot;
-    QTimer timer_realtime;
+    QDockWidget *dock_realtime_stats;
+    QTextEdit *text_realtime_stats;
+
+    /// Fixed rate scheduler of the real time loop
+    RealTimeScheduler scheduler_realtime;
+
+    /// Time spent in each stage of the real time cycle (GUI thread)
+    StageProfiler stage_profiler;
+
+    /// Refresh timer of the real time statistics window
+    QTimer timer_realtime_stats;
 
     //Item Robot;
     QList<Item> RobotList;
+
+    /// Joint frames sent by a producer thread to the GUI thread
+    JointFrameRing joint_frames;
+
+    /// Latest frame received for each robot of RobotList during the current cycle
+    QVector<JointFrame> joint_frames_latest;
+
+    /// Flags the robots of joint_frames_latest that received a frame during the current cycle
+    QVector<bool> joint_frames_pending;
+
+    /// Number of joints of each robot of RobotList (frames with another number of joints are discarded)
+    QVector<int> joint_frames_ndofs;
+
+    /// Frames dropped by the producer because the ring was full
+    std::atomic<quint64> joint_frames_dropped { 0 };
+
+    /// Frames received by the consumer
+    quint64 joint_frames_received = 0;
+
+    /// Frames applied to a robot with setJoints
+    quint64 joint_frames_applied = 0;
+
+    /// Frames discarded because a newer frame for the same robot arrived in the same cycle
+    quint64 joint_frames_superseded = 0;
+
+    /// Frames discarded because the robot index is not valid or the number of joints does not match the robot
+    quint64 joint_frames_invalid = 0;
+
+    /// Cycles that found the ring full (the producer is faster than the real time loop)
+    quint64 joint_frames_overruns = 0;
+
+    /// Delay between the timestamp of a frame and the moment it is applied to the robot
+    RealTimeHistogram joint_frames_latency;
+
+    /// UDP joint stream (producer of the ring when listening)
+    JointStreamReceiver stream_receiver;
+
+    /// Local UDP test sender
+    JointStreamSender stream_sender;
+
+    /// Joint log being recorded
+    JointRecorder joint_recorder;
+
+    /// Joints of all the robots for the current record (allocated when the recording starts)
+    QVector<double> record_joints;
+
+    /// Time since the recording started
+    QElapsedTimer record_timer;
+
+    /// Joint log being replayed
+    JointReplayer joint_replayer;
+
+    /// Replay speed (1 for real time), 0 to replay as fast as possible
+    double replay_speed = 1.0;
+
+    /// Last applied record and next record of the joint log (swapped to avoid copies)
+    QVector<double> replay_joints;
+    QVector<double> replay_next_joints;
+
+    /// Time of the next record (us) and true if there is a next record
+    qint64 replay_next_time_us = 0;
+    bool replay_has_next = false;
+
+    /// Time since the replay started
+    QElapsedTimer replay_timer;
+
+    /// Number of records applied and renders requested since the replay started
+    quint64 replay_records = 0;
+    quint64 replay_renders = 0;
+
+    /// Summary of the last replay
+    QString replay_summary;
+
+    /// Test producer thread
+    std::thread stream_test_thread;
+    std::atomic<bool> stream_test_running { false };
 };
 //! [0]
 
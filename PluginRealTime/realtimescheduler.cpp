@@ -0,0 +1,230 @@
+#include "realtimescheduler.h"
+
+#include <QDebug>
+
+#include <chrono>
+
+
+//------------------------------- Histogram ------------------------------
+
+static const int HISTOGRAM_BOUNDS_US[RealTimeHistogram::BinCount - 1] = { 5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000 };
+
+RealTimeHistogram::RealTimeHistogram(){
+    Reset();
+}
+
+void RealTimeHistogram::Add(qint64 value_ns){
+    if (value_ns < 0){
+        value_ns = 0;
+    }
+
+    int bin = 0;
+    qint64 value_us = value_ns / 1000;
+    while (bin < BinCount - 1 && value_us >= HISTOGRAM_BOUNDS_US[bin]){
+        bin++;
+    }
+    bins[bin].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    sum_ns.fetch_add(value_ns, std::memory_order_relaxed);
+
+    qint64 max_last = max_ns.load(std::memory_order_relaxed);
+    while (value_ns > max_last && !max_ns.compare_exchange_weak(max_last, value_ns, std::memory_order_relaxed)){
+    }
+}
+
+void RealTimeHistogram::Reset(){
+    for (int i = 0; i < BinCount; i++){
+        bins[i].store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    sum_ns.store(0, std::memory_order_relaxed);
+    max_ns.store(0, std::memory_order_relaxed);
+}
+
+quint64 RealTimeHistogram::Count() const{
+    return count.load(std::memory_order_relaxed);
+}
+
+double RealTimeHistogram::MeanUs() const{
+    quint64 n = Count();
+    if (n == 0){
+        return 0.0;
+    }
+    return static_cast<double>(sum_ns.load(std::memory_order_relaxed)) / n / 1000.0;
+}
+
+double RealTimeHistogram::MaxUs() const{
+    return max_ns.load(std::memory_order_relaxed) / 1000.0;
+}
+
+int RealTimeHistogram::BinUpperUs(int bin){
+    if (bin < 0 || bin >= BinCount - 1){
+        return -1;
+    }
+    return HISTOGRAM_BOUNDS_US[bin];
+}
+
+QString RealTimeHistogram::ToString(const QString &title) const{
+    const int bar_width = 40;
+    quint64 n = Count();
+    QString str = QString("%1: %2 samples, mean %3 us, max %4 us\n").arg(title).arg(n).arg(MeanUs(), 0, 'f', 1).arg(MaxUs(), 0, 'f', 1);
+    if (n == 0){
+        return str;
+    }
+
+    for (int i = 0; i < BinCount; i++){
+        quint64 nbin = bins[i].load(std::memory_order_relaxed);
+        QString label = (i < BinCount - 1) ? QString("< %1 us").arg(BinUpperUs(i)) : QString(">= %1 us").arg(BinUpperUs(i - 1));
+        int bar = static_cast<int>((nbin * bar_width) / n);
+        str += QString("  %1 %2 %3\n").arg(label, 10).arg(nbin, 9).arg(QString(bar, '#'));
+    }
+    return str;
+}
+
+
+//------------------------------- Scheduler ------------------------------
+
+RealTimeScheduler::RealTimeScheduler(QObject *parent) : QObject(parent){
+}
+
+RealTimeScheduler::~RealTimeScheduler(){
+    Stop();
+}
+
+bool RealTimeScheduler::SetPeriodUs(int period){
+    if (period < PeriodMinUs || period > PeriodMaxUs){
+        return false;
+    }
+    period_us.store(period);
+    return true;
+}
+
+int RealTimeScheduler::PeriodUs() const{
+    return period_us.load();
+}
+
+void RealTimeScheduler::SetSpinUs(int spin){
+    spin_us.store(qMax(0, spin));
+}
+
+void RealTimeScheduler::Start(){
+    if (running.load()){
+        return;
+    }
+    gui_pending.store(false);
+    running.store(true);
+    thread = std::thread(&RealTimeScheduler::Run, this);
+}
+
+void RealTimeScheduler::Stop(){
+    running.store(false);
+    if (thread.joinable()){
+        thread.join();
+    }
+    gui_pending.store(false);
+}
+
+bool RealTimeScheduler::Running() const{
+    return running.load();
+}
+
+void RealTimeScheduler::CycleBegin(){
+    gui_begin_ns = SteadyNs();
+    hist_dispatch.Add(gui_begin_ns - gui_posted_ns.load());
+}
+
+void RealTimeScheduler::CycleEnd(){
+    qint64 elapsed_ns = SteadyNs() - gui_begin_ns;
+    hist_gui.Add(elapsed_ns);
+    if (elapsed_ns > static_cast<qint64>(period_us.load()) * 1000){
+        gui_overruns.fetch_add(1, std::memory_order_relaxed);
+    }
+    gui_pending.store(false);
+}
+
+void RealTimeScheduler::ResetStatistics(){
+    cycles.store(0);
+    overruns.store(0);
+    missed_cycles.store(0);
+    skipped.store(0);
+    gui_overruns.store(0);
+    hist_wakeup.Reset();
+    hist_dispatch.Reset();
+    hist_gui.Reset();
+}
+
+QString RealTimeScheduler::StatisticsToString() const{
+    QString str = QString("Period: %1 us (%2 Hz), %3\n").arg(PeriodUs()).arg(1e6 / PeriodUs(), 0, 'f', 1).arg(Running() ? "running" : "stopped");
+    str += QString("Cycles: %1, overruns: %2 (%3 cycles missed), skipped (GUI busy): %4, GUI cycles longer than the period: %5\n")
+            .arg(Cycles()).arg(Overruns()).arg(missed_cycles.load()).arg(Skipped()).arg(gui_overruns.load());
+    str += "\n" + hist_wakeup.ToString("Wake up jitter");
+    str += "\n" + hist_dispatch.ToString("GUI dispatch latency");
+    str += "\n" + hist_gui.ToString("GUI cycle time");
+    return str;
+}
+
+quint64 RealTimeScheduler::Cycles() const{
+    return cycles.load();
+}
+
+quint64 RealTimeScheduler::Overruns() const{
+    return overruns.load();
+}
+
+quint64 RealTimeScheduler::Skipped() const{
+    return skipped.load();
+}
+
+qint64 RealTimeScheduler::SteadyNs(){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void RealTimeScheduler::Run(){
+    using clock = std::chrono::steady_clock;
+
+    qDebug() << "Real time scheduler started with a period of" << PeriodUs() << "us";
+    clock::time_point deadline = clock::now() + std::chrono::microseconds(period_us.load());
+    while (running.load()){
+        const std::chrono::microseconds period(period_us.load());
+        const std::chrono::microseconds spin(spin_us.load());
+
+        // Sleep until the deadline, optionally spinning the last microseconds for a more accurate wake up
+        if (spin.count() > 0){
+            std::this_thread::sleep_until(deadline - spin);
+            while (clock::now() < deadline){
+                std::this_thread::yield();
+            }
+        } else {
+            std::this_thread::sleep_until(deadline);
+        }
+
+        if (!running.load()){
+            break;
+        }
+
+        const clock::time_point now = clock::now();
+        const std::chrono::nanoseconds late = now - deadline;
+        hist_wakeup.Add(late.count());
+        quint64 index = cycles.fetch_add(1);
+
+        // Overrun: we woke up after the following deadline. Drop the missed cycles instead of running them in a burst.
+        if (late >= period){
+            qint64 missed = late / period;
+            overruns.fetch_add(1, std::memory_order_relaxed);
+            missed_cycles.fetch_add(missed, std::memory_order_relaxed);
+            deadline += missed * period;
+        }
+
+        // Post the cycle to the GUI thread, unless it is still processing the previous one
+        bool expected = false;
+        if (gui_pending.compare_exchange_strong(expected, true)){
+            gui_posted_ns.store(SteadyNs());
+            emit cycle(index);
+        } else {
+            skipped.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        deadline += period;
+    }
+    qDebug() << "Real time scheduler stopped";
+}
@@ -0,0 +1,164 @@
+#ifndef REALTIMESCHEDULER_H
+#define REALTIMESCHEDULER_H
+
+#include <QObject>
+#include <QString>
+
+#include <atomic>
+#include <thread>
+
+
+///
+/// \brief Histogram of durations with fixed bins (in microseconds).
+/// Samples can be added from one thread while another thread reads the statistics, without locking.
+///
+class RealTimeHistogram
+{
+public:
+    /// Number of bins. The last bin holds all the samples above the last bound.
+    static const int BinCount = 12;
+
+    RealTimeHistogram();
+
+    /// Add a sample, in nanoseconds
+    void Add(qint64 value_ns);
+
+    /// Remove all samples
+    void Reset();
+
+    /// Number of samples
+    quint64 Count() const;
+
+    /// Mean of the samples, in microseconds
+    double MeanUs() const;
+
+    /// Largest sample, in microseconds
+    double MaxUs() const;
+
+    /// Upper bound of a bin, in microseconds (-1 for the last bin)
+    static int BinUpperUs(int bin);
+
+    /// Text representation of the histogram (one line per bin)
+    QString ToString(const QString &title) const;
+
+private:
+    std::atomic<quint64> bins[BinCount];
+    std::atomic<quint64> count;
+    std::atomic<qint64> sum_ns;
+    std::atomic<qint64> max_ns;
+};
+
+
+///
+/// \brief The RealTimeScheduler class runs a fixed rate cycle on its own thread.
+/// The thread sleeps until the next deadline of the cycle (steady clock) instead of relying on the GUI event loop.
+/// Every cycle emits \ref cycle, which should be connected to a slot of an object living in the GUI thread:
+/// only the work that needs the RoboDK API is done there. A new cycle is not posted while the previous one is still pending.
+///
+class RealTimeScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    /// Shortest allowed period (1 kHz)
+    static const int PeriodMinUs = 1000;
+
+    /// Longest allowed period (250 Hz)
+    static const int PeriodMaxUs = 4000;
+
+    explicit RealTimeScheduler(QObject *parent = nullptr);
+    ~RealTimeScheduler();
+
+    ///
+    /// \brief Set the period of the cycle. It can be changed while the scheduler is running.
+    /// \param period_us period in microseconds, between \ref PeriodMinUs and \ref PeriodMaxUs
+    /// \return false if the period is out of range
+    ///
+    bool SetPeriodUs(int period_us);
+
+    /// Period of the cycle, in microseconds
+    int PeriodUs() const;
+
+    ///
+    /// \brief Busy-wait the last microseconds before each deadline to reduce the wake up jitter (0 by default: sleep only).
+    /// Useful on systems with a coarse sleep granularity, at the cost of some CPU usage on the scheduler thread.
+    ///
+    void SetSpinUs(int spin_us);
+
+    /// Start the scheduler thread
+    void Start();
+
+    /// Stop the scheduler thread (blocks until the thread finishes)
+    void Stop();
+
+    /// Returns true if the scheduler thread is running
+    bool Running() const;
+
+    /// Must be called by the GUI thread when it starts processing a cycle
+    void CycleBegin();
+
+    /// Must be called by the GUI thread when it is done with a cycle. The next cycle will not be posted before.
+    void CycleEnd();
+
+    /// Reset the counters and histograms
+    void ResetStatistics();
+
+    /// Summary of the counters and histograms
+    QString StatisticsToString() const;
+
+    /// Number of cycles executed by the scheduler thread
+    quint64 Cycles() const;
+
+    /// Number of times the scheduler thread woke up after the following deadline
+    quint64 Overruns() const;
+
+    /// Number of cycles not posted because the GUI thread was still busy with the previous one
+    quint64 Skipped() const;
+
+signals:
+    ///
+    /// \brief Emitted from the scheduler thread at every cycle that must be processed by the GUI thread
+    /// \param index cycle index
+    ///
+    void cycle(quint64 index);
+
+private:
+    /// Scheduler thread loop
+    void Run();
+
+    /// Current time of the steady clock, in nanoseconds
+    static qint64 SteadyNs();
+
+private:
+    std::thread thread;
+    std::atomic<bool> running { false };
+
+    std::atomic<int> period_us { 1000 };
+    std::atomic<int> spin_us { 0 };
+
+    /// True while a posted cycle has not been processed by the GUI thread
+    std::atomic<bool> gui_pending { false };
+
+    /// Time at which the last cycle was posted to the GUI thread
+    std::atomic<qint64> gui_posted_ns { 0 };
+
+    /// Time at which the GUI thread started processing the last cycle (GUI thread only)
+    qint64 gui_begin_ns { 0 };
+
+    std::atomic<quint64> cycles { 0 };
+    std::atomic<quint64> overruns { 0 };
+    std::atomic<quint64> missed_cycles { 0 };
+    std::atomic<quint64> skipped { 0 };
+    std::atomic<quint64> gui_overruns { 0 };
+
+    /// Delay between the deadline and the time the scheduler thread woke up
+    RealTimeHistogram hist_wakeup;
+
+    /// Delay between posting a cycle and the GUI thread processing it
+    RealTimeHistogram hist_dispatch;
+
+    /// Time spent by the GUI thread on each cycle
+    RealTimeHistogram hist_gui;
+};
+
+#endif // REALTIMESCHEDULER_H
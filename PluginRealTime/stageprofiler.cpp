@@ -0,0 +1,141 @@
+#include "stageprofiler.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+//------------------------------- Sliding window ------------------------------
+
+StageWindow::StageWindow(int capacity){
+    SetCapacity(capacity);
+}
+
+void StageWindow::SetCapacity(int capacity){
+    samples.fill(0, qMax(1, capacity));
+    Reset();
+}
+
+int StageWindow::Capacity() const{
+    return samples.size();
+}
+
+void StageWindow::Add(qint64 value_ns){
+    samples[next] = value_ns;
+    next = (next + 1) % samples.size();
+    if (count < samples.size()){
+        count++;
+    }
+}
+
+void StageWindow::Reset(){
+    next = 0;
+    count = 0;
+}
+
+StageWindow::Summary StageWindow::Compute() const{
+    Summary summary;
+    summary.count = count;
+    if (count == 0){
+        return summary;
+    }
+
+    // The window is not full until 'count' reaches the capacity: only the first 'count' samples are valid
+    QVector<qint64> sorted(samples.mid(0, count));
+    std::sort(sorted.begin(), sorted.end());
+
+    double sum = 0.0;
+    for (qint64 value : sorted){
+        sum += value;
+    }
+    int p99 = qMin(count - 1, static_cast<int>(std::ceil(0.99 * count)) - 1);
+    summary.min_us = sorted.first() / 1000.0;
+    summary.mean_us = sum / count / 1000.0;
+    summary.p99_us = sorted[qMax(0, p99)] / 1000.0;
+    summary.max_us = sorted.last() / 1000.0;
+    return summary;
+}
+
+
+//------------------------------- Profiler ------------------------------
+
+StageProfiler::StageProfiler(int window){
+    SetWindow(window);
+}
+
+QString StageProfiler::StageName(int stage){
+    switch (stage){
+    case StageJoints:
+        return "Joints";
+    case StageSolveFK:
+        return "SolveFK";
+    case StageUserLogic:
+        return "User logic";
+    case StageSetJoints:
+        return "setJoints";
+    case StageRender:
+        return "Render";
+    case StageCycle:
+        return "Cycle";
+    default:
+        return "Unknown";
+    }
+}
+
+void StageProfiler::SetWindow(int window){
+    for (int i = 0; i < StageCount; i++){
+        windows[i].SetCapacity(window);
+        cycle_ns[i] = 0;
+    }
+    cycle_active = false;
+}
+
+int StageProfiler::Window() const{
+    return windows[0].Capacity();
+}
+
+void StageProfiler::BeginCycle(){
+    for (int i = 0; i < StageCount; i++){
+        cycle_ns[i] = 0;
+    }
+    cycle_start = std::chrono::steady_clock::now();
+    cycle_active = true;
+}
+
+void StageProfiler::Add(Stage stage, qint64 elapsed_ns){
+    cycle_ns[stage] += elapsed_ns;
+}
+
+void StageProfiler::EndCycle(){
+    if (!cycle_active){
+        return;
+    }
+    cycle_ns[StageCycle] = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - cycle_start).count();
+    for (int i = 0; i < StageCount; i++){
+        windows[i].Add(cycle_ns[i]);
+    }
+    cycle_active = false;
+}
+
+void StageProfiler::Reset(){
+    for (int i = 0; i < StageCount; i++){
+        windows[i].Reset();
+        cycle_ns[i] = 0;
+    }
+    cycle_active = false;
+}
+
+StageWindow::Summary StageProfiler::Compute(Stage stage) const{
+    return windows[stage].Compute();
+}
+
+QString StageProfiler::ToString() const{
+    QString str = QString("Stage times per cycle (last %1 cycles, in us)\n").arg(Window());
+    str += QString("  %1 %2 %3 %4 %5\n").arg(QString("Stage"), -12).arg(QString("min"), 10).arg(QString("mean"), 10).arg(QString("p99"), 10).arg(QString("max"), 10);
+    for (int i = 0; i < StageCount; i++){
+        StageWindow::Summary summary = windows[i].Compute();
+        str += QString("  %1 %2 %3 %4 %5\n").arg(StageName(i), -12)
+                .arg(summary.min_us, 10, 'f', 1).arg(summary.mean_us, 10, 'f', 1)
+                .arg(summary.p99_us, 10, 'f', 1).arg(summary.max_us, 10, 'f', 1);
+    }
+    return str;
+}
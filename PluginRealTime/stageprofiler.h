@@ -0,0 +1,141 @@
+#ifndef STAGEPROFILER_H
+#define STAGEPROFILER_H
+
+#include <QString>
+#include <QVector>
+
+#include <chrono>
+
+
+///
+/// \brief Sliding window of duration samples (in nanoseconds) with a fixed capacity.
+/// Adding a sample never allocates memory: the oldest sample is replaced once the window is full.
+///
+class StageWindow
+{
+public:
+    /// Statistics of the samples of the window (in microseconds)
+    struct Summary
+    {
+        int count = 0;
+        double min_us = 0.0;
+        double mean_us = 0.0;
+        double p99_us = 0.0;
+        double max_us = 0.0;
+    };
+
+    explicit StageWindow(int capacity = 1000);
+
+    /// Change the number of samples of the window (removes all samples)
+    void SetCapacity(int capacity);
+
+    /// Number of samples of a full window
+    int Capacity() const;
+
+    /// Add a sample, in nanoseconds
+    void Add(qint64 value_ns);
+
+    /// Remove all samples
+    void Reset();
+
+    /// Compute the statistics of the samples in the window
+    Summary Compute() const;
+
+private:
+    QVector<qint64> samples;
+    int next = 0;
+    int count = 0;
+};
+
+
+///
+/// \brief The StageProfiler class measures the time spent in each stage of the real time cycle.
+/// Stages can be timed several times per cycle (for example, once per robot): the time of each stage is accumulated
+/// during the cycle and added to the sliding window of the stage when the cycle ends.
+/// It must be used from one thread only (the GUI thread).
+///
+class StageProfiler
+{
+public:
+    enum Stage {
+        /// Read the robot joints (IItem::Joints)
+        StageJoints = 0,
+
+        /// Forward kinematics (IItem::SolveFK)
+        StageSolveFK,
+
+        /// User logic of the cycle (logs, recording, ...)
+        StageUserLogic,
+
+        /// Update the robot joints (IItem::setJoints)
+        StageSetJoints,
+
+        /// Update the screen (IRoboDK::Render)
+        StageRender,
+
+        /// Complete cycle on the GUI thread
+        StageCycle,
+
+        StageCount
+    };
+
+    explicit StageProfiler(int window = 1000);
+
+    /// Name of a stage
+    static QString StageName(int stage);
+
+    /// Number of cycles of the sliding windows (removes all samples)
+    void SetWindow(int window);
+
+    /// Number of cycles of the sliding windows
+    int Window() const;
+
+    /// Start a new cycle
+    void BeginCycle();
+
+    /// Add the time spent in a stage during the current cycle
+    void Add(Stage stage, qint64 elapsed_ns);
+
+    /// End the current cycle: the time of each stage is added to its window
+    void EndCycle();
+
+    /// Remove all samples
+    void Reset();
+
+    /// Statistics of a stage over the sliding window
+    StageWindow::Summary Compute(Stage stage) const;
+
+    /// Table of the statistics of all stages (min, mean, p99 and max in microseconds)
+    QString ToString() const;
+
+private:
+    StageWindow windows[StageCount];
+    qint64 cycle_ns[StageCount];
+    std::chrono::steady_clock::time_point cycle_start;
+    bool cycle_active = false;
+};
+
+
+///
+/// \brief Measure the time spent in a scope and add it to a stage of the profiler when the scope ends.
+///
+class ScopedStageTimer
+{
+public:
+    ScopedStageTimer(StageProfiler *profiler, StageProfiler::Stage stage) :
+        profiler(profiler), stage(stage), start(std::chrono::steady_clock::now()) {}
+
+    ~ScopedStageTimer(){
+        profiler->Add(stage, std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+
+private:
+    StageProfiler *profiler;
+    StageProfiler::Stage stage;
+    std::chrono::steady_clock::time_point start;
+};
+
+#endif // STAGEPROFILER_H
@@ -1,6 +1,14 @@
 #include "formrobotpilot.h"
 #include "ui_formrobotpilot.h"
 
+
+// Period of the continuous jog loop (ms) and time to reach the jog speed from standstill (s)
+static const int JOG_PERIOD_MS = 20;
+static const double JOG_RAMP_TIME = 0.25;
+
+// Largest joint change accepted in one tick of a Cartesian jog (deg or mm): larger changes mean a singularity or a change of configuration
+static const double JOG_MAX_JOINT_STEP = 10.0;
+
 FormRobotPilot::FormRobotPilot(RoboDK *rdk, QWidget *parent) : QWidget(parent),
     ui(new Ui::FormRobotPilot)
 {
@@ -11,6 +19,19 @@ FormRobotPilot::FormRobotPilot(RoboDK *rdk, QWidget *parent) : QWidget(parent),
     // Create the window
     ui->setupUi(this);
 
+    // Continuous jog: in velocity mode the buttons move the robot while they are pressed
+    jog_timer.setTimerType(Qt::PreciseTimer);
+    jog_timer.setInterval(JOG_PERIOD_MS);
+    connect(&jog_timer, &QTimer::timeout, this, &FormRobotPilot::jog_tick);
+    const QList<QPushButton*> buttons_n = {ui->btnTXn, ui->btnTYn, ui->btnTZn, ui->btnRXn, ui->btnRYn, ui->btnRZn};
+    const QList<QPushButton*> buttons_p = {ui->btnTXp, ui->btnTYp, ui->btnTZp, ui->btnRXp, ui->btnRYp, ui->btnRZp};
+    for (int id = 0; id < 6; id++) {
+        connect(buttons_n[id], &QPushButton::pressed, this, [this, id]() { if (velocity_jog()) { JogStart(id, -1); } });
+        connect(buttons_p[id], &QPushButton::pressed, this, [this, id]() { if (velocity_jog()) { JogStart(id, +1); } });
+        connect(buttons_n[id], &QPushButton::released, this, &FormRobotPilot::JogStop);
+        connect(buttons_p[id], &QPushButton::released, this, &FormRobotPilot::JogStop);
+    }
+
     // important to delete the form when we close it (free memory)
     setAttribute(Qt::WA_DeleteOnClose);
 
@@ -102,19 +123,19 @@ void FormRobotPilot::on_radJoints_clicked()
     setup_btn_joints();
 }
 
-void FormRobotPilot::on_btnTXn_clicked(){ IncrementalMove(0, -1); }
-void FormRobotPilot::on_btnTYn_clicked(){ IncrementalMove(1, -1); }
-void FormRobotPilot::on_btnTZn_clicked(){ IncrementalMove(2, -1); }
-void FormRobotPilot::on_btnRXn_clicked(){ IncrementalMove(3, -1); }
-void FormRobotPilot::on_btnRYn_clicked(){ IncrementalMove(4, -1); }
-void FormRobotPilot::on_btnRZn_clicked(){ IncrementalMove(5, -1); }
+void FormRobotPilot::on_btnTXn_clicked(){ jog_clicked(0, -1); }
+void FormRobotPilot::on_btnTYn_clicked(){ jog_clicked(1, -1); }
+void FormRobotPilot::on_btnTZn_clicked(){ jog_clicked(2, -1); }
+void FormRobotPilot::on_btnRXn_clicked(){ jog_clicked(3, -1); }
+void FormRobotPilot::on_btnRYn_clicked(){ jog_clicked(4, -1); }
+void FormRobotPilot::on_btnRZn_clicked(){ jog_clicked(5, -1); }
 
-void FormRobotPilot::on_btnTXp_clicked(){ IncrementalMove(0, +1); }
-void FormRobotPilot::on_btnTYp_clicked(){ IncrementalMove(1, +1); }
-void FormRobotPilot::on_btnTZp_clicked(){ IncrementalMove(2, +1); }
-void FormRobotPilot::on_btnRXp_clicked(){ IncrementalMove(3, +1); }
-void FormRobotPilot::on_btnRYp_clicked(){ IncrementalMove(4, +1); }
-void FormRobotPilot::on_btnRZp_clicked(){ IncrementalMove(5, +1); }
+void FormRobotPilot::on_btnTXp_clicked(){ jog_clicked(0, +1); }
+void FormRobotPilot::on_btnTYp_clicked(){ jog_clicked(1, +1); }
+void FormRobotPilot::on_btnTZp_clicked(){ jog_clicked(2, +1); }
+void FormRobotPilot::on_btnRXp_clicked(){ jog_clicked(3, +1); }
+void FormRobotPilot::on_btnRYp_clicked(){ jog_clicked(4, +1); }
+void FormRobotPilot::on_btnRZp_clicked(){ jog_clicked(5, +1); }
 
 
 void FormRobotPilot::IncrementalMove(int id, double sense){
@@ -147,34 +168,8 @@ void FormRobotPilot::IncrementalMove(int id, double sense){
             return;
         }
 
-        // apply to XYZWPR
-        tXYZWPR xyzwpr = {};
-        xyzwpr[id] = step;
-
-        Mat pose_increment;
-        pose_increment.FromXYZRPW(xyzwpr);
-
-        // get the current robot pose
-        Mat pose_robot = Robot->Pose();
-
-        Mat pose_robot_new;
-
-        bool is_tcp_relative_move = ui->radCartesianTool->isChecked();
-        if (is_tcp_relative_move){
-            // apply relative to the TCP:
-            // if the movement is relative to the TCP we must POST MULTIPLY the movement
-            pose_robot_new = pose_robot * pose_increment;
-        } else {
-            // it is a movement relative to the reference frame
-            // if the movement is relative to the reference frame we must PRE MULTIPLY the XYZ translation:
-            // new_robot_pose = movement_pose * robot_pose;
-            // Note: Rotation applies from the robot axes.
-
-            Mat transformation_axes(pose_robot);
-            transformation_axes.setPos(0, 0, 0);
-            Mat movement_pose_aligned = transformation_axes.inv() * pose_increment * transformation_axes;
-            pose_robot_new = pose_robot * movement_pose_aligned;
-        }
+        // get the current robot pose and apply the step
+        Mat pose_robot_new = pose_step(Robot->Pose(), id, step, ui->radCartesianTool->isChecked());
 
 
         bool canmove = false;
@@ -192,8 +187,146 @@ void FormRobotPilot::IncrementalMove(int id, double sense){
     RDK->Render();
 }
 
+Mat FormRobotPilot::pose_step(const Mat &pose, int id, double step, bool tcp_relative) const {
+    // apply to XYZWPR
+    tXYZWPR xyzwpr = {};
+    xyzwpr[id] = step;
+
+    Mat pose_increment;
+    pose_increment.FromXYZRPW(xyzwpr);
+
+    if (tcp_relative){
+        // apply relative to the TCP:
+        // if the movement is relative to the TCP we must POST MULTIPLY the movement
+        return pose * pose_increment;
+    }
+
+    // it is a movement relative to the reference frame
+    // if the movement is relative to the reference frame we must PRE MULTIPLY the XYZ translation:
+    // new_robot_pose = movement_pose * robot_pose;
+    // Note: Rotation applies from the robot axes.
+    Mat transformation_axes(pose);
+    transformation_axes.setPos(0, 0, 0);
+    Mat movement_pose_aligned = transformation_axes.inv() * pose_increment * transformation_axes;
+    return pose * movement_pose_aligned;
+}
+
+bool FormRobotPilot::velocity_jog() const {
+    // Jogging continuously is only simulated: with a real robot each click is an incremental move
+    return ui->chkVelocityJog->isChecked() && !ui->chkRunOnRobot->isChecked();
+}
+
+void FormRobotPilot::jog_clicked(int id, double sense){
+    // In velocity mode the robot already moved while the button was pressed
+    if (velocity_jog()){
+        return;
+    }
+    IncrementalMove(id, sense);
+}
+
+void FormRobotPilot::JogStart(int id, double sense){
+    if (!SelectRobot(false)){
+        return;
+    }
+
+    const bool joint_move = ui->radJoints->isChecked();
+    const bool tcp_relative = ui->radCartesianTool->isChecked();
+    if (id < 0 || id >= 6){
+        qDebug() << "Internal problem: Invalid id provided for a jog move";
+        return;
+    }
+
+    // Keep the current speed if the same axis is still decelerating, otherwise start from standstill
+    const bool resume = jog_timer.isActive() && id == jog_id && joint_move == jog_joint_move && tcp_relative == jog_tcp_relative;
+    if (!resume){
+        jog_timer.stop();
+        jog_speed = 0.0;
+        jog_joints = Robot->Joints();
+        if (!jog_joints.Valid()){
+            RDK->ShowMessage(tr("Invalid robot joints or unable retrieve joints from connected robot"), false);
+            return;
+        }
+        if (joint_move && id >= jog_joints.Length()){
+            qDebug() << "Internal problem: Invalid joint ID";
+            return;
+        }
+        Robot->JointLimits(&jog_lower, &jog_upper);
+        jog_pose = Robot->Pose();
+        jog_tool = Robot->PoseTool();
+        jog_frame = Robot->PoseFrame();
+    }
+
+    jog_id = id;
+    jog_sense = sense;
+    jog_joint_move = joint_move;
+    jog_tcp_relative = tcp_relative;
+    if (!jog_timer.isActive()){
+        jog_clock.start();
+        jog_timer.start();
+    }
+}
+
+void FormRobotPilot::JogStop(){
+    // jog_tick decelerates to standstill and stops the timer
+    jog_sense = 0.0;
+}
 
+void FormRobotPilot::jog_tick(){
+    if (!RDK->Valid(Robot)){
+        jog_timer.stop();
+        jog_speed = 0.0;
+        return;
+    }
+
+    // Accelerate (or decelerate) towards the requested speed
+    const double dt = qMin(0.001 * jog_clock.restart(), 0.1);
+    const double speed = ui->spnStep->value();
+    const double max_change = speed / JOG_RAMP_TIME * dt;
+    jog_speed += qBound(-max_change, jog_sense * speed - jog_speed, max_change);
+    if (jog_sense == 0.0 && jog_speed == 0.0){
+        jog_timer.stop();
+        return;
+    }
+    const double step = jog_speed * dt;
+
+    tJoints joints_new;
+    if (jog_joint_move){
+        joints_new = jog_joints;
+        double value = joints_new.Data()[jog_id] + step;
+        if (jog_id < jog_lower.Length() && jog_id < jog_upper.Length()){
+            const double lower = jog_lower.ValuesD()[jog_id];
+            const double upper = jog_upper.ValuesD()[jog_id];
+            if (value < lower || value > upper){
+                // stop at the joint limit
+                value = qBound(lower, value, upper);
+                jog_sense = 0.0;
+                jog_speed = 0.0;
+            }
+        }
+        joints_new.Data()[jog_id] = value;
+    } else {
+        // Solve the inverse kinematics from the joints of the previous tick (the closest solution keeps the configuration)
+        Mat pose_new = pose_step(jog_pose, jog_id, step, jog_tcp_relative);
+        joints_new = Robot->SolveIK(pose_new, &jog_joints, &jog_tool, &jog_frame);
+        bool reachable = joints_new.Length() > 0 && joints_new.Length() >= jog_joints.Length();
+        for (int i = 0; reachable && i < jog_joints.Length(); i++){
+            reachable = qAbs(joints_new.ValuesD()[i] - jog_joints.ValuesD()[i]) <= JOG_MAX_JOINT_STEP;
+        }
+        if (!reachable){
+            jog_timer.stop();
+            jog_sense = 0.0;
+            jog_speed = 0.0;
+            RDK->ShowMessage(tr("The robot can't move to this location"), false);
+            return;
+        }
+        jog_pose = pose_new;
+    }
+    jog_joints = joints_new;
+    Robot->setJoints(jog_joints);
 
+    // A single render per tick updates the robot and the display
+    RDK->Render();
+}
 
 void FormRobotPilot::on_chkRunOnRobot_clicked(bool checked){
     if (checked) {
@@ -2,6 +2,8 @@
 #define FORMROBOTPILOT_H
 
 #include <QWidget>
+#include <QTimer>
+#include <QElapsedTimer>
 #include "irobodk.h"
 #include "iitem.h"
 
@@ -30,6 +32,14 @@ public:
     /// \param sense +1 (positive motion) or -1 (negative motion)
     void IncrementalMove(int id, double sense);
 
+    /// \brief Start jogging continuously (velocity mode): the robot accelerates up to the speed set in the step box (mm/s or deg/s) until JogStop() is called
+    /// \param id Joint id or cartesian move id [x,y,z,r,p,w]
+    /// \param sense +1 (positive motion) or -1 (negative motion)
+    void JogStart(int id, double sense);
+
+    /// \brief Decelerate and stop the continuous jog
+    void JogStop();
+
 private:
 
     /// Set the jog button text as joint movements
@@ -38,6 +48,18 @@ private:
     /// Set the jog button text as Cartesian movement
     void setup_btn_cartesian();
 
+    /// Pose moved by a step along a Cartesian axis [x,y,z,r,p,w], relative to the TCP or to the reference frame
+    Mat pose_step(const Mat &pose, int id, double step, bool tcp_relative) const;
+
+    /// Returns true if the jog buttons move the robot while they are pressed (velocity mode)
+    bool velocity_jog() const;
+
+    /// Click on a jog button: incremental move, unless the robot is jogged in velocity mode
+    void jog_clicked(int id, double sense);
+
+    /// Integrate the jog speed and move the robot (called at a fixed rate while jogging)
+    void jog_tick();
+
 private slots:
 
     /// \brief Select a robot (useful if you have more than one robot in your station)
@@ -73,6 +95,25 @@ private:
     /// \brief Pointer to the robot that we are piloting.
     Item Robot;
 
+    /// \brief Timer of the continuous jog loop and time of the last tick.
+    QTimer jog_timer;
+    QElapsedTimer jog_clock;
+
+    /// \brief Joint id or Cartesian axis jogged, requested sense (0 while stopping) and current speed (mm/s or deg/s).
+    int jog_id = -1;
+    double jog_sense = 0.0;
+    double jog_speed = 0.0;
+    bool jog_joint_move = false;
+    bool jog_tcp_relative = false;
+
+    /// \brief State integrated by the jog loop: the joints (which warm start the inverse kinematics) and the TCP pose with respect to the reference.
+    tJoints jog_joints;
+    Mat jog_pose;
+    Mat jog_tool;
+    Mat jog_frame;
+    tJoints jog_lower;
+    tJoints jog_upper;
+
 };
 
 #endif // FORMROBOTPILOT_H
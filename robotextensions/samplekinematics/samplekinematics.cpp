@@ -35,6 +35,13 @@
 
 #include <iostream>
 
+// Define SAMPLEKINEMATICS_QUIET to remove the console output of each call (for example, to benchmark these functions)
+#ifdef SAMPLEKINEMATICS_QUIET
+#define SAMPLE_LOG(msg)
+#else
+#define SAMPLE_LOG(msg) std::cout << msg << std::endl
+#endif
+
 
 // You must remove the line "CONFIG -= qt" from the .pro file if you want to use Qt features like QDebug
 // #include <QDebug>
@@ -247,7 +254,7 @@ void Pose_Inv(const real_T in[16], real_T out[16]){
 int SolveFK(const real_T *joints, real_T pose[16], const robot_T *ptr_robot) {
     // return -1; // Return -1 to use RoboDK default, return 1 for success, return 0 for target out of reach
 
-    std::cout << "Using custom SolveFK" << std::endl;
+    SAMPLE_LOG("Using custom SolveFK");
 
     // Below is RoboDK's default calculation:
 
@@ -323,7 +330,7 @@ int SolveFK(const real_T *joints, real_T pose[16], const robot_T *ptr_robot) {
 int SolveFK_CAD(const real_T *joints, real_T pose[16], real_T *joint_poses, int max_poses, const robot_T *ptr_robot) {
     //return -1; // Return -1 to use RoboDK default, return 0 for success
 
-    std::cout << "Using custom SolveFK_CAD" << std::endl;
+    SAMPLE_LOG("Using custom SolveFK_CAD");
 
     // Below is RoboDK's default calculation:
 
@@ -332,7 +339,7 @@ int SolveFK_CAD(const real_T *joints, real_T pose[16], real_T *joint_poses, int
     if (max_poses < nDOFs + 1){
         // RoboDK Must provide with a buffer large enough for all joints (at least nDOFs + 1)
         // If not, something went wrong, we could write past an allowed buffer
-        std::cout << "Something went wrong with SolveFK_CAD" << std::endl;
+        SAMPLE_LOG("Something went wrong with SolveFK_CAD");
         return -1;
     }
 
@@ -385,7 +392,7 @@ int SolveFK_CAD(const real_T *joints, real_T pose[16], real_T *joint_poses, int
 }
 
 int SolveIK(const real_T pose[16], real_T *joints, real_T *joints_all, int max_solutions, const real_T *joints_approx, const robot_T *ptr_robot) {
-    std::cout << "Using custom SolveIK..." << std::endl;
+    SAMPLE_LOG("Using custom SolveIK...");
     // return -1; // Use RoboDK's default inverse kinematics for generic mechanisms (iterative solution)
     
     // Retrieve the number of axes (degrees of freedom)
@@ -412,7 +419,7 @@ int SolveIK(const real_T pose[16], real_T *joints, real_T *joints_all, int max_s
         solution_1[i] = i*10;
         solution_2[i] = -i*10;
     }
-    std::cout << "Done with SolveIK. Solutions: " << n_solutions << std::endl;
+    SAMPLE_LOG("Done with SolveIK. Solutions: " << n_solutions);
     return n_solutions;
 
     // Logic: Calculate inverse kinematics
@@ -421,7 +428,7 @@ int SolveIK(const real_T pose[16], real_T *joints, real_T *joints_all, int max_s
 }
 
 int Joints2Config(const real_T *joints, real_T config[3], const robot_T *ptr_robot){
-    std::cout << "Using custom Joints2Config..." << std::endl;
+    SAMPLE_LOG("Using custom Joints2Config...");
     //return -1; // use default values
 
     config[0] = 0.0; // 0=front, 1=rear